@@ -12,6 +12,7 @@ void run(int argc, char **argv) {
     vector<string> defaults{
         "expanded", // {expanded, expanded_full, classical}
         "7",        // number of runs
+        "3291387",  // number of triangles (quarter ring)
     };
     auto args = extract_arguments_or_use_defaults(argc, argv, defaults);
 
@@ -39,14 +40,10 @@ void run(int argc, char **argv) {
     // number of runs
     size_t number_of_runs = std::atoi(args[1].c_str());
 
-    // load the mesh
-    // auto pps = string("1800"); // points
-    // auto ccs = string("3387"); // cells
-    auto pps = string("1648167"); // points
-    auto ccs = string("3291387"); // cells
-    auto home = string(std::getenv("HOME"));
-    auto fn_mesh = home + string("/Downloads/meshes/quarter_ring2d_" + pps + "points_" + ccs + "cells.msh");
-    auto mesh = read_mesh(fn_mesh);
+    // generate the mesh (quarter ring with a = 3 and b = 6)
+    size_t nr, nt;
+    quarter_ring_divisions(nr, nt, 3.0, 6.0, std::atoll(args[2].c_str()));
+    auto mesh = generate_quarter_ring(3.0, 6.0, nr, nt);
 
     // parameters
     auto ncell = mesh->connectivity.size() / 3;
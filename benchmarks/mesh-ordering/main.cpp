@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+
+#include "../../src/libfem2d.h"
+#include "laclib.h"
+
+using namespace std;
+
+/// @brief Returns the elapsed time in seconds since t0
+inline double seconds_since(const chrono::steady_clock::time_point &t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+/// @brief Returns the mean distance between the smallest node numbers of consecutive elements
+/// @note This is a proxy for the locality of the memory accesses during the assembly
+inline double mean_node_jump(const vector<size_t> &connectivity, size_t element_num_node) {
+    size_t ncell = connectivity.size() / element_num_node;
+    double sum = 0.0;
+    size_t previous = 0;
+    for (size_t e = 0; e < ncell; e++) {
+        size_t first = connectivity[e * element_num_node];
+        for (size_t k = 1; k < element_num_node; k++) {
+            first = std::min(first, connectivity[e * element_num_node + k]);
+        }
+        if (e > 0) {
+            sum += static_cast<double>(first > previous ? first - previous : previous - first);
+        }
+        previous = first;
+    }
+    return ncell > 1 ? sum / static_cast<double>(ncell - 1) : 0.0;
+}
+
+void run(int argc, char **argv) {
+    // get arguments from command line
+    vector<string> defaults{
+        "rcm",     // node renumbering {none, rcm, nd}
+        "hilbert", // element ordering {none, morton, hilbert}
+        "5",       // number of runs
+        "3291387", // number of triangles (quarter ring)
+        "1",       // seed of the random node and element numbering
+    };
+    auto args = extract_arguments_or_use_defaults(argc, argv, defaults);
+
+    // node renumbering method
+    auto method = RENUMBERING_NONE;
+    if (args[0] == "rcm") {
+        method = RENUMBERING_RCM;
+    } else if (args[0] == "nd") {
+        method = RENUMBERING_NESTED_DISSECTION;
+    } else if (args[0] != "none") {
+        throw "node renumbering must be one of {none, rcm, nd}";
+    }
+
+    // element ordering method
+    auto ordering_method = ELEMENT_ORDERING_NONE;
+    if (args[1] == "morton") {
+        ordering_method = ELEMENT_ORDERING_MORTON;
+    } else if (args[1] == "hilbert") {
+        ordering_method = ELEMENT_ORDERING_HILBERT;
+    } else if (args[1] != "none") {
+        throw "element ordering must be one of {none, morton, hilbert}";
+    }
+
+    // number of runs
+    size_t number_of_runs = std::atoi(args[2].c_str());
+
+    // generate the mesh (quarter ring with a = 3 and b = 6)
+    size_t nr, nt;
+    quarter_ring_divisions(nr, nt, 3.0, 6.0, std::atoll(args[3].c_str()));
+    auto mesh = generate_quarter_ring(3.0, 6.0, nr, nt);
+
+    // shuffle the node and element numbering (the generator numbers the nodes row by row, i.e., already banded)
+    auto npoint = mesh->coordinates.size() / 2;
+    auto ncell = mesh->connectivity.size() / 3;
+    mt19937_64 generator(std::atoll(args[4].c_str()));
+    vector<size_t> new_node(npoint), old_element(ncell);
+    std::iota(new_node.begin(), new_node.end(), 0);
+    std::iota(old_element.begin(), old_element.end(), 0);
+    std::shuffle(new_node.begin(), new_node.end(), generator);
+    std::shuffle(old_element.begin(), old_element.end(), generator);
+    auto shuffled_coordinates = vector<double>(npoint * 2);
+    for (size_t p = 0; p < npoint; p++) {
+        shuffled_coordinates[new_node[p] * 2] = mesh->coordinates[p * 2];
+        shuffled_coordinates[new_node[p] * 2 + 1] = mesh->coordinates[p * 2 + 1];
+    }
+    auto shuffled_connectivity = vector<size_t>(ncell * 3);
+    for (size_t e = 0; e < ncell; e++) {
+        for (size_t k = 0; k < 3; k++) {
+            shuffled_connectivity[e * 3 + k] = new_node[mesh->connectivity[old_element[e] * 3 + k]];
+        }
+    }
+    mesh->coordinates = std::move(shuffled_coordinates);
+    mesh->connectivity = std::move(shuffled_connectivity);
+
+    // parameters
+    auto param_young = vector<double>(ncell, 1000.0);
+    auto param_poisson = vector<double>(ncell, 0.25);
+    auto param_cross_area = vector<double>{};
+
+    // essential boundary conditions (symmetry)
+    map<node_dof_pair_t, double> essential_bcs{};
+    for (size_t p = 0; p < npoint; p++) {
+        if (fabs(mesh->coordinates[p * 2]) < 1e-11) {
+            essential_bcs[{p, AlongX}] = 0.0;
+        }
+        if (fabs(mesh->coordinates[p * 2 + 1]) < 1e-11) {
+            essential_bcs[{p, AlongY}] = 0.0;
+        }
+    }
+    map<node_dof_pair_t, double> natural_bcs{};
+
+    // renumber the nodes
+    auto t0 = chrono::steady_clock::now();
+    auto renumbering = NodeRenumbering::make_new(method, mesh->coordinates, mesh->connectivity, 3);
+    auto coordinates = renumbering->to_new_coordinates(mesh->coordinates);
+    auto connectivity = renumbering->to_new_connectivity(mesh->connectivity);
+    auto renumbered_essential_bcs = renumbering->to_new_bcs(essential_bcs);
+    double renumbering_seconds = seconds_since(t0);
+
+    // reorder the elements (after the node renumbering)
+    t0 = chrono::steady_clock::now();
+    auto ordering = ElementOrdering::make_new(ordering_method, coordinates, connectivity, 3);
+    connectivity = ordering->to_new_connectivity(connectivity);
+    param_young = ordering->to_new_element_values(param_young);
+    param_poisson = ordering->to_new_element_values(param_poisson);
+    double ordering_seconds = seconds_since(t0);
+
+    // allocate fem
+    auto fem = Fem2d::make_new(true, false, 1.0, true, false,
+                               coordinates,
+                               connectivity,
+                               param_young,
+                               param_poisson,
+                               param_cross_area,
+                               renumbered_essential_bcs,
+                               natural_bcs);
+
+    // assembly (COO) and conversion to CSR
+    t0 = chrono::steady_clock::now();
+    for (size_t run = 0; run < number_of_runs; run++) {
+        fem->calculate_rhs_and_global_stiffness();
+    }
+    double assembly_seconds = seconds_since(t0) / number_of_runs;
+
+    // assembly of the upper triangle (CSR) and sparse matrix-vector product
+    t0 = chrono::steady_clock::now();
+    for (size_t run = 0; run < number_of_runs; run++) {
+        fem->kk_upper = CsrUpper::make_from_fem(*fem);
+    }
+    double assembly_upper_seconds = seconds_since(t0) / number_of_runs;
+    auto x = vector<double>(fem->total_ndof, 1.0);
+    auto y = vector<double>(fem->total_ndof, 0.0);
+    t0 = chrono::steady_clock::now();
+    for (size_t run = 0; run < 10 * number_of_runs; run++) {
+        fem->kk_upper->multiply(y, x);
+    }
+    double spmv_seconds = seconds_since(t0) / (10 * number_of_runs);
+
+    printf("node renumbering        : %s (%.3fs)\n", args[0].c_str(), renumbering_seconds);
+    printf("element ordering        : %s (%.3fs)\n", args[1].c_str(), ordering_seconds);
+    printf("node bandwidth          : %zu (before) → %zu (after)\n",
+           renumbering->bandwidth_before, renumbering->bandwidth_after);
+    printf("mean node jump          : %.1f\n", mean_node_jump(connectivity, 3));
+    printf("DOF bandwidth (kk_upper): %zu\n", fem->kk_upper->bandwidth());
+    printf("assembly (COO → CSR)    : %.6fs\n", assembly_seconds);
+    printf("assembly (CsrUpper)     : %.6fs\n", assembly_upper_seconds);
+    printf("matrix-vector product   : %.6fs\n", spmv_seconds);
+}
+
+MAIN_FUNCTION(run)
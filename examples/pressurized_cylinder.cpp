@@ -8,12 +8,10 @@
 using namespace std;
 
 void run(int argc, char **argv) {
-    // load the mesh
-    auto pps = string("1800"); // points
-    auto ccs = string("3387"); // cells
-    auto home = string(std::getenv("HOME"));
-    auto fn_mesh = home + string("/Downloads/meshes/quarter_ring2d_" + pps + "points_" + ccs + "cells.msh");
-    auto mesh = read_mesh(fn_mesh);
+    // generate the mesh (quarter ring with a = 3 and b = 6; about 3400 triangles)
+    size_t nr, nt;
+    quarter_ring_divisions(nr, nt, 3.0, 6.0, 3400);
+    auto mesh = generate_quarter_ring(3.0, 6.0, nr, nt);
 
     // parameters
     auto ncell = mesh->connectivity.size() / 3;
@@ -21,31 +19,60 @@ void run(int argc, char **argv) {
     auto param_poisson = vector<double>(ncell, 0.25);
     auto param_cross_area = vector<double>{};
 
-    // essential boundary conditions
-    auto npoint = mesh->coordinates.size() / 2;
-    map<node_dof_pair_t, double> essential_bcs{};
-    for (size_t p = 0; p < npoint; p++) {
+    // options
+    auto solid_triangle = true;
+    auto plane_stress = false;
+    auto thickness = 1.0;
+    auto use_expanded_bdb = true;
+    auto use_expanded_bdb_full = false;
+
+    // allocate fem
+    auto fem = Fem2d::make_new(solid_triangle,
+                               plane_stress,
+                               thickness,
+                               use_expanded_bdb,
+                               use_expanded_bdb_full,
+                               mesh->coordinates,
+                               mesh->connectivity,
+                               param_young,
+                               param_poisson,
+                               param_cross_area,
+                               map<node_dof_pair_t, double>{},
+                               map<node_dof_pair_t, double>{});
+
+    // essential boundary conditions (written directly into the dense arrays)
+    auto index = SpatialIndex::make_new(mesh->coordinates);
+    auto left = index->nodes_on_segment(0.0, 0.0, 0.0, 10.0, 1e-11);
+    auto bottom = index->nodes_on_segment(0.0, 0.0, 10.0, 0.0, 1e-11);
+    fem->set_essential_bcs(left, AlongX, 0.0);   // fix left edge horizontally
+    fem->set_essential_bcs(bottom, AlongY, 0.0); // fix bottom edge vertically
+
+    // internal pressure on the inner edges (r = a)
+    auto a = 3.0;
+    auto b = 6.0;
+    auto pressure = 1.0;
+    auto boundary = BoundaryEdges::make_new(mesh->coordinates, mesh->connectivity, mesh->get_topology());
+    auto inner = boundary->select(mesh->coordinates, [&](double x, double y) { return fabs(hypot(x, y) - a) < 1e-6; });
+    inner->add_pressure_loads(fem->natural_boundary_conditions, mesh->coordinates, pressure, thickness);
+
+    // solve
+    fem->solve();
+
+    // compare the radial displacement with the analytical solution (plane-strain)
+    auto young = param_young[0];
+    auto poisson = param_poisson[0];
+    auto max_error = 0.0;
+    for (auto p : boundary->unique_nodes()) {
         auto x = mesh->coordinates[p * 2];
         auto y = mesh->coordinates[p * 2 + 1];
-        if (fabs(x) < 1e-11) {
-            // fix left edge horizontally
-            essential_bcs[{p, AlongX}] = 0.0;
-        }
-        if (fabs(y) < 1e-11) {
-            // fix bottom edge vertically
-            essential_bcs[{p, AlongY}] = 0.0;
-        }
+        auto r = hypot(x, y);
+        auto ur_fem = (fem->uu[p * 2] * x + fem->uu[p * 2 + 1] * y) / r;
+        auto ur_ana = (1.0 + poisson) * pressure * a * a / (young * (b * b - a * a)) *
+                      ((1.0 - 2.0 * poisson) * r + b * b / r);
+        max_error = fmax(max_error, fabs(ur_fem - ur_ana) / fabs(ur_ana));
     }
-
-    // natural boundary conditions
-    // TODO
-
-    // options
-    // auto solid_triangle = true;
-    // auto plane_stress = false;
-    // auto thickness = 1.0;
-    // auto use_expanded_bdb = true;
-    // auto use_expanded_bdb_full = false;
+    cout << "number of inner edges = " << inner->size() << endl;
+    cout << "max relative error of the radial displacement on the boundary = " << max_error << endl;
 }
 
 MAIN_FUNCTION(run)
\ No newline at end of file
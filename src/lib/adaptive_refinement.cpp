@@ -0,0 +1,51 @@
+#include "adaptive_refinement.h"
+#include "refinement.h"
+
+std::unique_ptr<AdaptiveRefinement> AdaptiveRefinement::make_new(std::unique_ptr<CoordinatesAndConnectivity> mesh,
+                                                                  const fem_factory_t &factory,
+                                                                  const AdaptiveOptions &options) {
+    if (mesh->element_num_node != 3) {
+        throw "AdaptiveRefinement works with tri3 only";
+    }
+    auto adaptive = std::unique_ptr<AdaptiveRefinement>{new AdaptiveRefinement{
+        std::move(mesh),
+        NULL, // fem
+        NULL, // results
+        NULL, // estimate
+        std::vector<AdaptiveCycle>{},
+        false, // converged
+    }};
+    for (size_t cycle = 0;; cycle++) {
+        auto &current = *adaptive->mesh;
+        adaptive->fem = factory(current);
+        adaptive->fem->solve();
+        adaptive->results = ElementResults::make_new(*adaptive->fem);
+        auto nodal = NodalStresses::make_new(options.recovery_method,
+                                             current.coordinates,
+                                             current.connectivity,
+                                             current.get_topology(),
+                                             *adaptive->results);
+        adaptive->estimate = ErrorEstimate::make_new(*adaptive->fem, *adaptive->results, *nodal);
+        size_t ncell = current.connectivity.size() / 3;
+        adaptive->history.push_back(AdaptiveCycle{
+            current.coordinates.size() / 2,
+            ncell,
+            adaptive->estimate->relative_error,
+        });
+
+        if (adaptive->estimate->relative_error <= options.target_relative_error) {
+            adaptive->converged = true;
+            break;
+        }
+        if (cycle >= options.max_cycles || ncell >= options.max_elements) {
+            break;
+        }
+        auto marked = adaptive->estimate->mark(options.marking_fraction);
+        auto refined = refine_marked(current, marked);
+        if (refined->connectivity.size() == current.connectivity.size()) {
+            break;
+        }
+        adaptive->mesh = std::move(refined);
+    }
+    return adaptive;
+}
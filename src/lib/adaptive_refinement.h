@@ -0,0 +1,93 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "element_results.h"
+#include "error_estimator.h"
+#include "fem2d.h"
+#include "nodal_recovery.h"
+#include "read_mesh.h"
+
+/// @brief Defines a function allocating the FEM problem (materials, boundary conditions and loads) on a mesh
+///
+/// The function is called once for every new mesh; it may use mesh.attributes and mesh.get_topology()
+/// to find the boundary conditions (e.g., with SpatialIndex and BoundaryEdges).
+typedef std::function<std::unique_ptr<Fem2d>(CoordinatesAndConnectivity &mesh)> fem_factory_t;
+
+/// @brief Holds the options of the adaptive refinement
+struct AdaptiveOptions {
+    /// @brief Target relative error in the energy norm (see ErrorEstimate::relative_error)
+    double target_relative_error;
+
+    /// @brief Dörfler fraction θ of the squared error held by the marked elements
+    double marking_fraction;
+
+    /// @brief Maximum number of refinements
+    size_t max_cycles;
+
+    /// @brief The refinement stops when the mesh has at least this number of elements
+    size_t max_elements;
+
+    /// @brief Method to recover the nodal stresses used by the error estimator
+    NodalRecoveryMethod recovery_method;
+
+    /// @brief Allocates a new AdaptiveOptions structure with default values
+    inline static std::unique_ptr<AdaptiveOptions> make_new() {
+        return std::unique_ptr<AdaptiveOptions>{new AdaptiveOptions{
+            0.05,               // target_relative_error
+            0.5,                // marking_fraction
+            20,                 // max_cycles
+            10000000,           // max_elements
+            NODAL_RECOVERY_SPR, // recovery_method
+        }};
+    }
+};
+
+/// @brief Holds the summary of one solve-estimate cycle
+struct AdaptiveCycle {
+    /// @brief Number of nodes of the mesh
+    size_t number_of_nodes;
+
+    /// @brief Number of elements of the mesh
+    size_t number_of_elements;
+
+    /// @brief Estimated relative error of the solution
+    double relative_error;
+};
+
+/// @brief Implements the adaptive loop solve → estimate → mark → refine for meshes of triangles
+///
+/// Each cycle solves the problem given by the factory, recovers the nodal stresses, estimates the error
+/// (ErrorEstimate), marks the elements (Dörfler), and refines them (refine_marked). The problem is solved
+/// once per mesh; the loop stops without solving again when the target error is reached, the number of
+/// cycles or elements is exceeded, or nothing is marked. New nodes on the boundary lie on the chords of
+/// the coarse edges.
+struct AdaptiveRefinement {
+    /// @brief The final mesh
+    std::unique_ptr<CoordinatesAndConnectivity> mesh;
+
+    /// @brief The (solved) problem on the final mesh
+    std::unique_ptr<Fem2d> fem;
+
+    /// @brief The element stresses on the final mesh
+    std::unique_ptr<ElementResults> results;
+
+    /// @brief The error estimate on the final mesh
+    std::unique_ptr<ErrorEstimate> estimate;
+
+    /// @brief The summary of each cycle (the last one corresponds to the final mesh)
+    std::vector<AdaptiveCycle> history;
+
+    /// @brief Indicates that the target relative error has been reached
+    bool converged;
+
+    /// @brief Runs the adaptive loop
+    /// @param mesh The initial mesh of triangles
+    /// @param factory Allocates the FEM problem on each mesh
+    /// @param options The options
+    static std::unique_ptr<AdaptiveRefinement> make_new(std::unique_ptr<CoordinatesAndConnectivity> mesh,
+                                                        const fem_factory_t &factory,
+                                                        const AdaptiveOptions &options);
+};
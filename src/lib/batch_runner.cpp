@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <omp.h>
+
+#include "batch_runner.h"
+#include "mkl.h"
+
+std::unique_ptr<Fem2d> BatchModel::allocate() const {
+    size_t nnode = solid_triangle ? 3 : 2;
+    size_t npoint = coordinates.size() / 2;
+    if (coordinates.size() != 2 * npoint || connectivity.size() % nnode != 0) {
+        throw "BatchModel requires two coordinates per node and (2 or 3) nodes per element";
+    }
+    size_t ncell = connectivity.size() / nnode;
+    for (auto node : connectivity) {
+        if (node >= npoint) {
+            throw "BatchModel connectivity has a node number out of range";
+        }
+    }
+    if (param_young.size() != ncell) {
+        throw "BatchModel requires one Young's modulus per element";
+    }
+    if (solid_triangle && param_poisson.size() != ncell) {
+        throw "BatchModel requires one Poisson coefficient per triangle";
+    }
+    if (!solid_triangle && param_cross_area.size() != ncell) {
+        throw "BatchModel requires one cross-sectional area per rod";
+    }
+    for (const auto &bcs : {&essential_bcs, &natural_bcs}) {
+        for (const auto &[key, value] : *bcs) {
+            const auto [node, dof] = key;
+            if (node >= npoint || (dof != AlongX && dof != AlongY)) {
+                throw "BatchModel has a boundary condition out of range";
+            }
+        }
+    }
+    return Fem2d::make_new(solid_triangle,
+                           plane_stress,
+                           thickness,
+                           solid_triangle, // use_expanded_bdb
+                           false,          // use_expanded_bdb_full
+                           coordinates,
+                           connectivity,
+                           param_young,
+                           param_poisson,
+                           param_cross_area,
+                           essential_bcs,
+                           natural_bcs);
+}
+
+std::vector<BatchResult> solve_batch(const std::vector<BatchModel> &models, const BatchOptions &options) {
+    size_t nmodel = models.size();
+    std::vector<BatchResult> results(nmodel, BatchResult{false, "", {}, {}, {0.0, 0.0, 0.0, 0.0}, 0.0});
+
+    // largest models first
+    std::vector<size_t> order(nmodel);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return models[a].coordinates.size() > models[b].coordinates.size();
+    });
+
+    auto solver_options = LinearSolverOptions::make_new();
+    solver_options->pardiso.num_threads = 1;
+    int num_threads = options.number_of_threads > 0 ? static_cast<int>(options.number_of_threads)
+                                                    : omp_get_max_threads();
+
+#pragma omp parallel num_threads(num_threads)
+    {
+        int previous_num_threads = mkl_set_num_threads_local(1);
+#pragma omp for schedule(dynamic, 1)
+        for (size_t i = 0; i < nmodel; i++) {
+            auto &result = results[order[i]];
+            auto start = std::chrono::steady_clock::now();
+            try {
+                auto fem = models[order[i]].allocate();
+                fem->set_linear_solver(options.solver_kind, *solver_options);
+                fem->solve();
+                if (options.with_reactions) {
+                    fem->calculate_reactions(result.reactions);
+                    result.equilibrium = fem->check_equilibrium(result.reactions);
+                }
+                result.uu = std::move(fem->uu);
+                result.success = true;
+            } catch (const char *message) {
+                result.error = message;
+            } catch (...) {
+                result.error = "unknown exception (e.g., out of memory) while solving the model";
+            }
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        mkl_set_num_threads_local(previous_num_threads);
+    }
+    return results;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fem2d.h"
+#include "linear_solver.h"
+
+/// @brief Holds the description of an independent model solved by solve_batch (see Fem2d::make_new)
+struct BatchModel {
+    /// @brief Plane-stress or plane-strain analysis with triangles instead of rods
+    bool solid_triangle;
+
+    /// @brief If solid_triangle, simulate plane-stress instead of plane-strain
+    bool plane_stress;
+
+    /// @brief Out-of-plane thickness if solid_triangle and plane-stress
+    double thickness;
+
+    /// @brief x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    std::vector<double> coordinates;
+
+    /// @brief 0 1 (2)  0 2 (3)  1 2 (4)  (size = (2 or 3) * number_of_elements)
+    std::vector<size_t> connectivity;
+
+    /// @brief All Young's modulus (size = number_of_elements)
+    std::vector<double> param_young;
+
+    /// @brief All Poisson coefficients (solid_triangle only) (size = number_of_elements)
+    std::vector<double> param_poisson;
+
+    /// @brief All cross-sectional areas (rod element only) (size = number_of_elements)
+    std::vector<double> param_cross_area;
+
+    /// @brief Prescribed boundary conditions: maps (node_number, dof_number) => value
+    std::map<node_dof_pair_t, double> essential_bcs;
+
+    /// @brief Natural boundary conditions: maps (node_number, dof_number) => value
+    std::map<node_dof_pair_t, double> natural_bcs;
+
+    /// @brief Validates the description and allocates the FEM problem
+    std::unique_ptr<Fem2d> allocate() const;
+};
+
+/// @brief Holds the results of one model of solve_batch
+struct BatchResult {
+    /// @brief Indicates that the model was solved
+    bool success;
+
+    /// @brief Error message if the model failed
+    std::string error;
+
+    /// @brief Global displacements (size = total_ndof)
+    std::vector<double> uu;
+
+    /// @brief Support reactions; zero at the unknown DOFs (size = total_ndof; see Fem2d::calculate_reactions)
+    std::vector<double> reactions;
+
+    /// @brief Resultants of the external forces plus the reactions (see Fem2d::check_equilibrium)
+    EquilibriumResultants equilibrium;
+
+    /// @brief Elapsed time (seconds) of the model, including the allocation
+    double seconds;
+};
+
+/// @brief Holds the options of solve_batch
+struct BatchOptions {
+    /// @brief Number of threads of the pool (0 means the OpenMP default)
+    size_t number_of_threads;
+
+    /// @brief Linear solver used by every model
+    LinearSolverKind solver_kind;
+
+    /// @brief Calculate the reactions and the equilibrium resultants
+    bool with_reactions;
+
+    /// @brief Allocates a new BatchOptions structure with default values
+    inline static std::unique_ptr<BatchOptions> make_new() {
+        return std::unique_ptr<BatchOptions>{new BatchOptions{
+            0,          // number_of_threads
+            SOLVER_DSS, // solver_kind
+            true,       // with_reactions
+        }};
+    }
+};
+
+/// @brief Solves many independent (small) models in parallel with one model per task
+///
+/// The models are sorted by decreasing number of DOFs and handed out one at a time to the threads
+/// (dynamic scheduling); thus, an idle thread takes the next model and the large models do not end
+/// up last. MKL runs single-threaded inside each task because its internal threading does not pay off
+/// for tiny matrices. A model that throws is reported in its result and does not stop the batch.
+///
+/// @param models The model descriptions
+/// @param options The options
+/// @return The results in the same order as the models
+std::vector<BatchResult> solve_batch(const std::vector<BatchModel> &models, const BatchOptions &options);
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cmath>
+
+#include "boundary.h"
+
+std::unique_ptr<BoundaryEdges> BoundaryEdges::make_new(const std::vector<double> &coordinates,
+                                                       const std::vector<size_t> &connectivity,
+                                                       const MeshTopology &topology) {
+    if (topology.element_num_node != 3) {
+        throw "BoundaryEdges requires a mesh of triangles";
+    }
+    auto boundary = std::unique_ptr<BoundaryEdges>{new BoundaryEdges{
+        std::vector<size_t>(),
+        std::vector<size_t>(),
+    }};
+    for (size_t i = 0; i < topology.number_of_edges(); i++) {
+        if (!topology.boundary_edge(i)) {
+            continue;
+        }
+        size_t e = topology.edge_elements[i * 2];
+        size_t k = 0;
+        while (topology.element_edges[e * 3 + k] != i) {
+            k++;
+        }
+        size_t a = connectivity[e * 3 + k];
+        size_t b = connectivity[e * 3 + (k + 1) % 3];
+        size_t c = connectivity[e * 3 + (k + 2) % 3];
+
+        // keep the element on the left (the third node must be on the left of a → b)
+        double cross = (coordinates[b * 2] - coordinates[a * 2]) * (coordinates[c * 2 + 1] - coordinates[a * 2 + 1]) -
+                       (coordinates[b * 2 + 1] - coordinates[a * 2 + 1]) * (coordinates[c * 2] - coordinates[a * 2]);
+        if (cross < 0.0) {
+            std::swap(a, b);
+        }
+        boundary->nodes.push_back(a);
+        boundary->nodes.push_back(b);
+        boundary->elements.push_back(e);
+    }
+    return boundary;
+}
+
+std::unique_ptr<BoundaryEdges> BoundaryEdges::select(const std::vector<double> &coordinates,
+                                                     const point_predicate_t &predicate) const {
+    auto selected = std::unique_ptr<BoundaryEdges>{new BoundaryEdges{
+        std::vector<size_t>(),
+        std::vector<size_t>(),
+    }};
+    for (size_t i = 0; i < size(); i++) {
+        size_t a = nodes[i * 2];
+        size_t b = nodes[i * 2 + 1];
+        if (predicate(coordinates[a * 2], coordinates[a * 2 + 1]) &&
+            predicate(coordinates[b * 2], coordinates[b * 2 + 1])) {
+            selected->nodes.push_back(a);
+            selected->nodes.push_back(b);
+            selected->elements.push_back(elements[i]);
+        }
+    }
+    return selected;
+}
+
+std::unique_ptr<BoundaryEdges> BoundaryEdges::select_by_attribute(const std::vector<size_t> &attributes,
+                                                                  size_t attribute) const {
+    auto selected = std::unique_ptr<BoundaryEdges>{new BoundaryEdges{
+        std::vector<size_t>(),
+        std::vector<size_t>(),
+    }};
+    for (size_t i = 0; i < size(); i++) {
+        if (attributes[elements[i]] == attribute) {
+            selected->nodes.push_back(nodes[i * 2]);
+            selected->nodes.push_back(nodes[i * 2 + 1]);
+            selected->elements.push_back(elements[i]);
+        }
+    }
+    return selected;
+}
+
+std::vector<size_t> BoundaryEdges::unique_nodes() const {
+    std::vector<size_t> result(nodes);
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void BoundaryEdges::add_pressure_loads(std::vector<double> &forces,
+                                       const std::vector<double> &coordinates,
+                                       double pressure,
+                                       double thickness) const {
+    // traction t = -p n and L n = (yb - ya, xa - xb); each node receives t L / 2
+    double factor = -pressure * thickness / 2.0;
+    for (size_t i = 0; i < size(); i++) {
+        size_t a = nodes[i * 2];
+        size_t b = nodes[i * 2 + 1];
+        double fx = factor * (coordinates[b * 2 + 1] - coordinates[a * 2 + 1]);
+        double fy = factor * (coordinates[a * 2] - coordinates[b * 2]);
+        forces[a * 2] += fx;
+        forces[a * 2 + 1] += fy;
+        forces[b * 2] += fx;
+        forces[b * 2 + 1] += fy;
+    }
+}
+
+void BoundaryEdges::add_variable_pressure_loads(std::vector<double> &forces,
+                                                const std::vector<double> &coordinates,
+                                                const point_function_t &pressure,
+                                                double thickness) const {
+    // consistent loads of a linear distribution: fa = L (2 ta + tb) / 6 and fb = L (ta + 2 tb) / 6
+    for (size_t i = 0; i < size(); i++) {
+        size_t a = nodes[i * 2];
+        size_t b = nodes[i * 2 + 1];
+        double pa = pressure(coordinates[a * 2], coordinates[a * 2 + 1]);
+        double pb = pressure(coordinates[b * 2], coordinates[b * 2 + 1]);
+        double lnx = coordinates[b * 2 + 1] - coordinates[a * 2 + 1];
+        double lny = coordinates[a * 2] - coordinates[b * 2];
+        double qa = -thickness * (2.0 * pa + pb) / 6.0;
+        double qb = -thickness * (pa + 2.0 * pb) / 6.0;
+        forces[a * 2] += qa * lnx;
+        forces[a * 2 + 1] += qa * lny;
+        forces[b * 2] += qb * lnx;
+        forces[b * 2 + 1] += qb * lny;
+    }
+}
+
+void BoundaryEdges::add_traction_loads(std::vector<double> &forces,
+                                       const std::vector<double> &coordinates,
+                                       double tx,
+                                       double ty,
+                                       double thickness) const {
+    for (size_t i = 0; i < size(); i++) {
+        size_t a = nodes[i * 2];
+        size_t b = nodes[i * 2 + 1];
+        double dx = coordinates[b * 2] - coordinates[a * 2];
+        double dy = coordinates[b * 2 + 1] - coordinates[a * 2 + 1];
+        double half_length = thickness * sqrt(dx * dx + dy * dy) / 2.0;
+        forces[a * 2] += tx * half_length;
+        forces[a * 2 + 1] += ty * half_length;
+        forces[b * 2] += tx * half_length;
+        forces[b * 2 + 1] += ty * half_length;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "mesh_topology.h"
+
+/// @brief Defines a function selecting points by their coordinates
+typedef std::function<bool(double x, double y)> point_predicate_t;
+
+/// @brief Defines a field given by the coordinates (e.g., a pressure distribution)
+typedef std::function<double(double x, double y)> point_function_t;
+
+/// @brief Holds boundary edges of a mesh of triangles and assembles the consistent nodal loads acting on them
+///
+/// Each edge (a, b) is oriented such that its element is on the left; thus, the outward normal is
+/// n = (yb - ya, xa - xb) / L. A positive pressure p acts against the outward normal (the traction is -p n).
+/// The loads are added to a dense vector of nodal forces such as fem.natural_boundary_conditions.
+struct BoundaryEdges {
+    /// @brief Nodes (a, b) of each edge (size = 2 * number of edges)
+    std::vector<size_t> nodes;
+
+    /// @brief Element attached to each edge (size = number of edges)
+    std::vector<size_t> elements;
+
+    /// @brief Extracts the edges belonging to a single triangle
+    /// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    /// @param connectivity Connectivity of the triangles (size = 3 * number_of_elements)
+    /// @param topology Topology of the mesh (see CoordinatesAndConnectivity::get_topology)
+    static std::unique_ptr<BoundaryEdges> make_new(const std::vector<double> &coordinates,
+                                                   const std::vector<size_t> &connectivity,
+                                                   const MeshTopology &topology);
+
+    /// @brief Returns the number of edges
+    inline size_t size() const { return elements.size(); }
+
+    /// @brief Returns the edges whose two nodes satisfy the predicate
+    std::unique_ptr<BoundaryEdges> select(const std::vector<double> &coordinates,
+                                          const point_predicate_t &predicate) const;
+
+    /// @brief Returns the edges whose element has the given attribute
+    /// @param attributes Attribute of each element (e.g., CoordinatesAndConnectivity::attributes)
+    std::unique_ptr<BoundaryEdges> select_by_attribute(const std::vector<size_t> &attributes, size_t attribute) const;
+
+    /// @brief Returns the (sorted and unique) nodes of the edges
+    std::vector<size_t> unique_nodes() const;
+
+    /// @brief Adds the nodal forces corresponding to a uniform normal pressure
+    /// @param forces Nodal forces (size = 2 * number_of_nodes)
+    /// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    /// @param pressure Pressure (positive acts against the outward normal)
+    /// @param thickness Out-of-plane thickness (1.0 for plane-strain)
+    void add_pressure_loads(std::vector<double> &forces,
+                            const std::vector<double> &coordinates,
+                            double pressure,
+                            double thickness) const;
+
+    /// @brief Adds the nodal forces corresponding to a normal pressure varying linearly along each edge
+    /// @param pressure Pressure evaluated at the nodes (positive acts against the outward normal)
+    void add_variable_pressure_loads(std::vector<double> &forces,
+                                     const std::vector<double> &coordinates,
+                                     const point_function_t &pressure,
+                                     double thickness) const;
+
+    /// @brief Adds the nodal forces corresponding to a uniform traction vector (tx, ty)
+    void add_traction_loads(std::vector<double> &forces,
+                            const std::vector<double> &coordinates,
+                            double tx,
+                            double ty,
+                            double thickness) const;
+};
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+
+#include "conjugate_gradient.h"
+
+size_t solve_pcg(std::vector<double> &x,
+                 const linear_operator_t &apply_a,
+                 const std::vector<double> &inverse_diagonal,
+                 const std::vector<double> &b,
+                 double tolerance,
+                 size_t max_iterations) {
+    size_t n = b.size();
+    if (x.size() != n || inverse_diagonal.size() != n) {
+        throw "solve_pcg requires x, inverse_diagonal, and b with the same size";
+    }
+
+    // norm of the right-hand side
+    double b_norm = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        b_norm += b[i] * b[i];
+    }
+    b_norm = sqrt(b_norm);
+    if (b_norm == 0.0) {
+        std::fill(x.begin(), x.end(), 0.0);
+        return 0;
+    }
+
+    // r := b - A ⋅ x
+    std::vector<double> r(n);
+    std::vector<double> q(n);
+    apply_a(q, x);
+    for (size_t i = 0; i < n; i++) {
+        r[i] = b[i] - q[i];
+    }
+
+    // z := M⁻¹ ⋅ r and p := z
+    std::vector<double> z(n);
+    std::vector<double> p(n);
+    double rho = 0.0;
+    double r_norm = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        z[i] = inverse_diagonal[i] * r[i];
+        p[i] = z[i];
+        rho += r[i] * z[i];
+        r_norm += r[i] * r[i];
+    }
+    if (sqrt(r_norm) <= tolerance * b_norm) {
+        return 0;
+    }
+
+    for (size_t k = 1; k <= max_iterations; k++) {
+        // q := A ⋅ p
+        apply_a(q, p);
+        double pq = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            pq += p[i] * q[i];
+        }
+        if (pq <= 0.0) {
+            throw "solve_pcg failed because the operator is not positive-definite";
+        }
+        double alpha = rho / pq;
+
+        // update x and r; then z := M⁻¹ ⋅ r
+        double rho_new = 0.0;
+        r_norm = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+            z[i] = inverse_diagonal[i] * r[i];
+            rho_new += r[i] * z[i];
+            r_norm += r[i] * r[i];
+        }
+        if (sqrt(r_norm) <= tolerance * b_norm) {
+            return k;
+        }
+
+        // p := z + β ⋅ p
+        double beta = rho_new / rho;
+        for (size_t i = 0; i < n; i++) {
+            p[i] = z[i] + beta * p[i];
+        }
+        rho = rho_new;
+    }
+    throw "solve_pcg did not converge";
+}
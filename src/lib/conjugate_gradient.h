@@ -0,0 +1,23 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+/// @brief Defines the action y := A ⋅ x of a symmetric positive-definite operator
+typedef std::function<void(std::vector<double> &y, const std::vector<double> &x)> linear_operator_t;
+
+/// @brief Solves A ⋅ x = b using the Jacobi-preconditioned conjugate gradient method
+/// @param x (input/output) initial guess on input; solution on output
+/// @param apply_a computes y := A ⋅ x
+/// @param inverse_diagonal the preconditioner; i.e., 1 / diagonal(A)
+/// @param b the right-hand side vector
+/// @param tolerance relative tolerance on the residual: ‖b - A ⋅ x‖ ≤ tolerance ⋅ ‖b‖
+/// @param max_iterations maximum number of iterations
+/// @return the number of iterations
+/// @note Throws an exception if the method does not converge
+size_t solve_pcg(std::vector<double> &x,
+                 const linear_operator_t &apply_a,
+                 const std::vector<double> &inverse_diagonal,
+                 const std::vector<double> &b,
+                 double tolerance,
+                 size_t max_iterations);
@@ -0,0 +1,165 @@
+#include <algorithm>
+
+#include "csr_upper.h"
+#include "element_stiffness.h"
+#include "fem2d.h"
+
+std::unique_ptr<CsrUpper> CsrUpper::make_from_fem(Fem2d &fem) {
+    size_t nnode = fem.solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    size_t dim = fem.total_ndof;
+
+    // count the (possibly repeated) entries of each row
+    fem.calculate_element_constraint_masks(fem.element_constraint_masks);
+    std::vector<size_t> counts(dim + 1, 0);
+    size_t m[6];
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        uint8_t mask = fem.element_constraint_masks[e];
+        for (size_t k = 0; k < nnode; k++) {
+            size_t node = fem.connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+        }
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i)) {
+                continue;
+            }
+            for (size_t j = 0; j < nrow; j++) {
+                if (!mask_prescribed(mask, j) && m[j] >= m[i]) {
+                    counts[m[i] + 1]++;
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < dim; i++) {
+        if (fem.essential_prescribed[i]) {
+            counts[i + 1]++;
+        }
+        counts[i + 1] += counts[i];
+    }
+
+    // gather (column, value) pairs per row
+    std::vector<size_t> position(counts.begin(), counts.end() - 1);
+    std::vector<std::pair<MKL_INT, double>> entries(counts[dim]);
+    for (size_t i = 0; i < dim; i++) {
+        if (fem.essential_prescribed[i]) {
+            entries[position[i]++] = {static_cast<MKL_INT>(i), 1.0};
+        }
+    }
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        const double *kk = fem.get_packed_element_stiffness(buffer, e);
+        uint8_t mask = fem.element_constraint_masks[e];
+        for (size_t k = 0; k < nnode; k++) {
+            size_t node = fem.connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+        }
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i)) {
+                continue;
+            }
+            for (size_t j = 0; j < nrow; j++) {
+                if (!mask_prescribed(mask, j) && m[j] >= m[i]) {
+                    entries[position[m[i]]++] = {static_cast<MKL_INT>(m[j]), packed_get(kk, nrow, i, j)};
+                }
+            }
+        }
+    }
+
+    // sort each row and sum duplicates
+    auto csr = std::unique_ptr<CsrUpper>{new CsrUpper{
+        dim,
+        std::vector<MKL_INT>(dim + 1, 0),
+        std::vector<MKL_INT>(),
+        std::vector<double>(),
+    }};
+    csr->column_indices.reserve(counts[dim]);
+    csr->values.reserve(counts[dim]);
+    for (size_t i = 0; i < dim; i++) {
+        auto begin = entries.begin() + counts[i];
+        auto end = entries.begin() + counts[i + 1];
+        std::sort(begin, end, [](const auto &a, const auto &b) { return a.first < b.first; });
+        for (auto it = begin; it != end; ++it) {
+            if (csr->column_indices.size() > static_cast<size_t>(csr->row_pointers[i]) && csr->column_indices.back() == it->first) {
+                csr->values.back() += it->second;
+            } else {
+                csr->column_indices.push_back(it->first);
+                csr->values.push_back(it->second);
+            }
+        }
+        csr->row_pointers[i + 1] = static_cast<MKL_INT>(csr->column_indices.size());
+    }
+    csr->column_indices.shrink_to_fit();
+    csr->values.shrink_to_fit();
+    return csr;
+}
+
+void CsrUpper::update_values(Fem2d &fem) {
+    size_t nnode = fem.solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    if (fem.total_ndof != dim) {
+        throw "CsrUpper::update_values requires the problem given to make_from_fem";
+    }
+
+    // the identity on prescribed DOFs (the only entry of their rows)
+    std::fill(values.begin(), values.end(), 0.0);
+    for (size_t i = 0; i < dim; i++) {
+        if (fem.essential_prescribed[i]) {
+            values[row_pointers[i]] = 1.0;
+        }
+    }
+
+    // scatter each free entry to its position in the pattern (see ParametricAssembly)
+    fem.calculate_element_constraint_masks(fem.element_constraint_masks);
+    size_t m[6];
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        const double *kk = fem.get_packed_element_stiffness(buffer, e);
+        uint8_t mask = fem.element_constraint_masks[e];
+        for (size_t k = 0; k < nnode; k++) {
+            size_t node = fem.connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+        }
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i)) {
+                continue;
+            }
+            for (size_t j = 0; j < nrow; j++) {
+                if (!mask_prescribed(mask, j) && m[j] >= m[i]) {
+                    auto begin = column_indices.begin() + row_pointers[m[i]];
+                    auto end = column_indices.begin() + row_pointers[m[i] + 1];
+                    auto it = std::lower_bound(begin, end, static_cast<MKL_INT>(m[j]));
+                    values[it - column_indices.begin()] += packed_get(kk, nrow, i, j);
+                }
+            }
+        }
+    }
+}
+
+void CsrUpper::multiply(std::vector<double> &y, const std::vector<double> &x) const {
+    std::fill(y.begin(), y.end(), 0.0);
+    for (size_t i = 0; i < dim; i++) {
+        double sum = 0.0;
+        for (MKL_INT p = row_pointers[i]; p < row_pointers[i + 1]; p++) {
+            size_t j = column_indices[p];
+            sum += values[p] * x[j];
+            if (j != i) {
+                y[j] += values[p] * x[i];
+            }
+        }
+        y[i] += sum;
+    }
+}
+
+size_t CsrUpper::bandwidth() const {
+    size_t band = 0;
+    for (size_t i = 0; i < dim; i++) {
+        if (row_pointers[i + 1] > row_pointers[i]) {
+            // columns are sorted and j >= i
+            band = std::max(band, static_cast<size_t>(column_indices[row_pointers[i + 1] - 1]) - i);
+        }
+    }
+    return band;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mkl.h"
+
+struct Fem2d;
+
+/// @brief Holds the upper triangle of the (modified) global stiffness in CSR format (zero-based)
+///
+/// Unlike kk_csr, the arrays are accessible; thus, this matrix can be passed to
+/// PARDISO (e.g., in single precision) and used to compute residuals in double precision.
+struct CsrUpper {
+    /// @brief Number of rows = number of columns = total_ndof
+    size_t dim;
+
+    /// @brief Row pointers (size = dim + 1)
+    std::vector<MKL_INT> row_pointers;
+
+    /// @brief Column indices, sorted within each row (size = nnz)
+    std::vector<MKL_INT> column_indices;
+
+    /// @brief Values (size = nnz)
+    std::vector<double> values;
+
+    /// @brief Assembles the (modified) global stiffness of fem; i.e., [K11] and the identity on prescribed DOFs
+    /// @note The element matrices are taken from fem.element_matrices if ready
+    static std::unique_ptr<CsrUpper> make_from_fem(Fem2d &fem);
+
+    /// @brief Reassembles the values in place, keeping the pattern (and hence a PARDISO analysis of it)
+    /// @note The set of prescribed DOFs of fem must be the one given to make_from_fem (e.g., after new materials)
+    void update_values(Fem2d &fem);
+
+    /// @brief Returns the number of non-zero values
+    inline size_t nnz() const { return values.size(); }
+
+    /// @brief Computes y := A ⋅ x using the upper triangle only (A is symmetric)
+    void multiply(std::vector<double> &y, const std::vector<double> &x) const;
+
+    /// @brief Returns the half-bandwidth max|i - j| over all non-zero entries
+    size_t bandwidth() const;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdlib>
+#include <memory>
+
+/// @brief Alignment (in bytes) of the packed element matrices
+const size_t ELEMENT_MATRIX_STORE_ALIGNMENT = 64;
+
+/// @brief Frees memory allocated by std::aligned_alloc
+struct AlignedFree {
+    void operator()(double *ptr) const { std::free(ptr); }
+};
+
+/// @brief Holds the packed (upper triangle) stiffness matrices of all elements
+///
+/// The values of element e are stored contiguously at values[e * packed_size];
+/// i.e., 21 doubles per solid triangle and 10 doubles per elastic rod, in the
+/// order defined in element_stiffness.h
+struct ElementMatrixStore {
+    /// @brief Number of packed values per element (21 or 10)
+    size_t packed_size;
+
+    /// @brief Number of elements
+    size_t number_of_elements;
+
+    /// @brief Indicates that the values correspond to the current geometry and parameters
+    bool ready;
+
+    /// @brief Holds all packed values (size = packed_size * number_of_elements; aligned)
+    std::unique_ptr<double[], AlignedFree> values;
+
+    /// @brief Returns the number of bytes required to store the packed matrices
+    /// @param packed_size Number of packed values per element (21 or 10)
+    /// @param number_of_elements Number of elements
+    inline static size_t memory_required(size_t packed_size, size_t number_of_elements) {
+        size_t bytes = packed_size * number_of_elements * sizeof(double);
+        return ((bytes + ELEMENT_MATRIX_STORE_ALIGNMENT - 1) / ELEMENT_MATRIX_STORE_ALIGNMENT) * ELEMENT_MATRIX_STORE_ALIGNMENT;
+    }
+
+    /// @brief Allocates a new ElementMatrixStore
+    /// @param packed_size Number of packed values per element (21 or 10)
+    /// @param number_of_elements Number of elements
+    /// @param max_bytes Memory budget
+    /// @return NULL if the required memory exceeds max_bytes
+    inline static std::unique_ptr<ElementMatrixStore> make_new(size_t packed_size,
+                                                               size_t number_of_elements,
+                                                               size_t max_bytes) {
+        size_t bytes = memory_required(packed_size, number_of_elements);
+        if (bytes > max_bytes || bytes == 0) {
+            return NULL;
+        }
+        auto ptr = static_cast<double *>(std::aligned_alloc(ELEMENT_MATRIX_STORE_ALIGNMENT, bytes));
+        if (ptr == NULL) {
+            return NULL;
+        }
+        return std::unique_ptr<ElementMatrixStore>{new ElementMatrixStore{
+            packed_size,
+            number_of_elements,
+            false,
+            std::unique_ptr<double[], AlignedFree>{ptr},
+        }};
+    }
+
+    /// @brief Returns the number of allocated bytes
+    inline size_t memory_bytes() const {
+        return memory_required(packed_size, number_of_elements);
+    }
+
+    /// @brief Returns the packed values of element e
+    inline double *get(size_t e) {
+        return &values[e * packed_size];
+    }
+
+    /// @brief Returns the packed values of element e
+    inline const double *get(size_t e) const {
+        return &values[e * packed_size];
+    }
+};
@@ -0,0 +1,108 @@
+#include <cmath>
+
+#include "constants.h"
+#include "element_results.h"
+#include "element_stiffness.h"
+
+std::unique_ptr<ElementResults> ElementResults::make_new(const Fem2d &fem, bool with_invariants) {
+    size_t ncell = fem.number_of_elements;
+    size_t n_solid = fem.solid_triangle ? ncell : 0;
+    size_t n_invariants = fem.solid_triangle && with_invariants ? ncell : 0;
+    size_t n_rod = fem.solid_triangle ? 0 : ncell;
+    auto results = std::unique_ptr<ElementResults>{new ElementResults{
+        fem.solid_triangle,
+        fem.solid_triangle && with_invariants,
+        std::vector<double>(n_solid), // strain_xx
+        std::vector<double>(n_solid), // strain_yy
+        std::vector<double>(n_solid), // strain_zz
+        std::vector<double>(n_solid), // strain_xy
+        std::vector<double>(n_solid), // stress_xx
+        std::vector<double>(n_solid), // stress_yy
+        std::vector<double>(n_solid), // stress_zz
+        std::vector<double>(n_solid), // stress_xy
+        std::vector<double>(n_invariants),
+        std::vector<double>(n_invariants),
+        std::vector<double>(n_invariants),
+        std::vector<double>(n_invariants),
+        std::vector<double>(n_rod), // axial_strain
+        std::vector<double>(n_rod), // axial_stress
+        std::vector<double>(n_rod), // axial_force
+    }};
+    results->calculate(fem);
+    return results;
+}
+
+void ElementResults::calculate(const Fem2d &fem) {
+    size_t ncell = fem.number_of_elements;
+    const auto &uu = fem.uu;
+    const auto &coordinates = fem.coordinates;
+    const auto &connectivity = fem.connectivity;
+
+    if (!solid_triangle) {
+#pragma omp parallel for
+        for (size_t e = 0; e < ncell; e++) {
+            size_t a = connectivity[e * 2];
+            size_t b = connectivity[e * 2 + 1];
+            double xy[4] = {coordinates[a * 2], coordinates[a * 2 + 1], coordinates[b * 2], coordinates[b * 2 + 1]};
+            double geo[GEOMETRY_SIZE_ELASTIC_ROD];
+            geometry_elastic_rod(geo, xy);
+            double elongation = (uu[b * 2] - uu[a * 2]) * geo[0] + (uu[b * 2 + 1] - uu[a * 2 + 1]) * geo[1];
+            axial_strain[e] = elongation / geo[2];
+            axial_stress[e] = fem.param_young[e] * axial_strain[e];
+            axial_force[e] = fem.param_cross_area[e] * axial_stress[e];
+        }
+        return;
+    }
+
+#pragma omp parallel for
+    for (size_t e = 0; e < ncell; e++) {
+        // ε = B ⋅ ul with the gradients of the stiffness kernel
+        double xy[6], ul[6];
+        for (size_t k = 0; k < 3; k++) {
+            size_t node = connectivity[e * 3 + k];
+            xy[k * 2] = coordinates[node * 2];
+            xy[k * 2 + 1] = coordinates[node * 2 + 1];
+            ul[k * 2] = uu[node * 2];
+            ul[k * 2 + 1] = uu[node * 2 + 1];
+        }
+        double geo[GEOMETRY_SIZE_SOLID_TRIANGLE];
+        geometry_solid_triangle(geo, xy, 1.0);
+        double exx = 0.0, eyy = 0.0, gxy = 0.0;
+        for (size_t k = 0; k < 3; k++) {
+            exx += geo[k * 2] * ul[k * 2];
+            eyy += geo[k * 2 + 1] * ul[k * 2 + 1];
+            gxy += geo[k * 2 + 1] * ul[k * 2] + geo[k * 2] * ul[k * 2 + 1]; // 2 εxy
+        }
+
+        // σ = D ⋅ ε
+        double poisson = fem.param_poisson[e];
+        double d00, d01, d33;
+        elastic_modulus_components(d00, d01, d33, fem.param_young[e], poisson, fem.plane_stress);
+        double sxx = d00 * exx + d01 * eyy;
+        double syy = d01 * exx + d00 * eyy;
+        double szz = fem.plane_stress ? 0.0 : poisson * (sxx + syy);
+        strain_xx[e] = exx;
+        strain_yy[e] = eyy;
+        strain_zz[e] = fem.plane_stress ? -poisson * (exx + eyy) / (1.0 - poisson) : 0.0;
+        strain_xy[e] = gxy / SQRT_2;
+        stress_xx[e] = sxx;
+        stress_yy[e] = syy;
+        stress_zz[e] = szz;
+        stress_xy[e] = d33 * gxy / SQRT_2;
+    }
+
+    if (!with_invariants) {
+        return;
+    }
+#pragma omp parallel for
+    for (size_t e = 0; e < ncell; e++) {
+        double sxx = stress_xx[e], syy = stress_yy[e], szz = stress_zz[e];
+        double sxy = stress_xy[e] / SQRT_2; // tensor component
+        von_mises[e] = von_mises_stress(sxx, syy, szz, sxy);
+        double center = (sxx + syy) / 2.0;
+        double radius = sqrt((sxx - syy) * (sxx - syy) / 4.0 + sxy * sxy);
+        principal_1[e] = center + radius;
+        principal_2[e] = center - radius;
+        principal_angle[e] = atan2(2.0 * sxy, sxx - syy) / 2.0;
+    }
+}
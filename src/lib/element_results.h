@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "fem2d.h"
+
+/// @brief Holds the strains and stresses of all elements (structure of arrays)
+///
+/// Triangles have constant strains; the components use the Mandel basis (xx, yy, zz, xy), where the
+/// shear component is √2 times the tensor component (i.e., strain_xy = √2 εxy and stress_xy = √2 σxy).
+/// In plane-strain, strain_zz = 0 and stress_zz = ν (σxx + σyy); in plane-stress, stress_zz = 0 and
+/// strain_zz = -ν (εxx + εyy) / (1 - ν). Rods have an axial strain, stress, and force.
+/// The arrays that do not apply to the kind of element are empty.
+struct ElementResults {
+    /// @brief Solid triangles instead of rods
+    bool solid_triangle;
+
+    /// @brief Also calculate von Mises and principal stresses (solid_triangle only)
+    bool with_invariants;
+
+    /// @brief Mandel components of strain (solid_triangle only) (size = number_of_elements)
+    std::vector<double> strain_xx, strain_yy, strain_zz, strain_xy;
+
+    /// @brief Mandel components of stress (solid_triangle only) (size = number_of_elements)
+    std::vector<double> stress_xx, stress_yy, stress_zz, stress_xy;
+
+    /// @brief von Mises equivalent stress (if with_invariants) (size = number_of_elements)
+    std::vector<double> von_mises;
+
+    /// @brief Principal in-plane stresses σ1 ≥ σ2 (if with_invariants) (size = number_of_elements)
+    std::vector<double> principal_1, principal_2;
+
+    /// @brief Angle in radians between the x-axis and the direction of σ1 (if with_invariants)
+    std::vector<double> principal_angle;
+
+    /// @brief Axial strain, stress, and force of rods (rods only) (size = number_of_elements)
+    std::vector<double> axial_strain, axial_stress, axial_force;
+
+    /// @brief Allocates a new structure and calculates the results from fem.uu
+    /// @param fem The solved FEM problem
+    /// @param with_invariants Also calculate von Mises and principal stresses (solid_triangle only)
+    static std::unique_ptr<ElementResults> make_new(const Fem2d &fem, bool with_invariants = false);
+
+    /// @brief Calculates the results from fem.uu (in parallel), reusing the arrays
+    /// @note The structure must have been allocated for the same fem (see make_new)
+    void calculate(const Fem2d &fem);
+};
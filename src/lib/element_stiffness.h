@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// The functions in this file compute the element stiffness matrices without touching
+// the scratch matrices held by Fem2d; thus, they can be called concurrently.
+//
+// The results are "packed": only the upper triangle is stored, row by row
+//
+//      _                    _
+//     |  0   1   2   3   4   5 |
+//     |  .   6   7   8   9  10 |
+//     |  .   .  11  12  13  14 |   (solid triangle: 21 values)
+//     |  .   .   .  15  16  17 |
+//     |  .   .   .   .  18  19 |
+//     |_ .   .   .   .   .  20_|
+//
+//      _                _
+//     |  0   1   2   3   |
+//     |  .   4   5   6   |       (elastic rod: 10 values)
+//     |  .   .   7   8   |
+//     |_ .   .   .   9  _|
+
+/// @brief Number of packed (upper triangle) values in the solid triangle stiffness
+const size_t PACKED_SIZE_SOLID_TRIANGLE = 21;
+
+/// @brief Number of packed (upper triangle) values in the elastic rod stiffness
+const size_t PACKED_SIZE_ELASTIC_ROD = 10;
+
+/// @brief Number of geometry values cached per solid triangle (gradients + thickness * area)
+const size_t GEOMETRY_SIZE_SOLID_TRIANGLE = 7;
+
+/// @brief Number of geometry values cached per elastic rod (cosine, sine, length)
+const size_t GEOMETRY_SIZE_ELASTIC_ROD = 3;
+
+/// @brief Returns the position of (i,j) in the packed upper triangle of an n x n matrix
+/// @note Requires i <= j
+inline size_t packed_index(size_t n, size_t i, size_t j) {
+    return i * n - (i * (i - 1)) / 2 + (j - i);
+}
+
+/// @brief Returns the (i,j) entry of a symmetric matrix stored in packed format
+inline double packed_get(const double *kk, size_t n, size_t i, size_t j) {
+    return i <= j ? kk[packed_index(n, i, j)] : kk[packed_index(n, j, i)];
+}
+
+/// @brief Returns whether local DOF i is prescribed according to the element constraint bitmask
+inline bool mask_prescribed(uint8_t mask, size_t i) {
+    return (mask >> i) & 1;
+}
+
+/// @brief Calculates the geometry of a solid triangle
+/// @param geo (output) G00 G01  G10 G11  G20 G21  thickness*area (size = 7)
+/// @param xy x0 y0  x1 y1  x2 y2 (size = 6)
+inline void geometry_solid_triangle(double *geo, const double *xy, double thickness) {
+    double x0 = xy[0], y0 = xy[1];
+    double x1 = xy[2], y1 = xy[3];
+    double x2 = xy[4], y2 = xy[5];
+    double f0 = x1 * y2 - x2 * y1;
+    double f1 = x2 * y0 - x0 * y2;
+    double f2 = x0 * y1 - x1 * y0;
+    double area = (f0 + f1 + f2) / 2.0;
+    double r = 2.0 * area;
+    geo[0] = (y1 - y2) / r;
+    geo[1] = (x2 - x1) / r;
+    geo[2] = (y2 - y0) / r;
+    geo[3] = (x0 - x2) / r;
+    geo[4] = (y0 - y1) / r;
+    geo[5] = (x1 - x0) / r;
+    geo[6] = thickness * area;
+}
+
+/// @brief Calculates the geometry of an elastic rod
+/// @param geo (output) cosine sine length (size = 3)
+/// @param xy xa ya  xb yb (size = 4)
+inline void geometry_elastic_rod(double *geo, const double *xy) {
+    double dx = xy[2] - xy[0];
+    double dy = xy[3] - xy[1];
+    double l = sqrt(dx * dx + dy * dy);
+    geo[0] = dx / l;
+    geo[1] = dy / l;
+    geo[2] = l;
+}
+
+/// @brief Calculates the in-plane components of the elastic modulus D (isotropic; Mandel basis)
+/// @param d00 (output) D00 = D11
+/// @param d01 (output) D01 = D10 (also D02 = D12 in plane-strain)
+/// @param d33 (output) D33 = 2 G (the full shear term)
+inline void elastic_modulus_components(double &d00,
+                                       double &d01,
+                                       double &d33,
+                                       double young,
+                                       double poisson,
+                                       bool plane_stress) {
+    if (plane_stress) {
+        double c = young / (1.0 - poisson * poisson);
+        d00 = c;
+        d01 = c * poisson;
+        d33 = c * (1.0 - poisson);
+    } else {
+        double c = young / ((1.0 + poisson) * (1.0 - 2.0 * poisson));
+        d00 = c * (1.0 - poisson);
+        d01 = c * poisson;
+        d33 = c * (1.0 - 2.0 * poisson);
+    }
+}
+
+/// @brief Returns the von Mises stress √(3 J2) of the stress with the given components
+/// @param sxy The tensor component σxy (not the Mandel component √2 σxy)
+inline double von_mises_stress(double sxx, double syy, double szz, double sxy) {
+    return sqrt(((sxx - syy) * (sxx - syy) + (syy - szz) * (syy - szz) + (szz - sxx) * (szz - sxx)) / 2.0 +
+                3.0 * sxy * sxy);
+}
+
+/// @brief Calculates the packed stiffness of a solid triangle (isotropic linear elasticity)
+/// @param kk (output) packed upper triangle (size = 21)
+/// @param geo geometry computed by geometry_solid_triangle (size = 7)
+inline void packed_stiffness_solid_triangle(double *kk,
+                                            const double *geo,
+                                            double young,
+                                            double poisson,
+                                            bool plane_stress) {
+    // non-zero components of D (Mandel; d33 is the full shear term)
+    double d00, d01, d33;
+    elastic_modulus_components(d00, d01, d33, young, poisson, plane_stress);
+    double ta = geo[6];
+    double h = d33 / 2.0;
+    size_t p = 0;
+    for (size_t i = 0; i < 6; i++) {
+        size_t m = i / 2;
+        double gm0 = geo[m * 2];
+        double gm1 = geo[m * 2 + 1];
+        for (size_t j = i; j < 6; j++) {
+            size_t n = j / 2;
+            double gn0 = geo[n * 2];
+            double gn1 = geo[n * 2 + 1];
+            double v;
+            if (i % 2 == 0) {
+                v = j % 2 == 0 ? gm1 * gn1 * h + gm0 * gn0 * d00 : gm1 * gn0 * h + gm0 * gn1 * d01;
+            } else {
+                v = j % 2 == 0 ? gm0 * gn1 * h + gm1 * gn0 * d01 : gm0 * gn0 * h + gm1 * gn1 * d00;
+            }
+            kk[p++] = ta * v;
+        }
+    }
+}
+
+/// @brief Calculates the packed stiffness of an elastic rod
+/// @param kk (output) packed upper triangle (size = 10)
+/// @param geo geometry computed by geometry_elastic_rod (size = 3)
+inline void packed_stiffness_elastic_rod(double *kk, const double *geo, double young, double cross_area) {
+    double c = geo[0];
+    double s = geo[1];
+    double p = young * cross_area / geo[2];
+    kk[0] = p * c * c;
+    kk[1] = p * c * s;
+    kk[2] = -p * c * c;
+    kk[3] = -p * c * s;
+    kk[4] = p * s * s;
+    kk[5] = -p * c * s;
+    kk[6] = -p * s * s;
+    kk[7] = p * c * c;
+    kk[8] = p * c * s;
+    kk[9] = p * s * s;
+}
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "error_estimator.h"
+
+/// @brief Returns σᵀ ⋅ C ⋅ σ for the Mandel components of stress (3D isotropic compliance)
+inline double complementary_energy_density(const double *sig, double young, double poisson) {
+    double trace = sig[0] + sig[1] + sig[2];
+    double norm2 = sig[0] * sig[0] + sig[1] * sig[1] + sig[2] * sig[2] + sig[3] * sig[3];
+    return ((1.0 + poisson) * norm2 - poisson * trace * trace) / young;
+}
+
+std::unique_ptr<ErrorEstimate> ErrorEstimate::make_new(const Fem2d &fem,
+                                                       const ElementResults &results,
+                                                       const NodalStresses &nodal) {
+    if (!fem.solid_triangle) {
+        throw "ErrorEstimate requires a mesh of triangles";
+    }
+    size_t ncell = fem.number_of_elements;
+    auto estimate = std::unique_ptr<ErrorEstimate>{new ErrorEstimate{
+        std::vector<double>(ncell, 0.0),
+        0.0,
+        0.0,
+        0.0,
+    }};
+    const std::vector<double> *element_stress[4] = {
+        &results.stress_xx, &results.stress_yy, &results.stress_zz, &results.stress_xy};
+    const std::vector<double> *nodal_stress[4] = {
+        &nodal.stress_xx, &nodal.stress_yy, &nodal.stress_zz, &nodal.stress_xy};
+
+    double error2 = 0.0, energy = 0.0;
+#pragma omp parallel for reduction(+ : error2, energy)
+    for (size_t e = 0; e < ncell; e++) {
+        const size_t *c = &fem.connectivity[e * 3];
+        double xa = fem.coordinates[c[0] * 2], ya = fem.coordinates[c[0] * 2 + 1];
+        double xb = fem.coordinates[c[1] * 2], yb = fem.coordinates[c[1] * 2 + 1];
+        double xc = fem.coordinates[c[2] * 2], yc = fem.coordinates[c[2] * 2 + 1];
+        double ta = fem.thickness * fabs((xb - xa) * (yc - ya) - (yb - ya) * (xc - xa)) / 2.0;
+        double young = fem.param_young[e], poisson = fem.param_poisson[e];
+
+        double sig_h[4];
+        for (size_t i = 0; i < 4; i++) {
+            sig_h[i] = (*element_stress[i])[e];
+        }
+        double ee = 0.0;
+        for (size_t k = 0; k < 3; k++) {
+            // midpoint of the edge (k, k + 1)
+            size_t a = c[k], b = c[(k + 1) % 3];
+            double diff[4];
+            for (size_t i = 0; i < 4; i++) {
+                diff[i] = ((*nodal_stress[i])[a] + (*nodal_stress[i])[b]) / 2.0 - sig_h[i];
+            }
+            ee += complementary_energy_density(diff, young, poisson) * ta / 3.0;
+        }
+        estimate->element_errors[e] = sqrt(ee);
+        error2 += ee;
+        energy += complementary_energy_density(sig_h, young, poisson) * ta;
+    }
+    estimate->error = sqrt(error2);
+    estimate->energy = energy;
+    estimate->relative_error = energy + error2 > 0.0 ? sqrt(error2 / (energy + error2)) : 0.0;
+    return estimate;
+}
+
+std::vector<bool> ErrorEstimate::mark(double fraction) const {
+    if (fraction <= 0.0 || fraction > 1.0) {
+        throw "ErrorEstimate::mark requires 0 < fraction ≤ 1";
+    }
+    size_t ncell = element_errors.size();
+    std::vector<size_t> order(ncell);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return element_errors[a] > element_errors[b] || (element_errors[a] == element_errors[b] && a < b);
+    });
+    std::vector<bool> marked(ncell, false);
+    double target = fraction * error * error;
+    double sum = 0.0;
+    for (size_t i = 0; i < ncell && sum < target; i++) {
+        marked[order[i]] = true;
+        sum += element_errors[order[i]] * element_errors[order[i]];
+    }
+    return marked;
+}
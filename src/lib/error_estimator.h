@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "element_results.h"
+#include "fem2d.h"
+#include "nodal_recovery.h"
+
+/// @brief Implements the Zienkiewicz-Zhu error estimator in the energy norm (triangles only)
+///
+/// The error of element e is estimated by ηₑ² = ∫ (σ* - σₕ)ᵀ ⋅ C ⋅ (σ* - σₕ) t dA, where σₕ is the
+/// (constant) element stress, σ* is the linear interpolation of the recovered nodal stresses, and C is
+/// the (3D isotropic) compliance. The integral is exact with the three edge-midpoint quadrature rule.
+struct ErrorEstimate {
+    /// @brief Estimated error of each element in the energy norm ηₑ (size = number_of_elements)
+    std::vector<double> element_errors;
+
+    /// @brief Estimated global error η = √(Σ ηₑ²)
+    double error;
+
+    /// @brief Squared energy norm of the solution ‖uₕ‖² = Σ ∫ σₕᵀ ⋅ C ⋅ σₕ t dA
+    double energy;
+
+    /// @brief Relative error η / √(‖uₕ‖² + η²)
+    double relative_error;
+
+    /// @brief Calculates the estimate (in parallel)
+    /// @param fem The solved FEM problem
+    /// @param results The element stresses of fem
+    /// @param nodal The recovered nodal stresses (e.g., NODAL_RECOVERY_SPR)
+    static std::unique_ptr<ErrorEstimate> make_new(const Fem2d &fem,
+                                                   const ElementResults &results,
+                                                   const NodalStresses &nodal);
+
+    /// @brief Marks the elements with the largest errors (Dörfler bulk criterion)
+    /// @param fraction θ in (0, 1]: the marked elements hold at least θ of the total squared error
+    /// @return The flags of the marked elements (size = number_of_elements)
+    std::vector<bool> mark(double fraction) const;
+};
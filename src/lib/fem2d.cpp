@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <cmath>
+
 #include "fem2d.h"
 #include "constants.h"
+#include "element_stiffness.h"
 #include "fem2d.h"
 #include "laclib.h"
 #include "linear_elasticity.h"
@@ -145,6 +149,47 @@ void Fem2d::calculate_element_stiffness_solid_triangle(size_t e) {
     }
 }
 
+void Fem2d::calculate_packed_element_stiffness(double *kk, size_t e) {
+    calculate_element_stiffness(e);
+    size_t nrow = solid_triangle ? 6 : 4;
+    size_t p = 0;
+    for (size_t i = 0; i < nrow; ++i) {
+        for (size_t j = i; j < nrow; ++j) {
+            kk[p++] = kk_element->get(i, j);
+        }
+    }
+}
+
+bool Fem2d::enable_element_matrix_store(size_t max_bytes) {
+    size_t packed_size = solid_triangle ? PACKED_SIZE_SOLID_TRIANGLE : PACKED_SIZE_ELASTIC_ROD;
+    element_matrices = ElementMatrixStore::make_new(packed_size, number_of_elements, max_bytes);
+    return element_matrices != NULL;
+}
+
+void Fem2d::calculate_element_matrices() {
+    if (element_matrices == NULL) {
+        throw "cannot calculate element matrices because the store is not enabled";
+    }
+    for (size_t e = 0; e < number_of_elements; ++e) {
+        calculate_packed_element_stiffness(element_matrices->get(e), e);
+    }
+    element_matrices->ready = true;
+}
+
+void Fem2d::calculate_element_constraint_masks(std::vector<uint8_t> &masks) const {
+    size_t nnode = solid_triangle ? 3 : 2;
+    masks.resize(number_of_elements);
+    for (size_t e = 0; e < number_of_elements; ++e) {
+        uint8_t mask = 0;
+        for (size_t k = 0; k < nnode; ++k) {
+            size_t node = connectivity[e * nnode + k];
+            mask |= static_cast<uint8_t>(essential_prescribed[node * 2]) << (k * 2);
+            mask |= static_cast<uint8_t>(essential_prescribed[node * 2 + 1]) << (k * 2 + 1);
+        }
+        masks[e] = mask;
+    }
+}
+
 void Fem2d::calculate_rhs_and_global_stiffness() {
     // The linear system is partitioned into unknown (1) and
     // prescribed (2) sub-matrices and sub-vectors
@@ -170,6 +215,20 @@ void Fem2d::calculate_rhs_and_global_stiffness() {
     // {rhs1} = {f1} - [K12]{u2}
     // {rhs2} = {u2}
 
+    // allocate the COO matrix
+    if (kk_coo == NULL) {
+        // The number sum_band below corresponds to the number of values in the
+        // element stiffness matrix on the diagonal and above the diagonal (upper triangle)
+        // The actual number of non-zeros is less than 10 * number_of_elements, so
+        // this could be optimized by doing an assembly first
+        size_t sum_band = solid_triangle ? 21 : 10;
+        size_t nnz_max = sum_band * number_of_elements;
+        kk_coo = CooMatrix::make_new(UPPER_TRIANGULAR, total_ndof, nnz_max);
+    }
+
+    // which local DOFs of each element are prescribed
+    calculate_element_constraint_masks(element_constraint_masks);
+
     // initialize uu and right-hand side vector
     // also, put ones on the diagonal of the global stiffness matrix
     kk_coo->pos = 0; // reset position
@@ -187,9 +246,23 @@ void Fem2d::calculate_rhs_and_global_stiffness() {
     // number of rows = number of columns in the element matrix
     size_t nrow = solid_triangle ? 6 : 4;
 
+    // reuse or fill the element-matrix store
+    bool reuse_store = element_matrices && element_matrices->ready;
+    bool fill_store = element_matrices && !element_matrices->ready;
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+
     // fix RHS vector and assemble stiffness
     for (size_t e = 0; e < number_of_elements; ++e) {
-        calculate_element_stiffness(e);
+        const double *kk;
+        if (reuse_store) {
+            kk = element_matrices->get(e);
+        } else if (fill_store) {
+            calculate_packed_element_stiffness(element_matrices->get(e), e);
+            kk = element_matrices->get(e);
+        } else {
+            calculate_packed_element_stiffness(buffer, e);
+            kk = buffer;
+        }
         if (solid_triangle) {
             size_t a = connectivity[e * 3];
             size_t b = connectivity[e * 3 + 1];
@@ -208,27 +281,38 @@ void Fem2d::calculate_rhs_and_global_stiffness() {
             m[2] = b * 2;
             m[3] = b * 2 + 1;
         }
+        uint8_t mask = element_constraint_masks[e];
+        if (mask == 0) {
+            // fully free element: no RHS correction and every entry goes to [K11]
+            size_t p = 0;
+            for (size_t i = 0; i < nrow; ++i) {
+                for (size_t j = i; j < nrow; ++j) {
+                    if (m[j] >= m[i]) {
+                        kk_coo->put(m[i], m[j], kk[p++]);
+                    } else {
+                        kk_coo->put(m[j], m[i], kk[p++]);
+                    }
+                }
+            }
+            continue;
+        }
         for (size_t i = 0; i < nrow; ++i) {
-            if (!essential_prescribed[m[i]]) {
+            if (!mask_prescribed(mask, i)) {
                 // {rhs1} -= [K12]{u2}, correct RHS
                 for (size_t j = 0; j < nrow; ++j) {
-                    if (essential_prescribed[m[j]]) {
-                        if (j >= i) {
-                            rhs[m[i]] -= kk_element->get(i, j) * uu[m[j]];
-                        } else {
-                            // must get (i,j) from upper triangle
-                            rhs[m[i]] -= kk_element->get(j, i) * uu[m[j]];
-                        }
+                    if (mask_prescribed(mask, j)) {
+                        // packed_get takes (i,j) from the upper triangle
+                        rhs[m[i]] -= packed_get(kk, nrow, i, j) * uu[m[j]];
                     }
                 }
                 // [K11]: assemble upper triangle into global stiffness
                 for (size_t j = i; j < nrow; ++j) { // j = i => local upper triangle
-                    if (!essential_prescribed[m[j]]) {
+                    if (!mask_prescribed(mask, j)) {
                         if (m[j] >= m[i]) {
-                            kk_coo->put(m[i], m[j], kk_element->get(i, j));
+                            kk_coo->put(m[i], m[j], kk[packed_index(nrow, i, j)]);
                         } else {
                             // must go to the global upper triangle
-                            kk_coo->put(m[j], m[i], kk_element->get(i, j));
+                            kk_coo->put(m[j], m[i], kk[packed_index(nrow, i, j)]);
                         }
                     }
                 }
@@ -236,6 +320,10 @@ void Fem2d::calculate_rhs_and_global_stiffness() {
         }
     }
 
+    if (fill_store) {
+        element_matrices->ready = true;
+    }
+
     // convert COO to CSR
     if (kk_csr == NULL) {
         kk_csr = CsrMatrixMkl::from(kk_coo);
@@ -245,11 +333,282 @@ void Fem2d::calculate_rhs_and_global_stiffness() {
     }
 }
 
+void Fem2d::calculate_rhs() {
+    // see calculate_rhs_and_global_stiffness
+    for (size_t i = 0; i < total_ndof; ++i) {
+        if (essential_prescribed[i]) {
+            uu[i] = essential_boundary_conditions[i];
+            rhs[i] = essential_boundary_conditions[i];
+        } else {
+            uu[i] = 0.0;
+            rhs[i] = natural_boundary_conditions[i];
+        }
+    }
+
+    // {rhs1} -= [K12]{u2}, only for elements with non-zero prescribed values
+    calculate_element_constraint_masks(element_constraint_masks);
+    size_t nnode = solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    for (size_t e = 0; e < number_of_elements; ++e) {
+        uint8_t mask = element_constraint_masks[e];
+        if (mask == 0) {
+            continue; // fully free element
+        }
+        bool nonzero_prescribed = false;
+        for (size_t k = 0; k < nnode; ++k) {
+            size_t node = connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+            nonzero_prescribed = nonzero_prescribed || uu[node * 2] != 0.0 || uu[node * 2 + 1] != 0.0;
+        }
+        if (!nonzero_prescribed) {
+            continue;
+        }
+        const double *kk = get_packed_element_stiffness(buffer, e);
+        for (size_t i = 0; i < nrow; ++i) {
+            if (!mask_prescribed(mask, i)) {
+                for (size_t j = 0; j < nrow; ++j) {
+                    if (mask_prescribed(mask, j)) {
+                        rhs[m[i]] -= packed_get(kk, nrow, i, j) * uu[m[j]];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// @brief Validates the parallel arrays of boundary conditions
+inline void check_bc_arrays(size_t number_of_nodes,
+                            std::span<const size_t> nodes,
+                            std::span<const LocalDOF> dofs,
+                            std::span<const double> values) {
+    if (dofs.size() != nodes.size() || values.size() != nodes.size()) {
+        throw "the arrays of boundary conditions (nodes, dofs, values) must have the same size";
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i] >= number_of_nodes) {
+            throw "the node number of a boundary condition is out of range";
+        }
+        if (dofs[i] != AlongX && dofs[i] != AlongY) {
+            throw "the local DOF of a boundary condition must be AlongX or AlongY";
+        }
+    }
+}
+
+void Fem2d::set_essential_bcs(std::span<const size_t> nodes,
+                              std::span<const LocalDOF> dofs,
+                              std::span<const double> values) {
+    check_bc_arrays(number_of_nodes, nodes, dofs, values);
+    bool new_prescribed = false;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        size_t global_dof = nodes[i] * 2 + dofs[i];
+        new_prescribed = new_prescribed || !essential_prescribed[global_dof];
+        essential_prescribed[global_dof] = true;
+        essential_boundary_conditions[global_dof] = values[i];
+    }
+    mark_dirty(new_prescribed ? DIRTY_CONSTRAINTS | DIRTY_ESSENTIAL_VALUES : DIRTY_ESSENTIAL_VALUES);
+}
+
+void Fem2d::set_essential_bcs(std::span<const size_t> nodes, LocalDOF dof, double value) {
+    std::vector<LocalDOF> dofs(nodes.size(), dof);
+    std::vector<double> values(nodes.size(), value);
+    set_essential_bcs(nodes, dofs, values);
+}
+
+void Fem2d::set_natural_bcs(std::span<const size_t> nodes,
+                            std::span<const LocalDOF> dofs,
+                            std::span<const double> values) {
+    check_bc_arrays(number_of_nodes, nodes, dofs, values);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        natural_boundary_conditions[nodes[i] * 2 + dofs[i]] = values[i];
+    }
+    mark_dirty(DIRTY_NATURAL_VALUES);
+}
+
+void Fem2d::set_natural_bcs(std::span<const size_t> nodes, LocalDOF dof, double value) {
+    std::vector<LocalDOF> dofs(nodes.size(), dof);
+    std::vector<double> values(nodes.size(), value);
+    set_natural_bcs(nodes, dofs, values);
+}
+
+void Fem2d::update_essential_values(std::span<const size_t> nodes,
+                                    std::span<const LocalDOF> dofs,
+                                    std::span<const double> values) {
+    check_bc_arrays(number_of_nodes, nodes, dofs, values);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!essential_prescribed[nodes[i] * 2 + dofs[i]]) {
+            throw "update_essential_values requires the DOF to be prescribed already (see set_essential_bcs)";
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        essential_boundary_conditions[nodes[i] * 2 + dofs[i]] = values[i];
+    }
+    mark_dirty(DIRTY_ESSENTIAL_VALUES);
+}
+
+void Fem2d::clear_essential_bcs() {
+    std::fill(essential_prescribed.begin(), essential_prescribed.end(), false);
+    std::fill(essential_boundary_conditions.begin(), essential_boundary_conditions.end(), 0.0);
+    mark_dirty(DIRTY_CONSTRAINTS | DIRTY_ESSENTIAL_VALUES);
+}
+
+void Fem2d::mark_dirty(uint8_t flags) {
+    if ((flags & (DIRTY_GEOMETRY | DIRTY_MATERIALS)) != 0 && element_matrices) {
+        element_matrices->ready = false;
+    }
+    if ((flags & (DIRTY_GEOMETRY | DIRTY_MATERIALS | DIRTY_CONSTRAINTS)) != 0) {
+        kk_csr.reset(); // the arrays of kk_csr are not accessible; thus, it is always rebuilt
+    }
+    if ((flags & DIRTY_CONSTRAINTS) != 0) {
+        kk_upper.reset(); // new pattern; otherwise, solve refills the values in place
+    }
+    dirty |= flags;
+}
+
+void Fem2d::set_coordinates(std::span<const double> values) {
+    if (values.size() != 2 * number_of_nodes) {
+        throw "set_coordinates requires 2 * number_of_nodes values";
+    }
+    std::copy(values.begin(), values.end(), coordinates.begin());
+    mark_dirty(DIRTY_GEOMETRY);
+}
+
+void Fem2d::set_param_young(std::span<const double> values) {
+    if (values.size() != number_of_elements) {
+        throw "set_param_young requires number_of_elements values";
+    }
+    param_young.assign(values.begin(), values.end());
+    mark_dirty(DIRTY_MATERIALS);
+}
+
+void Fem2d::set_param_poisson(std::span<const double> values) {
+    if (values.size() != number_of_elements) {
+        throw "set_param_poisson requires number_of_elements values";
+    }
+    param_poisson.assign(values.begin(), values.end());
+    mark_dirty(DIRTY_MATERIALS);
+}
+
+void Fem2d::set_param_cross_area(std::span<const double> values) {
+    if (values.size() != number_of_elements) {
+        throw "set_param_cross_area requires number_of_elements values";
+    }
+    param_cross_area.assign(values.begin(), values.end());
+    mark_dirty(DIRTY_MATERIALS);
+}
+
+void Fem2d::set_linear_solver(LinearSolverKind kind, const LinearSolverOptions &options) {
+    lin_sys_solver = LinearSolver::make_new(kind, options);
+    mark_dirty(DIRTY_LINEAR_SOLVER);
+}
+
 void Fem2d::solve() {
-    if (kk_csr == NULL) {
+    bool new_stiffness = (dirty & (DIRTY_GEOMETRY | DIRTY_MATERIALS | DIRTY_CONSTRAINTS)) != 0;
+    bool new_factors = new_stiffness || (dirty & DIRTY_LINEAR_SOLVER) != 0;
+    phase_counts.solves++;
+    if (new_stiffness) {
+        phase_counts.stiffness_updates++;
+    }
+
+    // the right-hand side (and the global stiffness if required by the solver)
+    if (lin_sys_solver->requires_kk_csr() && kk_csr == NULL) {
         calculate_rhs_and_global_stiffness();
+        phase_counts.rhs_updates++;
+        phase_counts.pattern_updates++;
+    } else if (dirty != DIRTY_NONE) {
+        calculate_rhs();
+        phase_counts.rhs_updates++;
     }
-    lin_sys_solver->analyze(kk_csr);
-    lin_sys_solver->factorize(kk_csr);
+
+    // the factorization (or preconditioner) is kept if the stiffness and the solver are unchanged
+    // kk_upper keeps its pattern (and the solver its analysis) unless the constraints changed
+    if (new_factors) {
+        if (new_stiffness && kk_upper) {
+            kk_upper->update_values(*this);
+        }
+        bool new_pattern = kk_upper == NULL;
+        lin_sys_solver->factorize(*this);
+        if (new_pattern && kk_upper) {
+            phase_counts.pattern_updates++;
+        }
+        phase_counts.factorizations++;
+    }
+    dirty = DIRTY_NONE;
     lin_sys_solver->solve(uu, rhs); // uu = inv(kk) * ff
 }
+
+void Fem2d::calculate_reactions(std::vector<double> &reactions) {
+    reactions.assign(total_ndof, 0.0);
+    calculate_element_constraint_masks(element_constraint_masks);
+    size_t nnode = solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    for (size_t e = 0; e < number_of_elements; ++e) {
+        uint8_t mask = element_constraint_masks[e];
+        if (mask == 0) {
+            continue; // fully free element
+        }
+        for (size_t k = 0; k < nnode; ++k) {
+            size_t node = connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+        }
+        const double *kk = get_packed_element_stiffness(buffer, e);
+        for (size_t i = 0; i < nrow; ++i) {
+            if (mask_prescribed(mask, i)) {
+                for (size_t j = 0; j < nrow; ++j) {
+                    reactions[m[i]] += packed_get(kk, nrow, i, j) * uu[m[j]];
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < total_ndof; ++i) {
+        if (essential_prescribed[i]) {
+            reactions[i] -= natural_boundary_conditions[i];
+        }
+    }
+}
+
+EquilibriumResultants Fem2d::check_equilibrium(const std::vector<double> &reactions) const {
+    EquilibriumResultants resultants{0.0, 0.0, 0.0, 0.0};
+    double sum_abs = 0.0;
+    for (size_t p = 0; p < number_of_nodes; ++p) {
+        double fx = natural_boundary_conditions[p * 2] + reactions[p * 2];
+        double fy = natural_boundary_conditions[p * 2 + 1] + reactions[p * 2 + 1];
+        resultants.force_x += fx;
+        resultants.force_y += fy;
+        resultants.moment += coordinates[p * 2] * fy - coordinates[p * 2 + 1] * fx;
+        sum_abs += fabs(natural_boundary_conditions[p * 2]) + fabs(natural_boundary_conditions[p * 2 + 1]) +
+                   fabs(reactions[p * 2]) + fabs(reactions[p * 2 + 1]);
+    }
+    if (sum_abs > 0.0) {
+        resultants.relative_error = std::max(fabs(resultants.force_x), fabs(resultants.force_y)) / sum_abs;
+    }
+    return resultants;
+}
+
+double Fem2d::calculate_strain_energy() {
+    size_t nnode = solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    double energy = 0.0;
+    for (size_t e = 0; e < number_of_elements; ++e) {
+        const double *kk = get_packed_element_stiffness(buffer, e);
+        double ul[6];
+        for (size_t k = 0; k < nnode; ++k) {
+            size_t node = connectivity[e * nnode + k];
+            ul[k * 2] = uu[node * 2];
+            ul[k * 2 + 1] = uu[node * 2 + 1];
+        }
+        // ½ ulᵀ ⋅ kk ⋅ ul using the upper triangle only
+        size_t p = 0;
+        for (size_t i = 0; i < nrow; ++i) {
+            energy += 0.5 * kk[p++] * ul[i] * ul[i];
+            for (size_t j = i + 1; j < nrow; ++j) {
+                energy += kk[p++] * ul[i] * ul[j];
+            }
+        }
+    }
+    return energy;
+}
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <span>
 #include <tuple>
 #include <vector>
 
+#include "csr_upper.h"
+#include "element_matrix_store.h"
 #include "laclib.h"
+#include "linear_solver.h"
 
 /// @brief Defines the index of a local DOF (0 or 1)
 enum LocalDOF {
@@ -16,6 +21,51 @@ enum LocalDOF {
 /// @brief Holds the pair (node_number, dof_number)
 typedef std::tuple<size_t, LocalDOF> node_dof_pair_t;
 
+/// @brief Holds the resultants of the external forces plus the reactions (zero at equilibrium)
+struct EquilibriumResultants {
+    /// @brief Sum of the x-components of the forces
+    double force_x;
+
+    /// @brief Sum of the y-components of the forces
+    double force_y;
+
+    /// @brief Sum of the moments about the origin (counterclockwise)
+    double moment;
+
+    /// @brief max(|force_x|, |force_y|) divided by the sum of the absolute values of all forces
+    double relative_error;
+};
+
+/// @brief Defines the flags of the data changed since the last solve (see Fem2d::mark_dirty)
+enum DirtyFlag : uint8_t {
+    DIRTY_NONE = 0,
+    DIRTY_GEOMETRY = 1 << 0,         // coordinates: element matrices, stiffness values, and factorization
+    DIRTY_MATERIALS = 1 << 1,        // parameters: element matrices, stiffness values, and factorization
+    DIRTY_CONSTRAINTS = 1 << 2,      // set of prescribed DOFs: stiffness (pattern) and factorization
+    DIRTY_ESSENTIAL_VALUES = 1 << 3, // prescribed values: right-hand side only
+    DIRTY_NATURAL_VALUES = 1 << 4,   // external forces: right-hand side only
+    DIRTY_LINEAR_SOLVER = 1 << 5,    // new linear solver: factorization
+    DIRTY_ALL = 0x3f,
+};
+
+/// @brief Counts the phases executed by Fem2d::solve
+struct SolvePhaseCounts {
+    /// @brief Number of calls to solve
+    size_t solves;
+
+    /// @brief Number of times the stiffness (element matrices and global matrix) was recomputed
+    size_t stiffness_updates;
+
+    /// @brief Number of times the sparsity pattern of the global stiffness was built (with the symbolic analysis)
+    size_t pattern_updates;
+
+    /// @brief Number of factorizations (or preconditioner setups)
+    size_t factorizations;
+
+    /// @brief Number of right-hand side calculations
+    size_t rhs_updates;
+};
+
 /// @brief Implements a finite element solver for trusses in 2D
 struct Fem2d {
     /// @brief Simulate linear elastic solid triangles with 3 nodes instead of linear elastic rods with 2nodes
@@ -91,13 +141,34 @@ struct Fem2d {
     std::vector<double> rhs;
 
     /// @brief Global stiffness matrix in COO format (nnz = (10 or 21) * number_of_elements)
+    /// @note This matrix is only allocated when calculate_rhs_and_global_stiffness is called;
+    ///       thus, the matrix-free solver does not need it
     std::unique_ptr<CooMatrix> kk_coo;
 
     /// @brief Global stiffness matrix in CSR format (nnz = (10 or 21) * number_of_elements)
     std::unique_ptr<CsrMatrixMkl> kk_csr;
 
-    /// @brief Holds the linear system solver
-    std::unique_ptr<SolverDss> lin_sys_solver;
+    /// @brief Global stiffness matrix (upper triangle) with accessible CSR arrays (used by PARDISO and PCG)
+    /// @note Declared before lin_sys_solver so that the solver, which may refer to it, is destroyed first
+    std::unique_ptr<CsrUpper> kk_upper;
+
+    /// @brief Holds the linear system solver (DSS by default; see set_linear_solver)
+    std::unique_ptr<LinearSolver> lin_sys_solver;
+
+    /// @brief Holds the packed stiffness of all elements (optional; see enable_element_matrix_store)
+    std::unique_ptr<ElementMatrixStore> element_matrices;
+
+    /// @brief Constraint bitmask of each element: bit i is set if local DOF i is prescribed (size = number_of_elements)
+    /// @note Recomputed at the start of every assembly (see calculate_element_constraint_masks);
+    ///       a zero mask marks a fully free element, which takes the branch-free path
+    std::vector<uint8_t> element_constraint_masks;
+
+    /// @brief Combination of DirtyFlag with the data changed since the last solve (DIRTY_ALL initially)
+    /// @note Set by the setters below; call mark_dirty after writing the public vectors directly
+    uint8_t dirty;
+
+    /// @brief Counts the phases executed by solve
+    SolvePhaseCounts phase_counts;
 
     /// @brief Allocates a new Truss2D structure
     /// @param solid_triangle Plane-stress or plane-strain analysis with triangles instead of frames in 2D
@@ -130,13 +201,6 @@ struct Fem2d {
         auto number_of_elements = connectivity.size() / element_num_node;
         auto total_ndof = 2 * number_of_nodes;
 
-        // The number sum_band below corresponds to the number of values in the
-        // element stiffness matrix on the diagonal and above the diagonal (upper triangle)
-        // The actual number of non-zeros is less than 10 * number_of_elements, so
-        // this could be optimized by doing an assembly first
-        auto sum_band = solid_triangle ? 21 : 10;
-        auto nnz_max = sum_band * number_of_elements;
-
         auto essential_prescribed = std::vector<bool>(total_ndof, false);
         auto essential_boundary_conditions = std::vector<double>(total_ndof, 0.0);
         auto natural_boundary_conditions = std::vector<double>(total_ndof, 0.0);
@@ -154,11 +218,7 @@ struct Fem2d {
             natural_boundary_conditions[global_dof] = value;
         }
 
-        StoredLayout layout = UPPER_TRIANGULAR;
-
-        auto options = DssOptions::make_new();
-        options->symmetric = true;
-        options->positive_definite = true;
+        auto options = LinearSolverOptions::make_new();
 
         bool expanded_bdb = use_expanded_bdb || use_expanded_bdb_full;
 
@@ -187,9 +247,14 @@ struct Fem2d {
             std::vector<size_t>(solid_triangle ? 6 : 4),
             std::vector<double>(total_ndof),
             std::vector<double>(total_ndof),
-            CooMatrix::make_new(layout, total_ndof, nnz_max),
+            NULL, // kk_coo: allocated by calculate_rhs_and_global_stiffness
             NULL,
-            SolverDss::make_new(options),
+            NULL, // kk_upper
+            LinearSolver::make_new(SOLVER_DSS, *options),
+            NULL, // element_matrices: see enable_element_matrix_store
+            std::vector<uint8_t>(number_of_elements, 0),
+            DIRTY_ALL,
+            SolvePhaseCounts{0, 0, 0, 0, 0},
         }};
     }
 
@@ -211,9 +276,117 @@ struct Fem2d {
         }
     }
 
+    /// @brief Calculates the element stiffness and copies its upper triangle to kk (packed)
+    /// @param kk (output) packed stiffness (size = 21 if solid_triangle; 10 otherwise)
+    /// @param e index of element in 0 <= e < number_of_elements
+    void calculate_packed_element_stiffness(double *kk, size_t e);
+
+    /// @brief Allocates the packed element-matrix store if it fits in the memory budget
+    /// @param max_bytes Memory budget; the store is switched off if it would need more than this
+    /// @return true if the store is enabled; false otherwise
+    /// @note The store is filled by calculate_element_matrices or calculate_rhs_and_global_stiffness
+    ///       and is then reused by the assembly, the matrix-free operator, and the energy calculation.
+    ///       The store is invalidated by set_coordinates, set_param_young, etc. (see mark_dirty).
+    bool enable_element_matrix_store(size_t max_bytes);
+
+    /// @brief Calculates the stiffness of all elements and saves them in the element-matrix store
+    void calculate_element_matrices();
+
+    /// @brief Returns the packed stiffness of element e, reusing the element-matrix store if ready
+    /// @param buffer (workspace) used if the store is not available (size = 21 or 10)
+    /// @param e index of element in 0 <= e < number_of_elements
+    inline const double *get_packed_element_stiffness(double *buffer, size_t e) {
+        if (element_matrices && element_matrices->ready) {
+            return element_matrices->get(e);
+        }
+        calculate_packed_element_stiffness(buffer, e);
+        return buffer;
+    }
+
+    /// @brief Calculates the constraint bitmask of all elements (bit i = local DOF i is prescribed)
+    /// @param masks (output) the bitmasks (size = number_of_elements)
+    void calculate_element_constraint_masks(std::vector<uint8_t> &masks) const;
+
     /// @brief Calculates the global stiffness
     void calculate_rhs_and_global_stiffness();
 
+    /// @brief Calculates the right-hand side vector only (without assembling the global stiffness)
+    /// @note Sets uu to the prescribed values on prescribed DOFs and zero elsewhere
+    void calculate_rhs();
+
+    /// @brief Prescribes essential (displacement) boundary conditions given as parallel arrays
+    /// @param nodes Node numbers (size = n)
+    /// @param dofs Local DOF of each node (size = n)
+    /// @param values Prescribed values (size = n)
+    /// @note Writes the dense vectors directly (no map); the arrays are validated before anything is changed.
+    ///       The global stiffness is discarded if the set of prescribed DOFs changes (see mark_dirty).
+    void set_essential_bcs(std::span<const size_t> nodes, std::span<const LocalDOF> dofs, std::span<const double> values);
+
+    /// @brief Prescribes the same essential boundary condition to one DOF of all given nodes
+    void set_essential_bcs(std::span<const size_t> nodes, LocalDOF dof, double value);
+
+    /// @brief Sets natural (force) boundary conditions given as parallel arrays (see set_essential_bcs)
+    void set_natural_bcs(std::span<const size_t> nodes, std::span<const LocalDOF> dofs, std::span<const double> values);
+
+    /// @brief Sets the same natural boundary condition to one DOF of all given nodes
+    void set_natural_bcs(std::span<const size_t> nodes, LocalDOF dof, double value);
+
+    /// @brief Updates the values of already prescribed DOFs in place
+    /// @param nodes Node numbers (size = n)
+    /// @param dofs Local DOF of each node (size = n)
+    /// @param values New prescribed values (size = n)
+    /// @note Throws if a DOF is not prescribed; hence, the global stiffness (and its factorization) stays valid
+    void update_essential_values(std::span<const size_t> nodes,
+                                 std::span<const LocalDOF> dofs,
+                                 std::span<const double> values);
+
+    /// @brief Removes all essential boundary conditions (and discards the global stiffness)
+    void clear_essential_bcs();
+
+    /// @brief Marks data as changed and discards what depends on it
+    /// @param flags Combination of DirtyFlag
+    /// @note Geometry and materials invalidate the element-matrix store and the values of the global stiffness
+    ///       (kk_upper is refilled in place by the next solve); only constraints discard its pattern (and hence
+    ///       the symbolic analysis). kk_csr is always rebuilt. The remaining phases are redone by the next solve.
+    void mark_dirty(uint8_t flags);
+
+    /// @brief Sets the coordinates (same number of nodes) and marks the geometry dirty
+    /// @param values x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    void set_coordinates(std::span<const double> values);
+
+    /// @brief Sets the Young's moduli and marks the materials dirty
+    /// @param values All Young's modulus (size = number_of_elements)
+    void set_param_young(std::span<const double> values);
+
+    /// @brief Sets the Poisson coefficients (solid_triangle only) and marks the materials dirty
+    /// @param values All Poisson coefficients (size = number_of_elements)
+    void set_param_poisson(std::span<const double> values);
+
+    /// @brief Sets the cross-sectional areas (rod element only) and marks the materials dirty
+    /// @param values All cross-sectional areas (size = number_of_elements)
+    void set_param_cross_area(std::span<const double> values);
+
+    /// @brief Selects the linear solver used by solve
+    /// @param kind The kind of solver (e.g., SOLVER_PARDISO or SOLVER_MIXED_PRECISION)
+    /// @param options The solver options (see LinearSolverOptions::make_new)
+    void set_linear_solver(LinearSolverKind kind, const LinearSolverOptions &options);
+
+    /// @brief Calculates the strain energy ½ uuᵀ ⋅ K ⋅ uu (using the unmodified stiffness)
+    double calculate_strain_energy();
+
     /// @brief Solves the mechanical problem
+    /// @note Only the phases depending on the dirty data are recomputed: the element matrices and the global
+    ///       stiffness (geometry, materials, or constraints), the factorization (the same or a new solver),
+    ///       and the right-hand side (anything dirty). Nothing dirty reuses the right-hand side and factors.
     void solve();
+
+    /// @brief Calculates the support reactions R = K ⋅ uu - f at the prescribed DOFs (after solve)
+    /// @param reactions (output) the reactions; zero at the unknown DOFs (size = total_ndof)
+    /// @note Only the elements touching prescribed DOFs are visited, using the unmodified element
+    ///       stiffness; thus, the global stiffness is not required
+    void calculate_reactions(std::vector<double> &reactions);
+
+    /// @brief Calculates the resultants of the natural boundary conditions plus the reactions
+    /// @param reactions the reactions computed by calculate_reactions (size = total_ndof)
+    EquilibriumResultants check_equilibrium(const std::vector<double> &reactions) const;
 };
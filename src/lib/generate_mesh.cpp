@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cmath>
+
+#include "generate_mesh.h"
+
+/// @brief Generates the connectivity of a structured grid and the coordinates given by the mapping (i, j) → (x, y)
+template <typename Mapping>
+std::unique_ptr<CoordinatesAndConnectivity> generate_grid(size_t nx,
+                                                          size_t ny,
+                                                          size_t element_num_node,
+                                                          const Mapping &mapping) {
+    if (nx < 1 || ny < 1) {
+        throw "the number of divisions of a structured mesh must be at least 1";
+    }
+    if (element_num_node != 2 && element_num_node != 3) {
+        throw "structured meshes can be generated with lin2 or tri3 only";
+    }
+    size_t npoint = (nx + 1) * (ny + 1);
+    size_t nhorizontal = nx * (ny + 1);
+    size_t nvertical = (nx + 1) * ny;
+    size_t ncell = element_num_node == 3 ? 2 * nx * ny : nhorizontal + nvertical + nx * ny;
+    auto mesh = std::unique_ptr<CoordinatesAndConnectivity>{new CoordinatesAndConnectivity{
+        std::vector<double>(npoint * 2),
+        std::vector<size_t>(ncell * element_num_node),
+        std::vector<size_t>(ncell, 1),
+        element_num_node,
+        NULL, // topology
+    }};
+    auto &coordinates = mesh->coordinates;
+    auto &connectivity = mesh->connectivity;
+    auto &attributes = mesh->attributes;
+
+    // coordinates
+#pragma omp parallel for
+    for (size_t j = 0; j <= ny; j++) {
+        for (size_t i = 0; i <= nx; i++) {
+            size_t p = j * (nx + 1) + i;
+            mapping(coordinates[p * 2], coordinates[p * 2 + 1], i, j);
+        }
+    }
+
+    // connectivity
+    auto node = [nx](size_t i, size_t j) { return j * (nx + 1) + i; };
+    if (element_num_node == 3) {
+#pragma omp parallel for
+        for (size_t j = 0; j < ny; j++) {
+            for (size_t i = 0; i < nx; i++) {
+                size_t e = 2 * (j * nx + i);
+                size_t *c = &connectivity[e * 3];
+                c[0] = node(i, j);
+                c[1] = node(i + 1, j);
+                c[2] = node(i + 1, j + 1);
+                c[3] = node(i, j);
+                c[4] = node(i + 1, j + 1);
+                c[5] = node(i, j + 1);
+            }
+        }
+        return mesh;
+    }
+#pragma omp parallel for
+    for (size_t j = 0; j <= ny; j++) {
+        for (size_t i = 0; i < nx; i++) {
+            size_t e = j * nx + i;
+            connectivity[e * 2] = node(i, j);
+            connectivity[e * 2 + 1] = node(i + 1, j);
+        }
+    }
+#pragma omp parallel for
+    for (size_t j = 0; j < ny; j++) {
+        for (size_t i = 0; i <= nx; i++) {
+            size_t e = nhorizontal + j * (nx + 1) + i;
+            connectivity[e * 2] = node(i, j);
+            connectivity[e * 2 + 1] = node(i, j + 1);
+            attributes[e] = 2;
+        }
+    }
+#pragma omp parallel for
+    for (size_t j = 0; j < ny; j++) {
+        for (size_t i = 0; i < nx; i++) {
+            size_t e = nhorizontal + nvertical + j * nx + i;
+            connectivity[e * 2] = node(i, j);
+            connectivity[e * 2 + 1] = node(i + 1, j + 1);
+            attributes[e] = 3;
+        }
+    }
+    return mesh;
+}
+
+std::unique_ptr<CoordinatesAndConnectivity> generate_rectangle(double xmin,
+                                                               double ymin,
+                                                               double xmax,
+                                                               double ymax,
+                                                               size_t nx,
+                                                               size_t ny,
+                                                               size_t element_num_node) {
+    if (xmax <= xmin || ymax <= ymin) {
+        throw "generate_rectangle requires xmin < xmax and ymin < ymax";
+    }
+    double dx = (xmax - xmin) / static_cast<double>(nx);
+    double dy = (ymax - ymin) / static_cast<double>(ny);
+    return generate_grid(nx, ny, element_num_node, [&](double &x, double &y, size_t i, size_t j) {
+        x = i == nx ? xmax : xmin + static_cast<double>(i) * dx;
+        y = j == ny ? ymax : ymin + static_cast<double>(j) * dy;
+    });
+}
+
+std::unique_ptr<CoordinatesAndConnectivity> generate_quarter_ring(double a,
+                                                                  double b,
+                                                                  size_t nr,
+                                                                  size_t nt,
+                                                                  size_t element_num_node) {
+    if (a <= 0.0 || b <= a) {
+        throw "generate_quarter_ring requires 0 < a < b";
+    }
+    double dr = (b - a) / static_cast<double>(nr);
+    double dt = (M_PI / 2.0) / static_cast<double>(nt);
+    return generate_grid(nr, nt, element_num_node, [&](double &x, double &y, size_t i, size_t j) {
+        double r = i == nr ? b : a + static_cast<double>(i) * dr;
+        if (j == 0) {
+            x = r;
+            y = 0.0;
+        } else if (j == nt) {
+            x = 0.0;
+            y = r;
+        } else {
+            double t = static_cast<double>(j) * dt;
+            x = r * cos(t);
+            y = r * sin(t);
+        }
+    });
+}
+
+void quarter_ring_divisions(size_t &nr, size_t &nt, double a, double b, size_t number_of_triangles) {
+    // square cells: (b - a) / nr ≈ (π / 4) (a + b) / nt and 2 nr nt ≈ number_of_triangles
+    double ratio = M_PI * (a + b) / (4.0 * (b - a));
+    double radial = sqrt(static_cast<double>(number_of_triangles) / (2.0 * ratio));
+    nr = std::max(static_cast<size_t>(1), static_cast<size_t>(round(radial)));
+    nt = std::max(static_cast<size_t>(1), static_cast<size_t>(round(ratio * radial)));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+
+#include "read_mesh.h"
+
+// The generators below build structured meshes directly in memory (in parallel), so that
+// benchmarks and scaling tests can run at any resolution without reading mesh files.
+//
+// The nodes are numbered row by row: node (i, j) = j * (nx + 1) + i, where i runs along x
+// (or the radius) and j runs along y (or the angle). Each cell of the grid is split into
+// two counterclockwise triangles along the diagonal (i, j) → (i + 1, j + 1):
+//
+//     (i,j+1)  +-------+ (i+1,j+1)
+//              |     ,'|
+//              |  1 ,' |      triangle 0: (i,j)  (i+1,j)  (i+1,j+1)
+//              |  ,'  0|      triangle 1: (i,j)  (i+1,j+1)  (i,j+1)
+//              |,'     |
+//       (i,j)  +-------+ (i+1,j)
+//
+// With lin2 (rods), the grid lines and the diagonals become bars. They are stored by kind:
+// first the horizontal bars (attribute 1), then the vertical bars (attribute 2), and finally
+// the diagonal bars (attribute 3). The triangles have attribute 1.
+
+/// @brief Generates a structured mesh of the rectangle [xmin, xmax] × [ymin, ymax]
+/// @param nx Number of divisions along x (≥ 1)
+/// @param ny Number of divisions along y (≥ 1)
+/// @param element_num_node 3 for tri3 (2 * nx * ny triangles); 2 for lin2 (bars along the grid lines and diagonals)
+std::unique_ptr<CoordinatesAndConnectivity> generate_rectangle(double xmin,
+                                                               double ymin,
+                                                               double xmax,
+                                                               double ymax,
+                                                               size_t nx,
+                                                               size_t ny,
+                                                               size_t element_num_node = 3);
+
+/// @brief Generates a structured mesh of the quarter ring a ≤ r ≤ b and 0 ≤ θ ≤ π/2
+/// @param a Inner radius
+/// @param b Outer radius
+/// @param nr Number of divisions along the radius (≥ 1)
+/// @param nt Number of divisions along the angle (≥ 1)
+/// @param element_num_node 3 for tri3; 2 for lin2 (see generate_rectangle)
+/// @note The nodes at θ = 0 have y = 0 and the nodes at θ = π/2 have x = 0 exactly
+std::unique_ptr<CoordinatesAndConnectivity> generate_quarter_ring(double a,
+                                                                  double b,
+                                                                  size_t nr,
+                                                                  size_t nt,
+                                                                  size_t element_num_node = 3);
+
+/// @brief Calculates the divisions of a quarter ring with about number_of_triangles almost-square cells
+/// @param nr (output) Number of divisions along the radius
+/// @param nt (output) Number of divisions along the angle
+void quarter_ring_divisions(size_t &nr, size_t &nt, double a, double b, size_t number_of_triangles);
@@ -0,0 +1,202 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "conjugate_gradient.h"
+#include "fem2d.h"
+#include "linear_solver.h"
+#include "matrix_free.h"
+
+std::unique_ptr<LinearSolver> LinearSolver::make_new(LinearSolverKind kind, const LinearSolverOptions &options) {
+    switch (kind) {
+    case SOLVER_DSS: {
+        auto dss_options = DssOptions::make_new();
+        dss_options->symmetric = true;
+        dss_options->positive_definite = true;
+        auto solver = std::unique_ptr<LinearSolverDss>{new LinearSolverDss{}};
+        solver->solver = SolverDss::make_new(dss_options);
+        return solver;
+    }
+    case SOLVER_PARDISO: {
+        auto solver = std::unique_ptr<LinearSolverPardiso>{new LinearSolverPardiso{}};
+        solver->solver = SolverPardiso::make_new(options.pardiso);
+        return solver;
+    }
+    case SOLVER_MIXED_PRECISION: {
+        auto solver = std::unique_ptr<LinearSolverMixedPrecision>{new LinearSolverMixedPrecision{}};
+        solver->solver = SolverMixedPrecision::make_new(options.pardiso, options.tolerance, options.max_refinements);
+        return solver;
+    }
+    case SOLVER_PCG: {
+        auto solver = std::unique_ptr<LinearSolverPcg>{new LinearSolverPcg{}};
+        solver->tolerance = options.tolerance;
+        solver->max_iterations = options.max_iterations;
+        solver->kk = NULL;
+        solver->iterations = 0;
+        return solver;
+    }
+    case SOLVER_MATRIX_FREE_PCG: {
+        auto solver = std::unique_ptr<LinearSolverMatrixFreePcg>{new LinearSolverMatrixFreePcg{}};
+        solver->tolerance = options.tolerance;
+        solver->max_iterations = options.max_iterations;
+        solver->cache_geometry = options.cache_geometry;
+        solver->iterations = 0;
+        return solver;
+    }
+    }
+    throw "LinearSolver::make_new: unknown kind of solver";
+}
+
+// DSS ////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinearSolverDss::factorize(Fem2d &fem) {
+    if (fem.kk_csr == NULL) {
+        throw "LinearSolverDss::factorize requires kk_csr";
+    }
+    solver->analyze(fem.kk_csr);
+    solver->factorize(fem.kk_csr);
+}
+
+void LinearSolverDss::solve(std::vector<double> &x, const std::vector<double> &b) {
+    solver->solve(x, b);
+}
+
+// PARDISO ////////////////////////////////////////////////////////////////////////////////////////
+
+void LinearSolverPardiso::factorize(Fem2d &fem) {
+    if (fem.kk_upper == NULL) {
+        // a new pattern (e.g., other constraints) may have the same address and number of non-zeros
+        fem.kk_upper = CsrUpper::make_from_fem(fem);
+        solver->analyze(*fem.kk_upper);
+    }
+    solver->factorize(*fem.kk_upper);
+}
+
+void LinearSolverPardiso::solve(std::vector<double> &x, const std::vector<double> &b) {
+    solver->solve(x, b);
+}
+
+// mixed precision ////////////////////////////////////////////////////////////////////////////////
+
+void LinearSolverMixedPrecision::factorize(Fem2d &fem) {
+    if (fem.kk_upper == NULL) {
+        fem.kk_upper = CsrUpper::make_from_fem(fem);
+        solver->analyze(*fem.kk_upper);
+    }
+    solver->factorize(*fem.kk_upper);
+}
+
+void LinearSolverMixedPrecision::solve(std::vector<double> &x, const std::vector<double> &b) {
+    solver->solve(x, b);
+}
+
+// PCG ////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinearSolverPcg::factorize(Fem2d &fem) {
+    if (fem.kk_upper == NULL) {
+        fem.kk_upper = CsrUpper::make_from_fem(fem);
+    }
+    kk = fem.kk_upper.get();
+    inverse_diagonal.assign(kk->dim, 0.0);
+    for (size_t i = 0; i < kk->dim; i++) {
+        // the first entry of each row is the diagonal (sorted columns with j >= i)
+        MKL_INT p = kk->row_pointers[i];
+        if (p == kk->row_pointers[i + 1] || static_cast<size_t>(kk->column_indices[p]) != i || kk->values[p] <= 0.0) {
+            throw "LinearSolverPcg::factorize failed because the stiffness has a non-positive diagonal entry";
+        }
+        inverse_diagonal[i] = 1.0 / kk->values[p];
+    }
+}
+
+void LinearSolverPcg::solve(std::vector<double> &x, const std::vector<double> &b) {
+    if (kk == NULL) {
+        throw "LinearSolverPcg::solve requires factorize to be called first";
+    }
+    auto apply_kk = [this](std::vector<double> &y, const std::vector<double> &v) { kk->multiply(y, v); };
+    x.assign(kk->dim, 0.0);
+    iterations = solve_pcg(x, apply_kk, inverse_diagonal, b, tolerance, max_iterations);
+}
+
+// matrix-free PCG ////////////////////////////////////////////////////////////////////////////////
+
+LinearSolverMatrixFreePcg::~LinearSolverMatrixFreePcg() {}
+
+void LinearSolverMatrixFreePcg::factorize(Fem2d &fem) {
+    op = MatrixFreeOperator::make_new(fem, cache_geometry);
+    inverse_diagonal.assign(fem.total_ndof, 0.0);
+    op->calculate_diagonal(inverse_diagonal);
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        if (inverse_diagonal[i] <= 0.0) {
+            throw "LinearSolverMatrixFreePcg::factorize failed because the stiffness has a non-positive diagonal entry";
+        }
+        inverse_diagonal[i] = 1.0 / inverse_diagonal[i];
+    }
+}
+
+void LinearSolverMatrixFreePcg::solve(std::vector<double> &x, const std::vector<double> &b) {
+    if (op == NULL) {
+        throw "LinearSolverMatrixFreePcg::solve requires factorize to be called first";
+    }
+    auto apply_kk = [this](std::vector<double> &y, const std::vector<double> &v) { op->multiply(y, v); };
+    x.assign(b.size(), 0.0);
+    iterations = solve_pcg(x, apply_kk, inverse_diagonal, b, tolerance, max_iterations);
+}
+
+// comparison /////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<LinearSolverComparison> compare_linear_solvers(Fem2d &fem, const LinearSolverOptions &options) {
+    auto kinds = {SOLVER_DSS, SOLVER_PARDISO, SOLVER_MIXED_PRECISION, SOLVER_PCG, SOLVER_MATRIX_FREE_PCG};
+    auto op = MatrixFreeOperator::make_new(fem, false); // used to compute the residuals
+    std::vector<LinearSolverComparison> results;
+    std::vector<double> x(fem.total_ndof);
+    std::vector<double> kx(fem.total_ndof);
+    fem.mark_dirty(DIRTY_LINEAR_SOLVER); // the solver of fem may refer to the matrices discarded below
+    for (auto kind : kinds) {
+        auto solver = LinearSolver::make_new(kind, options);
+        LinearSolverComparison result{kind, solver->name(), false, "", 0.0, 0.0, 0.0};
+        try {
+            // every solver pays for the assembly of its own matrix
+            fem.kk_csr.reset();
+            fem.kk_upper.reset();
+            auto t0 = std::chrono::steady_clock::now();
+            if (solver->requires_kk_csr()) {
+                fem.calculate_rhs_and_global_stiffness();
+            } else {
+                fem.calculate_rhs();
+            }
+            solver->factorize(fem);
+            auto t1 = std::chrono::steady_clock::now();
+            solver->solve(x, fem.rhs);
+            auto t2 = std::chrono::steady_clock::now();
+            result.factorize_seconds = std::chrono::duration<double>(t1 - t0).count();
+            result.solve_seconds = std::chrono::duration<double>(t2 - t1).count();
+
+            // residual
+            op->multiply(kx, x);
+            double r_norm = 0.0;
+            double b_norm = 0.0;
+            for (size_t i = 0; i < fem.total_ndof; i++) {
+                r_norm += (fem.rhs[i] - kx[i]) * (fem.rhs[i] - kx[i]);
+                b_norm += fem.rhs[i] * fem.rhs[i];
+            }
+            result.relative_residual = b_norm > 0.0 ? sqrt(r_norm / b_norm) : sqrt(r_norm);
+            result.success = true;
+            fem.uu = x;
+        } catch (const char *message) {
+            result.error = message;
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+void print_linear_solver_comparison(const std::vector<LinearSolverComparison> &results) {
+    printf("%-28s %14s %14s %14s\n", "solver", "factorize (s)", "solve (s)", "rel. residual");
+    for (const auto &r : results) {
+        if (r.success) {
+            printf("%-28s %14.6f %14.6f %14.3e\n", r.name.c_str(), r.factorize_seconds, r.solve_seconds, r.relative_residual);
+        } else {
+            printf("%-28s failed: %s\n", r.name.c_str(), r.error.c_str());
+        }
+    }
+}
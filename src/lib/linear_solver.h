@@ -0,0 +1,163 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "laclib.h"
+#include "solver_mixed_precision.h"
+#include "solver_pardiso.h"
+
+struct Fem2d;
+
+/// @brief Defines the available linear solvers
+enum LinearSolverKind {
+    SOLVER_DSS,             // MKL DSS with kk_csr (default)
+    SOLVER_PARDISO,         // MKL PARDISO with kk_upper
+    SOLVER_MIXED_PRECISION, // MKL PARDISO in single precision with iterative refinement
+    SOLVER_PCG,             // Jacobi-preconditioned conjugate gradient with kk_upper
+    SOLVER_MATRIX_FREE_PCG, // Jacobi-preconditioned conjugate gradient without assembly
+};
+
+/// @brief Holds the options of all linear solvers
+struct LinearSolverOptions {
+    /// @brief PARDISO options (SOLVER_PARDISO and SOLVER_MIXED_PRECISION)
+    PardisoOptions pardiso;
+
+    /// @brief Relative tolerance on the residual (iterative solvers and mixed precision)
+    double tolerance;
+
+    /// @brief Maximum number of iterations (iterative solvers)
+    size_t max_iterations;
+
+    /// @brief Maximum number of refinement steps (mixed precision)
+    size_t max_refinements;
+
+    /// @brief Keep the element geometry (matrix-free solver)
+    bool cache_geometry;
+
+    /// @brief Allocates a new LinearSolverOptions structure with default values
+    inline static std::unique_ptr<LinearSolverOptions> make_new() {
+        return std::unique_ptr<LinearSolverOptions>{new LinearSolverOptions{
+            *PardisoOptions::make_new(), // pardiso
+            1e-12,                       // tolerance
+            100000,                      // max_iterations
+            10,                          // max_refinements
+            true,                        // cache_geometry
+        }};
+    }
+};
+
+/// @brief Defines the interface of the linear solvers used by Fem2d
+struct LinearSolver {
+    virtual ~LinearSolver() {}
+
+    /// @brief Returns the kind of solver
+    virtual LinearSolverKind kind() const = 0;
+
+    /// @brief Returns the name of the solver
+    virtual std::string name() const = 0;
+
+    /// @brief Indicates that the solver works with fem.kk_csr (from calculate_rhs_and_global_stiffness)
+    /// @note Otherwise, Fem2d::solve only calls calculate_rhs and the solver builds what it needs
+    virtual bool requires_kk_csr() const { return false; }
+
+    /// @brief Prepares the solver for the current stiffness of fem (e.g., factorization or preconditioner)
+    virtual void factorize(Fem2d &fem) = 0;
+
+    /// @brief Solves K ⋅ x = b with the matrix given to factorize
+    virtual void solve(std::vector<double> &x, const std::vector<double> &b) = 0;
+
+    /// @brief Allocates a new linear solver
+    static std::unique_ptr<LinearSolver> make_new(LinearSolverKind kind, const LinearSolverOptions &options);
+};
+
+/// @brief Holds the timings of one solver in compare_linear_solvers
+struct LinearSolverComparison {
+    /// @brief Kind of solver
+    LinearSolverKind kind;
+
+    /// @brief Name of the solver
+    std::string name;
+
+    /// @brief Indicates that the solver succeeded
+    bool success;
+
+    /// @brief Error message if the solver failed
+    std::string error;
+
+    /// @brief Elapsed time (seconds) of the factorize phase (including the assembly it requires)
+    double factorize_seconds;
+
+    /// @brief Elapsed time (seconds) of the solve phase
+    double solve_seconds;
+
+    /// @brief Relative residual ‖b - K ⋅ x‖ / ‖b‖
+    double relative_residual;
+};
+
+/// @brief Times all linear solvers on the current problem of fem
+/// @note Each solver assembles its own matrix (kk_csr and kk_upper are discarded first); hence, the
+///       factorize times are comparable. fem.uu is left with the solution of the last successful solver
+std::vector<LinearSolverComparison> compare_linear_solvers(Fem2d &fem, const LinearSolverOptions &options);
+
+/// @brief Prints the results of compare_linear_solvers
+void print_linear_solver_comparison(const std::vector<LinearSolverComparison> &results);
+
+/// @brief Implements LinearSolver with MKL DSS and fem.kk_csr
+struct LinearSolverDss : public LinearSolver {
+    std::unique_ptr<SolverDss> solver;
+    LinearSolverKind kind() const override { return SOLVER_DSS; }
+    std::string name() const override { return "DSS"; }
+    bool requires_kk_csr() const override { return true; }
+    void factorize(Fem2d &fem) override;
+    void solve(std::vector<double> &x, const std::vector<double> &b) override;
+};
+
+/// @brief Implements LinearSolver with MKL PARDISO and fem.kk_upper
+struct LinearSolverPardiso : public LinearSolver {
+    std::unique_ptr<SolverPardiso> solver;
+    LinearSolverKind kind() const override { return SOLVER_PARDISO; }
+    std::string name() const override { return "PARDISO"; }
+    void factorize(Fem2d &fem) override;
+    void solve(std::vector<double> &x, const std::vector<double> &b) override;
+};
+
+/// @brief Implements LinearSolver with single-precision PARDISO and iterative refinement
+struct LinearSolverMixedPrecision : public LinearSolver {
+    std::unique_ptr<SolverMixedPrecision> solver;
+    LinearSolverKind kind() const override { return SOLVER_MIXED_PRECISION; }
+    std::string name() const override { return "PARDISO (mixed precision)"; }
+    void factorize(Fem2d &fem) override;
+    void solve(std::vector<double> &x, const std::vector<double> &b) override;
+};
+
+/// @brief Implements LinearSolver with the Jacobi-preconditioned conjugate gradient method and fem.kk_upper
+struct LinearSolverPcg : public LinearSolver {
+    double tolerance;
+    size_t max_iterations;
+    const CsrUpper *kk;
+    std::vector<double> inverse_diagonal;
+    size_t iterations; // number of iterations in the last solve
+    LinearSolverKind kind() const override { return SOLVER_PCG; }
+    std::string name() const override { return "PCG (Jacobi)"; }
+    void factorize(Fem2d &fem) override;
+    void solve(std::vector<double> &x, const std::vector<double> &b) override;
+};
+
+struct MatrixFreeOperator;
+
+/// @brief Implements LinearSolver with the matrix-free operator and the Jacobi-preconditioned conjugate gradient method
+struct LinearSolverMatrixFreePcg : public LinearSolver {
+    double tolerance;
+    size_t max_iterations;
+    bool cache_geometry;
+    std::unique_ptr<MatrixFreeOperator> op;
+    std::vector<double> inverse_diagonal;
+    size_t iterations; // number of iterations in the last solve
+    ~LinearSolverMatrixFreePcg();
+    LinearSolverKind kind() const override { return SOLVER_MATRIX_FREE_PCG; }
+    std::string name() const override { return "PCG (Jacobi; matrix-free)"; }
+    void factorize(Fem2d &fem) override;
+    void solve(std::vector<double> &x, const std::vector<double> &b) override;
+};
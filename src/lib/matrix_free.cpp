@@ -0,0 +1,201 @@
+#include "matrix_free.h"
+#include "conjugate_gradient.h"
+#include "element_stiffness.h"
+
+/// @brief Computes the geometry of element e directly from the FEM data
+inline void calculate_element_geometry(double *geo, const Fem2d &fem, size_t e) {
+    double xy[6];
+    size_t nnode = fem.solid_triangle ? 3 : 2;
+    for (size_t k = 0; k < nnode; k++) {
+        size_t node = fem.connectivity[e * nnode + k];
+        xy[k * 2] = fem.coordinates[node * 2];
+        xy[k * 2 + 1] = fem.coordinates[node * 2 + 1];
+    }
+    if (fem.solid_triangle) {
+        geometry_solid_triangle(geo, xy, fem.thickness);
+    } else {
+        geometry_elastic_rod(geo, xy);
+    }
+}
+
+/// @brief Sets the local-to-global DOF map of element e
+inline void element_dofs(size_t *m, const Fem2d &fem, size_t e) {
+    size_t nnode = fem.solid_triangle ? 3 : 2;
+    for (size_t k = 0; k < nnode; k++) {
+        size_t node = fem.connectivity[e * nnode + k];
+        m[k * 2] = node * 2;
+        m[k * 2 + 1] = node * 2 + 1;
+    }
+}
+
+std::unique_ptr<MatrixFreeOperator> MatrixFreeOperator::make_new(const Fem2d &fem, bool cache_geometry) {
+    size_t geo_size = fem.solid_triangle ? GEOMETRY_SIZE_SOLID_TRIANGLE : GEOMETRY_SIZE_ELASTIC_ROD;
+    auto op = std::unique_ptr<MatrixFreeOperator>{new MatrixFreeOperator{
+        fem,
+        cache_geometry,
+        std::vector<double>(cache_geometry ? geo_size * fem.number_of_elements : 0),
+        std::vector<uint8_t>(),
+    }};
+    fem.calculate_element_constraint_masks(op->constraint_masks);
+    if (cache_geometry) {
+        for (size_t e = 0; e < fem.number_of_elements; e++) {
+            calculate_element_geometry(&op->geometry[e * geo_size], fem, e);
+        }
+    }
+    return op;
+}
+
+void MatrixFreeOperator::element_stiffness(double *kk, size_t e) const {
+    double local_geo[GEOMETRY_SIZE_SOLID_TRIANGLE];
+    const double *geo = local_geo;
+    if (cache_geometry) {
+        size_t geo_size = fem.solid_triangle ? GEOMETRY_SIZE_SOLID_TRIANGLE : GEOMETRY_SIZE_ELASTIC_ROD;
+        geo = &geometry[e * geo_size];
+    } else {
+        calculate_element_geometry(local_geo, fem, e);
+    }
+    if (fem.solid_triangle) {
+        packed_stiffness_solid_triangle(kk, geo, fem.param_young[e], fem.param_poisson[e], fem.plane_stress);
+    } else {
+        packed_stiffness_elastic_rod(kk, geo, fem.param_young[e], fem.param_cross_area[e]);
+    }
+}
+
+const double *MatrixFreeOperator::get_element_stiffness(double *buffer, size_t e) const {
+    if (fem.element_matrices && fem.element_matrices->ready) {
+        return fem.element_matrices->get(e);
+    }
+    element_stiffness(buffer, e);
+    return buffer;
+}
+
+void MatrixFreeOperator::multiply(std::vector<double> &y, const std::vector<double> &x) const {
+    // [K22] = identity; [K11] is added below
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        y[i] = fem.essential_prescribed[i] ? x[i] : 0.0;
+    }
+
+    size_t nrow = fem.solid_triangle ? 6 : 4;
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    size_t m[6];
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        const double *kk = get_element_stiffness(buffer, e);
+        element_dofs(m, fem, e);
+        uint8_t mask = constraint_masks[e];
+        if (mask == 0) {
+            // fully free element: plain symmetric (packed) product
+            double xl[6], yl[6];
+            for (size_t i = 0; i < nrow; i++) {
+                xl[i] = x[m[i]];
+                yl[i] = 0.0;
+            }
+            size_t p = 0;
+            for (size_t i = 0; i < nrow; i++) {
+                yl[i] += kk[p++] * xl[i];
+                for (size_t j = i + 1; j < nrow; j++) {
+                    yl[i] += kk[p] * xl[j];
+                    yl[j] += kk[p++] * xl[i];
+                }
+            }
+            for (size_t i = 0; i < nrow; i++) {
+                y[m[i]] += yl[i];
+            }
+            continue;
+        }
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i)) {
+                continue;
+            }
+            double sum = 0.0;
+            for (size_t j = 0; j < nrow; j++) {
+                if (!mask_prescribed(mask, j)) {
+                    sum += packed_get(kk, nrow, i, j) * x[m[j]];
+                }
+            }
+            y[m[i]] += sum;
+        }
+    }
+}
+
+void MatrixFreeOperator::calculate_diagonal(std::vector<double> &diagonal) const {
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        diagonal[i] = fem.essential_prescribed[i] ? 1.0 : 0.0;
+    }
+
+    size_t nrow = fem.solid_triangle ? 6 : 4;
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    size_t m[6];
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        const double *kk = get_element_stiffness(buffer, e);
+        element_dofs(m, fem, e);
+        uint8_t mask = constraint_masks[e];
+        for (size_t i = 0; i < nrow; i++) {
+            if (!mask_prescribed(mask, i)) {
+                diagonal[m[i]] += kk[packed_index(nrow, i, i)];
+            }
+        }
+    }
+}
+
+void MatrixFreeOperator::calculate_rhs(std::vector<double> &rhs) const {
+    // {rhs1} := {f1} and {rhs2} := {u2}
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        rhs[i] = fem.essential_prescribed[i] ? fem.essential_boundary_conditions[i] : fem.natural_boundary_conditions[i];
+    }
+
+    // {rhs1} -= [K12]{u2}
+    size_t nrow = fem.solid_triangle ? 6 : 4;
+    double buffer[PACKED_SIZE_SOLID_TRIANGLE];
+    size_t m[6];
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        uint8_t mask = constraint_masks[e];
+        if (mask == 0) {
+            continue; // fully free element
+        }
+        element_dofs(m, fem, e);
+        bool has_prescribed = false;
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i) && fem.essential_boundary_conditions[m[i]] != 0.0) {
+                has_prescribed = true;
+                break;
+            }
+        }
+        if (!has_prescribed) {
+            continue;
+        }
+        const double *kk = get_element_stiffness(buffer, e);
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i)) {
+                continue;
+            }
+            for (size_t j = 0; j < nrow; j++) {
+                if (mask_prescribed(mask, j)) {
+                    rhs[m[i]] -= packed_get(kk, nrow, i, j) * fem.essential_boundary_conditions[m[j]];
+                }
+            }
+        }
+    }
+}
+
+size_t MatrixFreeOperator::solve(std::vector<double> &uu, double tolerance, size_t max_iterations) const {
+    // right-hand side and preconditioner
+    std::vector<double> rhs(fem.total_ndof);
+    std::vector<double> inverse_diagonal(fem.total_ndof);
+    calculate_rhs(rhs);
+    calculate_diagonal(inverse_diagonal);
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        if (inverse_diagonal[i] <= 0.0) {
+            throw "MatrixFreeOperator::solve failed because the stiffness has a non-positive diagonal entry";
+        }
+        inverse_diagonal[i] = 1.0 / inverse_diagonal[i];
+    }
+
+    // initial guess: prescribed values and zero elsewhere
+    uu.resize(fem.total_ndof);
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        uu[i] = fem.essential_prescribed[i] ? fem.essential_boundary_conditions[i] : 0.0;
+    }
+
+    auto apply_kk = [this](std::vector<double> &y, const std::vector<double> &x) { multiply(y, x); };
+    return solve_pcg(uu, apply_kk, inverse_diagonal, rhs, tolerance, max_iterations);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "fem2d.h"
+
+/// @brief Implements the (modified) global stiffness operator without assembling it
+///
+/// The action y := K ⋅ x is computed element-by-element with the expanded Bᵀ ⋅ D ⋅ B
+/// stiffness, using the same partitioning as Fem2d::calculate_rhs_and_global_stiffness:
+/// the rows and columns of prescribed DOFs are replaced by the identity.
+/// Thus, neither kk_coo nor kk_csr are allocated. If the element-matrix store of fem is
+/// ready, the packed element matrices are taken from there instead of being recomputed.
+struct MatrixFreeOperator {
+    /// @brief Holds the FEM data (coordinates, connectivity, parameters, and boundary conditions)
+    const Fem2d &fem;
+
+    /// @brief Keep the geometry (gradients and area; or cosine, sine, and length) of all elements
+    bool cache_geometry;
+
+    /// @brief Geometry of all elements (size = (7 or 3) * number_of_elements; if cache_geometry)
+    std::vector<double> geometry;
+
+    /// @brief Constraint bitmask of all elements (see Fem2d::calculate_element_constraint_masks)
+    std::vector<uint8_t> constraint_masks;
+
+    /// @brief Allocates a new MatrixFreeOperator
+    /// @param fem The FEM data; it must outlive this operator (and its boundary conditions must not change)
+    /// @param cache_geometry Keep the element geometry (7 doubles per triangle; 3 per rod) instead of recomputing it
+    static std::unique_ptr<MatrixFreeOperator> make_new(const Fem2d &fem, bool cache_geometry);
+
+    /// @brief Calculates the packed (upper triangle) stiffness of an element
+    /// @param kk (output) packed stiffness (size = 21 or 10)
+    /// @param e index of element in 0 <= e < number_of_elements
+    void element_stiffness(double *kk, size_t e) const;
+
+    /// @brief Returns the packed stiffness of element e, reusing fem.element_matrices if ready
+    /// @param buffer (workspace) used if the element-matrix store is not available (size = 21 or 10)
+    /// @param e index of element in 0 <= e < number_of_elements
+    const double *get_element_stiffness(double *buffer, size_t e) const;
+
+    /// @brief Computes y := K ⋅ x where K is the modified global stiffness (identity on prescribed DOFs)
+    void multiply(std::vector<double> &y, const std::vector<double> &x) const;
+
+    /// @brief Computes the diagonal of the modified global stiffness
+    void calculate_diagonal(std::vector<double> &diagonal) const;
+
+    /// @brief Computes the right-hand side {f1} - [K12]{u2} (unknown) and {u2} (prescribed)
+    void calculate_rhs(std::vector<double> &rhs) const;
+
+    /// @brief Solves K ⋅ uu = rhs with the Jacobi-preconditioned conjugate gradient method
+    /// @param uu (output) the global displacements (size = total_ndof)
+    /// @param tolerance relative tolerance on the residual
+    /// @param max_iterations maximum number of iterations
+    /// @return the number of iterations
+    size_t solve(std::vector<double> &uu, double tolerance, size_t max_iterations) const;
+};
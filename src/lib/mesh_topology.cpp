@@ -0,0 +1,225 @@
+#include <algorithm>
+
+#include "mesh_topology.h"
+
+/// @brief Returns the sorted nodes (a < b) of the local edge k of element e
+inline void element_local_edge(size_t &a,
+                               size_t &b,
+                               const std::vector<size_t> &connectivity,
+                               size_t element_num_node,
+                               size_t e,
+                               size_t k) {
+    size_t p = connectivity[e * element_num_node + k];
+    size_t q = connectivity[e * element_num_node + (k + 1) % element_num_node];
+    a = std::min(p, q);
+    b = std::max(p, q);
+}
+
+/// @brief Collects the (sorted and unique) second nodes of the edges starting at node a
+inline void collect_node_edges(std::vector<size_t> &buffer,
+                               const MeshTopology &topology,
+                               const std::vector<size_t> &connectivity,
+                               size_t a) {
+    buffer.clear();
+    size_t nedge = topology.element_num_edge();
+    for (size_t p = topology.node_element_pointers[a]; p < topology.node_element_pointers[a + 1]; p++) {
+        size_t e = topology.node_elements[p];
+        for (size_t k = 0; k < nedge; k++) {
+            size_t first, second;
+            element_local_edge(first, second, connectivity, topology.element_num_node, e, k);
+            if (first == a) {
+                buffer.push_back(second);
+            }
+        }
+    }
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+}
+
+/// @brief Collects the (sorted and unique) elements sharing an edge (triangles) or a node (rods) with element e
+inline void collect_element_neighbors(std::vector<size_t> &buffer,
+                                      const MeshTopology &topology,
+                                      const std::vector<size_t> &connectivity,
+                                      size_t e) {
+    buffer.clear();
+    size_t nnode = topology.element_num_node;
+    if (nnode == 3) {
+        for (size_t k = 0; k < 3; k++) {
+            size_t edge = topology.element_edges[e * 3 + k];
+            for (size_t side = 0; side < 2; side++) {
+                size_t other = topology.edge_elements[edge * 2 + side];
+                if (other != NO_ELEMENT && other != e) {
+                    buffer.push_back(other);
+                }
+            }
+        }
+    } else {
+        for (size_t k = 0; k < nnode; k++) {
+            size_t node = connectivity[e * nnode + k];
+            for (size_t p = topology.node_element_pointers[node]; p < topology.node_element_pointers[node + 1]; p++) {
+                if (topology.node_elements[p] != e) {
+                    buffer.push_back(topology.node_elements[p]);
+                }
+            }
+        }
+    }
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+}
+
+std::unique_ptr<MeshTopology> MeshTopology::make_new(size_t number_of_nodes,
+                                                     const std::vector<size_t> &connectivity,
+                                                     size_t element_num_node) {
+    if (element_num_node != 2 && element_num_node != 3) {
+        throw "MeshTopology requires element_num_node = 2 or 3";
+    }
+    size_t number_of_elements = connectivity.size() / element_num_node;
+    auto topology = std::unique_ptr<MeshTopology>{new MeshTopology{
+        number_of_nodes,
+        number_of_elements,
+        element_num_node,
+        std::vector<size_t>(number_of_nodes + 1, 0),
+        std::vector<size_t>(connectivity.size()),
+        std::vector<size_t>(number_of_elements + 1, 0),
+        std::vector<size_t>(),
+        std::vector<size_t>(),
+        std::vector<size_t>(number_of_nodes + 1, 0),
+        std::vector<size_t>(),
+        std::vector<size_t>(),
+    }};
+    auto &t = *topology;
+
+    // node → elements
+    std::vector<size_t> position(number_of_nodes + 1, 0);
+#pragma omp parallel for
+    for (size_t i = 0; i < connectivity.size(); i++) {
+#pragma omp atomic
+        t.node_element_pointers[connectivity[i] + 1]++;
+    }
+    for (size_t n = 0; n < number_of_nodes; n++) {
+        t.node_element_pointers[n + 1] += t.node_element_pointers[n];
+        position[n] = t.node_element_pointers[n];
+    }
+#pragma omp parallel for
+    for (size_t i = 0; i < connectivity.size(); i++) {
+        size_t p;
+#pragma omp atomic capture
+        p = position[connectivity[i]]++;
+        t.node_elements[p] = i / element_num_node;
+    }
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t n = 0; n < number_of_nodes; n++) {
+        std::sort(t.node_elements.begin() + t.node_element_pointers[n],
+                  t.node_elements.begin() + t.node_element_pointers[n + 1]);
+    }
+
+    // unique edges (grouped by the smallest node)
+#pragma omp parallel
+    {
+        std::vector<size_t> buffer;
+#pragma omp for schedule(dynamic, 1024)
+        for (size_t a = 0; a < number_of_nodes; a++) {
+            collect_node_edges(buffer, t, connectivity, a);
+            t.edge_pointers[a + 1] = buffer.size();
+        }
+    }
+    for (size_t a = 0; a < number_of_nodes; a++) {
+        t.edge_pointers[a + 1] += t.edge_pointers[a];
+    }
+    size_t number_of_edges = t.edge_pointers[number_of_nodes];
+    t.edges.resize(2 * number_of_edges);
+#pragma omp parallel
+    {
+        std::vector<size_t> buffer;
+#pragma omp for schedule(dynamic, 1024)
+        for (size_t a = 0; a < number_of_nodes; a++) {
+            collect_node_edges(buffer, t, connectivity, a);
+            for (size_t k = 0; k < buffer.size(); k++) {
+                t.edges[(t.edge_pointers[a] + k) * 2] = a;
+                t.edges[(t.edge_pointers[a] + k) * 2 + 1] = buffer[k];
+            }
+        }
+    }
+
+    // element → edges
+    size_t nedge = t.element_num_edge();
+    t.element_edges.resize(nedge * number_of_elements);
+#pragma omp parallel for
+    for (size_t e = 0; e < number_of_elements; e++) {
+        for (size_t k = 0; k < nedge; k++) {
+            size_t a, b;
+            element_local_edge(a, b, connectivity, element_num_node, e, k);
+            t.element_edges[e * nedge + k] = t.find_edge(a, b);
+        }
+    }
+
+    // edge → elements (intersection of the sorted lists of both nodes)
+    t.edge_elements.assign(2 * number_of_edges, NO_ELEMENT);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t i = 0; i < number_of_edges; i++) {
+        size_t a = t.edges[i * 2];
+        size_t b = t.edges[i * 2 + 1];
+        size_t pa = t.node_element_pointers[a];
+        size_t pb = t.node_element_pointers[b];
+        size_t side = 0;
+        while (pa < t.node_element_pointers[a + 1] && pb < t.node_element_pointers[b + 1] && side < 2) {
+            if (t.node_elements[pa] < t.node_elements[pb]) {
+                pa++;
+            } else if (t.node_elements[pb] < t.node_elements[pa]) {
+                pb++;
+            } else {
+                t.edge_elements[i * 2 + side] = t.node_elements[pa];
+                side++;
+                pa++;
+                pb++;
+            }
+        }
+    }
+
+    // element → neighbors
+#pragma omp parallel
+    {
+        std::vector<size_t> buffer;
+#pragma omp for schedule(dynamic, 1024)
+        for (size_t e = 0; e < number_of_elements; e++) {
+            collect_element_neighbors(buffer, t, connectivity, e);
+            t.element_neighbor_pointers[e + 1] = buffer.size();
+        }
+    }
+    for (size_t e = 0; e < number_of_elements; e++) {
+        t.element_neighbor_pointers[e + 1] += t.element_neighbor_pointers[e];
+    }
+    t.element_neighbors.resize(t.element_neighbor_pointers[number_of_elements]);
+#pragma omp parallel
+    {
+        std::vector<size_t> buffer;
+#pragma omp for schedule(dynamic, 1024)
+        for (size_t e = 0; e < number_of_elements; e++) {
+            collect_element_neighbors(buffer, t, connectivity, e);
+            std::copy(buffer.begin(), buffer.end(), t.element_neighbors.begin() + t.element_neighbor_pointers[e]);
+        }
+    }
+    return topology;
+}
+
+size_t MeshTopology::find_edge(size_t a, size_t b) const {
+    size_t first = std::min(a, b);
+    size_t second = std::max(a, b);
+    if (first >= number_of_nodes) {
+        return NO_EDGE;
+    }
+    size_t low = edge_pointers[first];
+    size_t high = edge_pointers[first + 1];
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (edges[middle * 2 + 1] < second) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low < edge_pointers[first + 1] && edges[low * 2 + 1] == second) {
+        return low;
+    }
+    return NO_EDGE;
+}
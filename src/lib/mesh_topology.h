@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+/// @brief Indicates that there is no element (e.g., across a boundary edge)
+const size_t NO_ELEMENT = static_cast<size_t>(-1);
+
+/// @brief Indicates that an edge does not exist
+const size_t NO_EDGE = static_cast<size_t>(-1);
+
+/// @brief Holds the adjacency structures of a mesh of triangles or rods
+///
+/// All lists are sorted; thus, the results do not depend on the number of threads used to build them.
+/// The local edge k of a triangle connects its nodes k and (k + 1) % 3; a rod has a single edge.
+struct MeshTopology {
+    /// @brief Number of nodes
+    size_t number_of_nodes;
+
+    /// @brief Number of elements
+    size_t number_of_elements;
+
+    /// @brief Number of nodes per element (2 or 3)
+    size_t element_num_node;
+
+    /// @brief Row pointers of node → elements (size = number_of_nodes + 1)
+    std::vector<size_t> node_element_pointers;
+
+    /// @brief Elements attached to each node (size = element_num_node * number_of_elements)
+    std::vector<size_t> node_elements;
+
+    /// @brief Row pointers of element → neighbors (size = number_of_elements + 1)
+    std::vector<size_t> element_neighbor_pointers;
+
+    /// @brief Elements sharing an edge (triangles) or a node (rods) with each element
+    std::vector<size_t> element_neighbors;
+
+    /// @brief Unique edges as pairs (a, b) with a < b, sorted (size = 2 * number_of_edges)
+    std::vector<size_t> edges;
+
+    /// @brief Row pointers of the edges starting at each node (size = number_of_nodes + 1)
+    /// @note The edges (a, b) of node a are edge_pointers[a] ≤ i < edge_pointers[a + 1]
+    std::vector<size_t> edge_pointers;
+
+    /// @brief Edge of each local edge of each element (size = (3 or 1) * number_of_elements)
+    std::vector<size_t> element_edges;
+
+    /// @brief The (up to two) elements attached to each edge; NO_ELEMENT if missing (size = 2 * number_of_edges)
+    std::vector<size_t> edge_elements;
+
+    /// @brief Builds the topology from the connectivity (in parallel)
+    /// @param number_of_nodes Number of nodes
+    /// @param connectivity Connectivity (size = element_num_node * number_of_elements)
+    /// @param element_num_node Number of nodes per element (2 or 3)
+    static std::unique_ptr<MeshTopology> make_new(size_t number_of_nodes,
+                                                  const std::vector<size_t> &connectivity,
+                                                  size_t element_num_node);
+
+    /// @brief Returns the number of unique edges
+    inline size_t number_of_edges() const { return edges.size() / 2; }
+
+    /// @brief Returns the number of edges per element (3 for triangles; 1 for rods)
+    inline size_t element_num_edge() const { return element_num_node == 3 ? 3 : 1; }
+
+    /// @brief Returns the index of the edge (a, b) or (b, a); NO_EDGE if not found
+    size_t find_edge(size_t a, size_t b) const;
+
+    /// @brief Indicates that an edge belongs to a single element (triangles only)
+    inline bool boundary_edge(size_t edge) const { return edge_elements[edge * 2 + 1] == NO_ELEMENT; }
+};
@@ -0,0 +1,104 @@
+#include <omp.h>
+
+#include "mkl.h"
+#include "monte_carlo.h"
+
+void EnsembleStatistics::add(const std::vector<double> &uu) {
+    number_of_samples++;
+    double n = static_cast<double>(number_of_samples);
+    for (size_t i = 0; i < mean_uu.size(); i++) {
+        double delta = uu[i] - mean_uu[i];
+        mean_uu[i] += delta / n;
+        m2_uu[i] += delta * (uu[i] - mean_uu[i]);
+    }
+}
+
+void EnsembleStatistics::merge(const EnsembleStatistics &other) {
+    if (other.number_of_samples == 0) {
+        return;
+    }
+    double na = static_cast<double>(number_of_samples);
+    double nb = static_cast<double>(other.number_of_samples);
+    double n = na + nb;
+    for (size_t i = 0; i < mean_uu.size(); i++) {
+        double delta = other.mean_uu[i] - mean_uu[i];
+        mean_uu[i] += delta * nb / n;
+        m2_uu[i] += other.m2_uu[i] + delta * delta * na * nb / n;
+    }
+    number_of_samples += other.number_of_samples;
+}
+
+void EnsembleStatistics::calculate_variance(std::vector<double> &variance) const {
+    variance.assign(mean_uu.size(), 0.0);
+    if (number_of_samples < 2) {
+        return;
+    }
+    for (size_t i = 0; i < mean_uu.size(); i++) {
+        variance[i] = m2_uu[i] / static_cast<double>(number_of_samples - 1);
+    }
+}
+
+std::unique_ptr<MonteCarloEnsemble> MonteCarloEnsemble::make_new(Fem2d &fem) {
+    auto ensemble = std::unique_ptr<MonteCarloEnsemble>{new MonteCarloEnsemble{
+        fem,
+        ParametricAssembly::make_new(fem),
+        *PardisoOptions::make_new(),
+    }};
+    ensemble->pardiso.num_threads = 1;
+    return ensemble;
+}
+
+std::unique_ptr<EnsembleStatistics> MonteCarloEnsemble::run(size_t number_of_samples,
+                                                            const young_sampler_t &sampler,
+                                                            size_t number_of_threads) const {
+    int num_threads = number_of_threads > 0 ? static_cast<int>(number_of_threads) : omp_get_max_threads();
+    std::vector<std::unique_ptr<EnsembleStatistics>> partial(num_threads);
+    const char *error = NULL;
+
+#pragma omp parallel num_threads(num_threads)
+    {
+        int previous_num_threads = mkl_set_num_threads_local(1);
+        auto statistics = EnsembleStatistics::make_new(fem.total_ndof);
+        auto kk = assembly->new_matrix();
+        auto solver = SolverPardiso::make_new(pardiso);
+        std::vector<double> young(fem.number_of_elements);
+        std::vector<double> rhs(fem.total_ndof);
+        std::vector<double> uu(fem.total_ndof);
+
+        // contiguous blocks of samples per thread (deterministic statistics for a given number of threads)
+#pragma omp for schedule(static)
+        for (size_t sample = 0; sample < number_of_samples; sample++) {
+            try {
+                sampler(young, sample);
+                assembly->assemble(kk->values, rhs, young);
+                solver->factorize(*kk); // the analysis is performed on the first sample only
+                solver->solve(uu, rhs);
+                statistics->add(uu);
+            } catch (const char *message) {
+#pragma omp critical
+                if (error == NULL) {
+                    error = message;
+                }
+            } catch (...) {
+                // e.g., std::bad_alloc or an exception of the sampler (must not leave the parallel region)
+#pragma omp critical
+                if (error == NULL) {
+                    error = "unknown exception (e.g., out of memory or from the sampler) in MonteCarloEnsemble::run";
+                }
+            }
+        }
+        partial[omp_get_thread_num()] = std::move(statistics);
+        mkl_set_num_threads_local(previous_num_threads);
+    }
+    if (error != NULL) {
+        throw error;
+    }
+
+    auto total = EnsembleStatistics::make_new(fem.total_ndof);
+    for (const auto &statistics : partial) {
+        if (statistics) {
+            total->merge(*statistics);
+        }
+    }
+    return total;
+}
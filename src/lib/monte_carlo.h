@@ -0,0 +1,73 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "fem2d.h"
+#include "parametric_assembly.h"
+#include "solver_pardiso.h"
+
+/// @brief Defines a function writing the Young's moduli of one sample (size = number_of_elements)
+/// @note Called concurrently by several threads; the values must depend on the sample index only
+typedef std::function<void(std::vector<double> &param_young, size_t sample)> young_sampler_t;
+
+/// @brief Holds the running (Welford) mean and variance of the displacements of an ensemble
+struct EnsembleStatistics {
+    /// @brief Number of samples
+    size_t number_of_samples;
+
+    /// @brief Mean of the displacements (size = total_ndof)
+    std::vector<double> mean_uu;
+
+    /// @brief Sum of the squared deviations from the mean (size = total_ndof)
+    std::vector<double> m2_uu;
+
+    /// @brief Allocates new (empty) statistics
+    inline static std::unique_ptr<EnsembleStatistics> make_new(size_t total_ndof) {
+        return std::unique_ptr<EnsembleStatistics>{new EnsembleStatistics{
+            0,                                    // number_of_samples
+            std::vector<double>(total_ndof, 0.0), // mean_uu
+            std::vector<double>(total_ndof, 0.0), // m2_uu
+        }};
+    }
+
+    /// @brief Adds one sample
+    void add(const std::vector<double> &uu);
+
+    /// @brief Merges the statistics of another set of samples (Chan et al.)
+    void merge(const EnsembleStatistics &other);
+
+    /// @brief Calculates the (unbiased) sample variance of the displacements
+    /// @param variance (output) the variance; zero if there are less than two samples (size = total_ndof)
+    void calculate_variance(std::vector<double> &variance) const;
+};
+
+/// @brief Solves the same problem for many realizations of the element Young's moduli
+///
+/// Each sample reassembles the values of the global stiffness on the fixed pattern of a ParametricAssembly
+/// (Σ Eₑ ⋅ K̂ₑ), refactorizes, and solves. The samples are distributed across threads; each thread owns a
+/// copy of the values and a single-threaded PARDISO solver whose symbolic analysis is performed on the
+/// first sample of the thread and reused afterwards. Only the running statistics are kept.
+struct MonteCarloEnsemble {
+    /// @brief The base problem (mesh, Poisson coefficients, and boundary conditions; must outlive this)
+    Fem2d &fem;
+
+    /// @brief Fixed-pattern reassembly of the global stiffness
+    std::unique_ptr<ParametricAssembly> assembly;
+
+    /// @brief Options of the PARDISO solver of each thread (num_threads is set to 1)
+    PardisoOptions pardiso;
+
+    /// @brief Allocates a new ensemble
+    /// @param fem The base problem; its Young's moduli must be positive
+    static std::unique_ptr<MonteCarloEnsemble> make_new(Fem2d &fem);
+
+    /// @brief Solves the samples and accumulates the statistics of the displacements
+    /// @param number_of_samples Number of samples
+    /// @param sampler Writes the Young's moduli of each sample
+    /// @param number_of_threads Number of threads (0 means the OpenMP default)
+    std::unique_ptr<EnsembleStatistics> run(size_t number_of_samples,
+                                            const young_sampler_t &sampler,
+                                            size_t number_of_threads = 0) const;
+};
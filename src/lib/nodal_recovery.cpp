@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+
+#include "constants.h"
+#include "element_stiffness.h"
+#include "nodal_recovery.h"
+
+/// @brief Number of (Mandel) stress components
+const size_t NUM_STRESS_COMPONENTS = 4;
+
+/// @brief Number of coefficients of the linear patch polynomial a0 + a1 ξ + a2 η
+const size_t NUM_PATCH_COEFFICIENTS = 3;
+
+/// @brief Fits the patch polynomials of node p (all components) to the stresses at the centroids
+/// @param coefficients (output) a0 a1 a2 of each component (size = 12)
+/// @param h (output) the patch size used to scale the local coordinates
+/// @return false if the patch has fewer than three elements or the centroids are (almost) collinear
+inline bool fit_patch(double *coefficients,
+                      double &h,
+                      size_t p,
+                      const std::vector<double> &coordinates,
+                      const MeshTopology &topology,
+                      const std::vector<double> &centroids,
+                      const std::vector<double> *const *element_stress) {
+    size_t begin = topology.node_element_pointers[p];
+    size_t end = topology.node_element_pointers[p + 1];
+    if (end - begin < NUM_PATCH_COEFFICIENTS) {
+        return false;
+    }
+    double xp = coordinates[p * 2], yp = coordinates[p * 2 + 1];
+    h = 0.0;
+    for (size_t k = begin; k < end; k++) {
+        size_t e = topology.node_elements[k];
+        h = std::max(h, std::max(fabs(centroids[e * 2] - xp), fabs(centroids[e * 2 + 1] - yp)));
+    }
+    if (h <= 0.0) {
+        return false;
+    }
+
+    // normal equations: (Σ P Pᵀ) a = Σ P σ with P = (1, ξ, η)
+    double aa[3][3] = {{0.0}};
+    double bb[NUM_STRESS_COMPONENTS][3] = {{0.0}};
+    for (size_t k = begin; k < end; k++) {
+        size_t e = topology.node_elements[k];
+        double pp[3] = {1.0, (centroids[e * 2] - xp) / h, (centroids[e * 2 + 1] - yp) / h};
+        for (size_t i = 0; i < 3; i++) {
+            for (size_t j = 0; j < 3; j++) {
+                aa[i][j] += pp[i] * pp[j];
+            }
+            for (size_t c = 0; c < NUM_STRESS_COMPONENTS; c++) {
+                bb[c][i] += pp[i] * (*element_stress[c])[e];
+            }
+        }
+    }
+
+    // inverse of the (symmetric) 3 x 3 matrix by cofactors
+    double c00 = aa[1][1] * aa[2][2] - aa[1][2] * aa[2][1];
+    double c01 = aa[1][2] * aa[2][0] - aa[1][0] * aa[2][2];
+    double c02 = aa[1][0] * aa[2][1] - aa[1][1] * aa[2][0];
+    double det = aa[0][0] * c00 + aa[0][1] * c01 + aa[0][2] * c02;
+    double n = static_cast<double>(end - begin);
+    if (fabs(det) < 1e-10 * n * n * n) {
+        return false;
+    }
+    double inv[3][3] = {
+        {c00, aa[0][2] * aa[2][1] - aa[0][1] * aa[2][2], aa[0][1] * aa[1][2] - aa[0][2] * aa[1][1]},
+        {c01, aa[0][0] * aa[2][2] - aa[0][2] * aa[2][0], aa[0][2] * aa[1][0] - aa[0][0] * aa[1][2]},
+        {c02, aa[0][1] * aa[2][0] - aa[0][0] * aa[2][1], aa[0][0] * aa[1][1] - aa[0][1] * aa[1][0]},
+    };
+    for (size_t c = 0; c < NUM_STRESS_COMPONENTS; c++) {
+        for (size_t i = 0; i < 3; i++) {
+            coefficients[c * 3 + i] = (inv[i][0] * bb[c][0] + inv[i][1] * bb[c][1] + inv[i][2] * bb[c][2]) / det;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<NodalStresses> NodalStresses::make_new(NodalRecoveryMethod method,
+                                                       const std::vector<double> &coordinates,
+                                                       const std::vector<size_t> &connectivity,
+                                                       const MeshTopology &topology,
+                                                       const ElementResults &results) {
+    if (!results.solid_triangle || topology.element_num_node != 3) {
+        throw "NodalStresses requires a mesh of triangles";
+    }
+    size_t npoint = topology.number_of_nodes;
+    size_t ncell = topology.number_of_elements;
+    auto nodal = std::unique_ptr<NodalStresses>{new NodalStresses{
+        method,
+        std::vector<double>(npoint, 0.0),
+        std::vector<double>(npoint, 0.0),
+        std::vector<double>(npoint, 0.0),
+        std::vector<double>(npoint, 0.0),
+    }};
+    const std::vector<double> *element_stress[NUM_STRESS_COMPONENTS] = {
+        &results.stress_xx, &results.stress_yy, &results.stress_zz, &results.stress_xy};
+    std::vector<double> *nodal_stress[NUM_STRESS_COMPONENTS] = {
+        &nodal->stress_xx, &nodal->stress_yy, &nodal->stress_zz, &nodal->stress_xy};
+
+    // areas and centroids
+    std::vector<double> areas(ncell);
+    std::vector<double> centroids(ncell * 2);
+#pragma omp parallel for
+    for (size_t e = 0; e < ncell; e++) {
+        const size_t *c = &connectivity[e * 3];
+        double xa = coordinates[c[0] * 2], ya = coordinates[c[0] * 2 + 1];
+        double xb = coordinates[c[1] * 2], yb = coordinates[c[1] * 2 + 1];
+        double xc = coordinates[c[2] * 2], yc = coordinates[c[2] * 2 + 1];
+        areas[e] = fabs((xb - xa) * (yc - ya) - (yb - ya) * (xc - xa)) / 2.0;
+        centroids[e * 2] = (xa + xb + xc) / 3.0;
+        centroids[e * 2 + 1] = (ya + yb + yc) / 3.0;
+    }
+
+    // area-weighted average (also the fallback of SPR)
+    auto average = [&](size_t p, size_t c) {
+        double sum = 0.0, sum_area = 0.0;
+        for (size_t k = topology.node_element_pointers[p]; k < topology.node_element_pointers[p + 1]; k++) {
+            size_t e = topology.node_elements[k];
+            sum += areas[e] * (*element_stress[c])[e];
+            sum_area += areas[e];
+        }
+        return sum_area > 0.0 ? sum / sum_area : 0.0;
+    };
+    if (method == NODAL_RECOVERY_AVERAGING) {
+#pragma omp parallel for
+        for (size_t p = 0; p < npoint; p++) {
+            for (size_t c = 0; c < NUM_STRESS_COMPONENTS; c++) {
+                (*nodal_stress[c])[p] = average(p, c);
+            }
+        }
+        return nodal;
+    }
+
+    // boundary nodes
+    std::vector<char> on_boundary(npoint, 0);
+    for (size_t i = 0; i < topology.number_of_edges(); i++) {
+        if (topology.boundary_edge(i)) {
+            on_boundary[topology.edges[i * 2]] = 1;
+            on_boundary[topology.edges[i * 2 + 1]] = 1;
+        }
+    }
+
+    // fit the patch polynomial of every node
+    const size_t ncoef = NUM_STRESS_COMPONENTS * NUM_PATCH_COEFFICIENTS;
+    std::vector<double> coefficients(npoint * ncoef, 0.0);
+    std::vector<double> patch_size(npoint, 0.0);
+    std::vector<char> valid(npoint, 0);
+#pragma omp parallel for
+    for (size_t p = 0; p < npoint; p++) {
+        valid[p] = fit_patch(&coefficients[p * ncoef], patch_size[p], p, coordinates, topology, centroids,
+                             element_stress);
+    }
+
+    // evaluate at the nodes; the boundary nodes use the patches of the adjacent interior nodes
+    // or, if there are none (e.g., at corners), the valid patches of the adjacent boundary nodes
+#pragma omp parallel for
+    for (size_t p = 0; p < npoint; p++) {
+        if (!on_boundary[p] && valid[p]) {
+            for (size_t c = 0; c < NUM_STRESS_COMPONENTS; c++) {
+                (*nodal_stress[c])[p] = coefficients[p * ncoef + c * 3];
+            }
+            continue;
+        }
+        double sum[NUM_STRESS_COMPONENTS] = {0.0};
+        size_t count = 0;
+        for (char neighbor_on_boundary = 0; neighbor_on_boundary < 2 && count == 0; neighbor_on_boundary++) {
+            for (size_t k = topology.node_element_pointers[p]; k < topology.node_element_pointers[p + 1]; k++) {
+                size_t e = topology.node_elements[k];
+                for (size_t m = 0; m < 3; m++) {
+                    size_t q = connectivity[e * 3 + m];
+                    if (q == p || on_boundary[q] != neighbor_on_boundary || !valid[q]) {
+                        continue;
+                    }
+                    // the same node may be shared by two elements of the patch: count it once
+                    bool repeated = false;
+                    for (size_t kk = topology.node_element_pointers[p]; kk < k && !repeated; kk++) {
+                        const size_t *other = &connectivity[topology.node_elements[kk] * 3];
+                        repeated = other[0] == q || other[1] == q || other[2] == q;
+                    }
+                    if (repeated) {
+                        continue;
+                    }
+                    double xi = (coordinates[p * 2] - coordinates[q * 2]) / patch_size[q];
+                    double eta = (coordinates[p * 2 + 1] - coordinates[q * 2 + 1]) / patch_size[q];
+                    const double *a = &coefficients[q * ncoef];
+                    for (size_t c = 0; c < NUM_STRESS_COMPONENTS; c++) {
+                        sum[c] += a[c * 3] + a[c * 3 + 1] * xi + a[c * 3 + 2] * eta;
+                    }
+                    count++;
+                }
+            }
+        }
+        for (size_t c = 0; c < NUM_STRESS_COMPONENTS; c++) {
+            if (count > 0) {
+                (*nodal_stress[c])[p] = sum[c] / static_cast<double>(count);
+            } else if (valid[p]) {
+                (*nodal_stress[c])[p] = coefficients[p * ncoef + c * 3];
+            } else {
+                (*nodal_stress[c])[p] = average(p, c);
+            }
+        }
+    }
+    return nodal;
+}
+
+void NodalStresses::calculate_von_mises(std::vector<double> &von_mises) const {
+    size_t npoint = size();
+    von_mises.resize(npoint);
+#pragma omp parallel for
+    for (size_t p = 0; p < npoint; p++) {
+        double sxx = stress_xx[p], syy = stress_yy[p], szz = stress_zz[p];
+        double sxy = stress_xy[p] / SQRT_2; // tensor component
+        von_mises[p] = von_mises_stress(sxx, syy, szz, sxy);
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "element_results.h"
+#include "mesh_topology.h"
+
+/// @brief Defines the methods to recover nodal stresses from the (constant) element stresses
+enum NodalRecoveryMethod {
+    /// @brief Area-weighted average of the elements around each node
+    NODAL_RECOVERY_AVERAGING,
+
+    /// @brief Superconvergent patch recovery (Zienkiewicz and Zhu)
+    ///
+    /// A linear polynomial is fitted (least squares) to the element stresses sampled at the centroids
+    /// of the elements around each interior node. The boundary nodes take the average of the polynomials
+    /// of the adjacent interior nodes (or, at corners, of the adjacent boundary nodes), falling back to
+    /// their own patch or to the area-weighted average.
+    NODAL_RECOVERY_SPR,
+};
+
+/// @brief Holds smooth nodal stresses of a mesh of triangles (structure of arrays)
+struct NodalStresses {
+    /// @brief The recovery method
+    NodalRecoveryMethod method;
+
+    /// @brief Mandel components of stress at each node (see ElementResults) (size = number_of_nodes)
+    std::vector<double> stress_xx, stress_yy, stress_zz, stress_xy;
+
+    /// @brief Recovers the nodal stresses (in parallel)
+    /// @param method The recovery method
+    /// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    /// @param connectivity Connectivity of the triangles (size = 3 * number_of_elements)
+    /// @param topology The adjacency structures of the mesh
+    /// @param results The element stresses
+    static std::unique_ptr<NodalStresses> make_new(NodalRecoveryMethod method,
+                                                   const std::vector<double> &coordinates,
+                                                   const std::vector<size_t> &connectivity,
+                                                   const MeshTopology &topology,
+                                                   const ElementResults &results);
+
+    /// @brief Returns the number of nodes
+    inline size_t size() const { return stress_xx.size(); }
+
+    /// @brief Calculates the von Mises stress at each node
+    /// @param von_mises (output) (size = number_of_nodes)
+    void calculate_von_mises(std::vector<double> &von_mises) const;
+};
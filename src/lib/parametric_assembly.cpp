@@ -0,0 +1,130 @@
+#include <algorithm>
+
+#include "element_stiffness.h"
+#include "parametric_assembly.h"
+
+std::unique_ptr<ParametricAssembly> ParametricAssembly::make_new(Fem2d &fem) {
+    for (auto young : fem.param_young) {
+        if (young <= 0.0) {
+            throw "ParametricAssembly requires positive Young's moduli in the base problem";
+        }
+    }
+    size_t nnode = fem.solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    size_t packed_size = fem.solid_triangle ? PACKED_SIZE_SOLID_TRIANGLE : PACKED_SIZE_ELASTIC_ROD;
+    size_t ncell = fem.number_of_elements;
+
+    // symbolic: the pattern also computes fem.element_constraint_masks
+    auto pattern = CsrUpper::make_from_fem(fem);
+    auto assembly = std::unique_ptr<ParametricAssembly>{new ParametricAssembly{
+        fem,
+        std::move(pattern),
+        std::vector<size_t>(packed_size * ncell, NO_ENTRY),
+        std::vector<double>(packed_size * ncell, 0.0),
+        std::vector<size_t>{},
+    }};
+    const auto &csr = *assembly->pattern;
+
+    size_t m[6];
+    for (size_t e = 0; e < ncell; e++) {
+        // element stiffness for E = 1 (the element scratch matrices of fem are not thread-safe)
+        double *kk = &assembly->unit_element_matrices[e * packed_size];
+        fem.calculate_packed_element_stiffness(kk, e);
+        for (size_t p = 0; p < packed_size; p++) {
+            kk[p] /= fem.param_young[e];
+        }
+
+        // position of each free entry in the global upper triangle
+        uint8_t mask = fem.element_constraint_masks[e];
+        bool nonzero_prescribed = false;
+        for (size_t k = 0; k < nnode; k++) {
+            size_t node = fem.connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+        }
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i)) {
+                nonzero_prescribed = nonzero_prescribed || fem.essential_boundary_conditions[m[i]] != 0.0;
+                continue;
+            }
+            for (size_t j = i; j < nrow; j++) {
+                if (mask_prescribed(mask, j)) {
+                    continue;
+                }
+                MKL_INT row = static_cast<MKL_INT>(std::min(m[i], m[j]));
+                MKL_INT col = static_cast<MKL_INT>(std::max(m[i], m[j]));
+                auto begin = csr.column_indices.begin() + csr.row_pointers[row];
+                auto end = csr.column_indices.begin() + csr.row_pointers[row + 1];
+                auto it = std::lower_bound(begin, end, col);
+                assembly->scatter[e * packed_size + packed_index(nrow, i, j)] = it - csr.column_indices.begin();
+            }
+        }
+        if (nonzero_prescribed) {
+            assembly->rhs_elements.push_back(e);
+        }
+    }
+    return assembly;
+}
+
+std::unique_ptr<CsrUpper> ParametricAssembly::new_matrix() const {
+    return std::unique_ptr<CsrUpper>{new CsrUpper{
+        pattern->dim,
+        pattern->row_pointers,
+        pattern->column_indices,
+        std::vector<double>(pattern->nnz(), 0.0),
+    }};
+}
+
+void ParametricAssembly::assemble(std::vector<double> &values,
+                                  std::vector<double> &rhs,
+                                  const std::vector<double> &param_young) const {
+    size_t nnode = fem.solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    size_t packed_size = fem.solid_triangle ? PACKED_SIZE_SOLID_TRIANGLE : PACKED_SIZE_ELASTIC_ROD;
+
+    // numeric: [K11] = Σ Eₑ ⋅ K̂ₑ and the identity on prescribed DOFs (the only entry of their rows)
+    values.assign(pattern->nnz(), 0.0);
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        if (fem.essential_prescribed[i]) {
+            values[pattern->row_pointers[i]] = 1.0;
+        }
+    }
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        const size_t *s = &scatter[e * packed_size];
+        const double *kk = &unit_element_matrices[e * packed_size];
+        double young = param_young[e];
+        for (size_t p = 0; p < packed_size; p++) {
+            if (s[p] != NO_ENTRY) {
+                values[s[p]] += young * kk[p];
+            }
+        }
+    }
+
+    // {rhs1} = {f1} - [K12]{u2} and {rhs2} = {u2} (see Fem2d::calculate_rhs_and_global_stiffness)
+    rhs.resize(fem.total_ndof);
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        rhs[i] = fem.essential_prescribed[i] ? fem.essential_boundary_conditions[i]
+                                             : fem.natural_boundary_conditions[i];
+    }
+    size_t m[6];
+    for (auto e : rhs_elements) {
+        uint8_t mask = fem.element_constraint_masks[e];
+        const double *kk = &unit_element_matrices[e * packed_size];
+        double young = param_young[e];
+        for (size_t k = 0; k < nnode; k++) {
+            size_t node = fem.connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+        }
+        for (size_t i = 0; i < nrow; i++) {
+            if (mask_prescribed(mask, i)) {
+                continue;
+            }
+            for (size_t j = 0; j < nrow; j++) {
+                if (mask_prescribed(mask, j)) {
+                    rhs[m[i]] -= young * packed_get(kk, nrow, i, j) * fem.essential_boundary_conditions[m[j]];
+                }
+            }
+        }
+    }
+}
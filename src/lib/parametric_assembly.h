@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "csr_upper.h"
+#include "fem2d.h"
+
+/// @brief Indicates that an element entry is not stored in the global stiffness (constrained DOF)
+const size_t NO_ENTRY = static_cast<size_t>(-1);
+
+/// @brief Reassembles the global stiffness for new element Young's moduli on a fixed sparsity pattern
+///
+/// Everything that does not depend on the Young's moduli is computed once in make_new: the sparsity
+/// pattern of the (modified) global stiffness, the position of each element entry in it, and the element
+/// stiffnesses for E = 1 (the stiffness is linear in E). The numeric reassembly is then Σ Eₑ ⋅ K̂ₑ.
+/// The values have the layout of pattern; thus, a PARDISO analysis of pattern stays valid.
+struct ParametricAssembly {
+    /// @brief The base problem (mesh, Poisson coefficients, and boundary conditions; must outlive this)
+    Fem2d &fem;
+
+    /// @brief Sparsity pattern of the (modified) global stiffness (the values hold the base problem)
+    std::unique_ptr<CsrUpper> pattern;
+
+    /// @brief Position in pattern->values of each packed element entry; NO_ENTRY if constrained
+    /// (size = packed_size * number_of_elements)
+    std::vector<size_t> scatter;
+
+    /// @brief Packed element stiffnesses for a unit Young's modulus (size = packed_size * number_of_elements)
+    std::vector<double> unit_element_matrices;
+
+    /// @brief Elements touching non-zero prescribed values (they contribute to the right-hand side)
+    std::vector<size_t> rhs_elements;
+
+    /// @brief Allocates a new assembly
+    /// @param fem The base problem; its Young's moduli must be positive
+    static std::unique_ptr<ParametricAssembly> make_new(Fem2d &fem);
+
+    /// @brief Returns a new matrix with the pattern and zero values (e.g., one per thread)
+    std::unique_ptr<CsrUpper> new_matrix() const;
+
+    /// @brief Assembles the values of the global stiffness and the right-hand side for given Young's moduli
+    /// @param values (output) the values with the layout of pattern (size = pattern->nnz())
+    /// @param rhs (output) the right-hand side (size = total_ndof)
+    /// @param param_young the Young's moduli (size = number_of_elements)
+    void assemble(std::vector<double> &values,
+                  std::vector<double> &rhs,
+                  const std::vector<double> &param_young) const;
+};
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cmath>
+
+#include "partitioning.h"
+
+#ifdef USE_METIS
+#include "metis.h"
+#endif
+
+/// @brief Assigns the elements to parts first_part .. first_part + number_of_parts - 1 recursively
+/// @note The elements are reordered in place
+inline void bisect(std::vector<size_t> &element_part,
+                   bool inertial,
+                   const std::vector<double> &centroids,
+                   std::vector<size_t>::iterator begin,
+                   std::vector<size_t>::iterator end,
+                   size_t first_part,
+                   size_t number_of_parts) {
+    if (number_of_parts == 1 || end - begin <= 1) {
+        for (auto it = begin; it != end; ++it) {
+            element_part[*it] = first_part;
+        }
+        return;
+    }
+
+    // direction of the cut
+    double direction[2] = {1.0, 0.0};
+    if (inertial) {
+        // principal axis (largest eigenvalue) of the covariance of the centroids
+        double n = static_cast<double>(end - begin);
+        double mean[2] = {0.0, 0.0};
+        for (auto it = begin; it != end; ++it) {
+            mean[0] += centroids[*it * 2] / n;
+            mean[1] += centroids[*it * 2 + 1] / n;
+        }
+        double cxx = 0.0, cyy = 0.0, cxy = 0.0;
+        for (auto it = begin; it != end; ++it) {
+            double dx = centroids[*it * 2] - mean[0];
+            double dy = centroids[*it * 2 + 1] - mean[1];
+            cxx += dx * dx;
+            cyy += dy * dy;
+            cxy += dx * dy;
+        }
+        double angle = 0.5 * atan2(2.0 * cxy, cxx - cyy);
+        direction[0] = cos(angle);
+        direction[1] = sin(angle);
+    } else {
+        // longest side of the bounding box
+        double min[2] = {centroids[*begin * 2], centroids[*begin * 2 + 1]};
+        double max[2] = {min[0], min[1]};
+        for (auto it = begin; it != end; ++it) {
+            for (size_t d = 0; d < 2; d++) {
+                min[d] = std::min(min[d], centroids[*it * 2 + d]);
+                max[d] = std::max(max[d], centroids[*it * 2 + d]);
+            }
+        }
+        if (max[1] - min[1] > max[0] - min[0]) {
+            direction[0] = 0.0;
+            direction[1] = 1.0;
+        }
+    }
+
+    // split proportionally to the number of parts on each side
+    size_t parts_left = number_of_parts / 2;
+    auto middle = begin + (end - begin) * parts_left / number_of_parts;
+    std::nth_element(begin, middle, end, [&](size_t a, size_t b) {
+        double pa = direction[0] * centroids[a * 2] + direction[1] * centroids[a * 2 + 1];
+        double pb = direction[0] * centroids[b * 2] + direction[1] * centroids[b * 2 + 1];
+        return pa < pb || (pa == pb && a < b);
+    });
+    bisect(element_part, inertial, centroids, begin, middle, first_part, parts_left);
+    bisect(element_part, inertial, centroids, middle, end, first_part + parts_left, number_of_parts - parts_left);
+}
+
+void recursive_bisection(std::vector<size_t> &element_part,
+                         bool inertial,
+                         size_t number_of_parts,
+                         const std::vector<double> &coordinates,
+                         const std::vector<size_t> &connectivity,
+                         size_t element_num_node) {
+    size_t number_of_elements = connectivity.size() / element_num_node;
+    std::vector<double> centroids(2 * number_of_elements, 0.0);
+    std::vector<size_t> elements(number_of_elements);
+    for (size_t e = 0; e < number_of_elements; e++) {
+        elements[e] = e;
+        for (size_t k = 0; k < element_num_node; k++) {
+            size_t node = connectivity[e * element_num_node + k];
+            centroids[e * 2] += coordinates[node * 2] / element_num_node;
+            centroids[e * 2 + 1] += coordinates[node * 2 + 1] / element_num_node;
+        }
+    }
+    element_part.assign(number_of_elements, 0);
+    bisect(element_part, inertial, centroids, elements.begin(), elements.end(), 0, number_of_parts);
+}
+
+void metis_partitioning(std::vector<size_t> &element_part,
+                        size_t number_of_parts,
+                        size_t number_of_nodes,
+                        const std::vector<size_t> &connectivity,
+                        size_t element_num_node) {
+#ifdef USE_METIS
+    size_t number_of_elements = connectivity.size() / element_num_node;
+    element_part.assign(number_of_elements, 0);
+    if (number_of_parts == 1) {
+        return;
+    }
+    idx_t ne = static_cast<idx_t>(number_of_elements);
+    idx_t nn = static_cast<idx_t>(number_of_nodes);
+    idx_t ncommon = element_num_node == 3 ? 2 : 1; // neighbors share an edge (triangles) or a node (rods)
+    idx_t nparts = static_cast<idx_t>(number_of_parts);
+    idx_t objval = 0;
+    std::vector<idx_t> eptr(number_of_elements + 1);
+    std::vector<idx_t> eind(connectivity.begin(), connectivity.end());
+    for (size_t e = 0; e <= number_of_elements; e++) {
+        eptr[e] = static_cast<idx_t>(e * element_num_node);
+    }
+    std::vector<idx_t> epart(number_of_elements);
+    std::vector<idx_t> npart(number_of_nodes);
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(options);
+    options[METIS_OPTION_NUMBERING] = 0;
+    int status = METIS_PartMeshDual(&ne, &nn, eptr.data(), eind.data(), NULL, NULL, &ncommon, &nparts,
+                                    NULL, options, &objval, epart.data(), npart.data());
+    if (status != METIS_OK) {
+        throw "METIS_PartMeshDual failed";
+    }
+    for (size_t e = 0; e < number_of_elements; e++) {
+        element_part[e] = static_cast<size_t>(epart[e]);
+    }
+#else
+    throw "METIS partitioning requires the library to be built with the WITH_METIS option";
+#endif
+}
+
+std::unique_ptr<MeshPartitioning> MeshPartitioning::make_new(PartitioningMethod method,
+                                                             size_t number_of_parts,
+                                                             const std::vector<double> &coordinates,
+                                                             const std::vector<size_t> &connectivity,
+                                                             size_t element_num_node) {
+    if (number_of_parts < 1) {
+        throw "MeshPartitioning requires number_of_parts ≥ 1";
+    }
+    size_t number_of_nodes = coordinates.size() / 2;
+    size_t number_of_elements = connectivity.size() / element_num_node;
+    auto partitioning = std::unique_ptr<MeshPartitioning>{new MeshPartitioning{
+        method,
+        std::vector<size_t>(),
+        std::vector<MeshPart>(number_of_parts),
+        std::vector<size_t>(),
+    }};
+    if (method == PARTITIONING_METIS) {
+        metis_partitioning(partitioning->element_part, number_of_parts, number_of_nodes, connectivity,
+                           element_num_node);
+    } else {
+        recursive_bisection(partitioning->element_part, method == PARTITIONING_INERTIAL_BISECTION,
+                            number_of_parts, coordinates, connectivity, element_num_node);
+    }
+
+    // element lists and local-to-global maps (last_part avoids duplicates within a part)
+    const size_t NONE = number_of_parts;
+    std::vector<size_t> last_part(number_of_nodes, NONE);
+    std::vector<size_t> parts_per_node(number_of_nodes, 0);
+    for (size_t e = 0; e < number_of_elements; e++) {
+        partitioning->parts[partitioning->element_part[e]].elements.push_back(e);
+    }
+    for (size_t p = 0; p < number_of_parts; p++) {
+        auto &part = partitioning->parts[p];
+        for (auto e : part.elements) {
+            for (size_t k = 0; k < element_num_node; k++) {
+                size_t node = connectivity[e * element_num_node + k];
+                if (last_part[node] != p) {
+                    last_part[node] = p;
+                    parts_per_node[node]++;
+                    part.local_to_global.push_back(node);
+                }
+            }
+        }
+        std::sort(part.local_to_global.begin(), part.local_to_global.end());
+    }
+
+    // interface nodes
+    for (size_t node = 0; node < number_of_nodes; node++) {
+        if (parts_per_node[node] > 1) {
+            partitioning->interface_nodes.push_back(node);
+        }
+    }
+    for (auto &part : partitioning->parts) {
+        for (auto node : part.local_to_global) {
+            if (parts_per_node[node] > 1) {
+                part.interface_nodes.push_back(node);
+            }
+        }
+    }
+    return partitioning;
+}
+
+double MeshPartitioning::imbalance() const {
+    size_t total = 0, largest = 0;
+    for (const auto &part : parts) {
+        total += part.elements.size();
+        largest = std::max(largest, part.elements.size());
+    }
+    if (total == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(largest) * static_cast<double>(parts.size()) / static_cast<double>(total);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+/// @brief Defines the mesh partitioning methods
+enum PartitioningMethod {
+    PARTITIONING_COORDINATE_BISECTION, // recursive bisection along the longest side of the bounding box
+    PARTITIONING_INERTIAL_BISECTION,   // recursive bisection along the principal axis of the centroids
+    PARTITIONING_METIS,                // METIS_PartMeshDual (requires the WITH_METIS option)
+};
+
+/// @brief Holds one subdomain of a mesh partitioning
+struct MeshPart {
+    /// @brief Global numbers of the elements in this part (sorted)
+    std::vector<size_t> elements;
+
+    /// @brief Maps the local to the global node number (sorted; size = number of nodes in this part)
+    std::vector<size_t> local_to_global;
+
+    /// @brief Global numbers of the nodes of this part shared with other parts (sorted)
+    std::vector<size_t> interface_nodes;
+};
+
+/// @brief Splits the elements into balanced parts with small interfaces
+///
+/// The parts are the basis for per-thread assembly, domain decomposition and parallel output.
+struct MeshPartitioning {
+    /// @brief Method used to compute the partitioning
+    PartitioningMethod method;
+
+    /// @brief Maps each element to its part (size = number_of_elements)
+    std::vector<size_t> element_part;
+
+    /// @brief Holds the parts (size = number of parts)
+    std::vector<MeshPart> parts;
+
+    /// @brief Global numbers of all nodes shared by two or more parts (sorted)
+    std::vector<size_t> interface_nodes;
+
+    /// @brief Allocates a new partitioning
+    /// @param method Partitioning method
+    /// @param number_of_parts Number of parts (≥ 1)
+    /// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    /// @param connectivity Connectivity (size = element_num_node * number_of_elements)
+    /// @param element_num_node Number of nodes per element (2 or 3)
+    static std::unique_ptr<MeshPartitioning> make_new(PartitioningMethod method,
+                                                      size_t number_of_parts,
+                                                      const std::vector<double> &coordinates,
+                                                      const std::vector<size_t> &connectivity,
+                                                      size_t element_num_node);
+
+    /// @brief Returns the largest number of elements in a part divided by the average (1.0 is perfect balance)
+    double imbalance() const;
+};
+
+/// @brief Computes the part of each element by recursive (coordinate or inertial) bisection of the centroids
+/// @param element_part Maps each element to its part (size = number_of_elements)
+void recursive_bisection(std::vector<size_t> &element_part,
+                         bool inertial,
+                         size_t number_of_parts,
+                         const std::vector<double> &coordinates,
+                         const std::vector<size_t> &connectivity,
+                         size_t element_num_node);
+
+/// @brief Computes the part of each element with METIS_PartMeshDual
+/// @note Throws an exception if the library was built without the WITH_METIS option
+void metis_partitioning(std::vector<size_t> &element_part,
+                        size_t number_of_parts,
+                        size_t number_of_nodes,
+                        const std::vector<size_t> &connectivity,
+                        size_t element_num_node);
@@ -92,7 +92,8 @@ std::unique_ptr<CoordinatesAndConnectivity> read_mesh(const std::string &filenam
 
     std::vector<double> coordinates;
     std::vector<size_t> connectivity;
-    size_t element_nnode;
+    std::vector<size_t> attributes;
+    size_t element_nnode = 3;
 
     while (fgetws(line, MAX_LINE_WIDTH, f) != NULL) {
         if (comment_or_empty_line(line)) {
@@ -163,7 +164,9 @@ std::unique_ptr<CoordinatesAndConnectivity> read_mesh(const std::string &filenam
             }
             if (connectivity.size() == 0) {
                 connectivity.resize(ncell * element_nnode);
+                attributes.resize(ncell);
             }
+            attributes[id] = att;
             connectivity[id * element_nnode] = a;
             connectivity[id * element_nnode + 1] = b;
             if (element_nnode == 3) {
@@ -195,5 +198,8 @@ std::unique_ptr<CoordinatesAndConnectivity> read_mesh(const std::string &filenam
         new CoordinatesAndConnectivity{
             coordinates,
             connectivity,
+            attributes,
+            element_nnode,
+            NULL,
         }};
 }
\ No newline at end of file
@@ -4,9 +4,32 @@
 #include <string>
 #include <vector>
 
+#include "mesh_topology.h"
+
 struct CoordinatesAndConnectivity {
     std::vector<double> coordinates;
     std::vector<size_t> connectivity;
+
+    /// @brief Attribute ID of each cell (size = number_of_elements)
+    std::vector<size_t> attributes;
+
+    /// @brief Number of nodes per element (2 for lin2; 3 for tri3)
+    size_t element_num_node;
+
+    /// @brief Holds the adjacency structures (allocated by get_topology)
+    std::unique_ptr<MeshTopology> topology;
+
+    /// @brief Returns the adjacency structures, building them on the first call
+    /// @note Call reset_topology after modifying the connectivity
+    inline const MeshTopology &get_topology() {
+        if (!topology) {
+            topology = MeshTopology::make_new(coordinates.size() / 2, connectivity, element_num_node);
+        }
+        return *topology;
+    }
+
+    /// @brief Discards the cached adjacency structures
+    inline void reset_topology() { topology.reset(); }
 };
 
 std::unique_ptr<CoordinatesAndConnectivity> read_mesh(const std::string &filename);
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "parametric_assembly.h"
+#include "reduced_order_model.h"
+#include "solver_pardiso.h"
+
+/// @brief Returns xᵀ ⋅ y
+inline double dot_product(const double *x, const double *y, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+/// @brief Calculates the eigenvalues and eigenvectors of a small symmetric matrix (cyclic Jacobi)
+/// @param a (input/output) the matrix, row-major (on return, the diagonal holds the eigenvalues)
+/// @param vectors (output) the eigenvectors by columns, row-major
+/// @param n The dimension
+inline void calculate_symmetric_eigen(std::vector<double> &a, std::vector<double> &vectors, size_t n) {
+    vectors.assign(n * n, 0.0);
+    double total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        vectors[i * n + i] = 1.0;
+        for (size_t j = 0; j < n; j++) {
+            total += a[i * n + j] * a[i * n + j];
+        }
+    }
+    for (size_t sweep = 0; sweep < 100; sweep++) {
+        double off = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = i + 1; j < n; j++) {
+                off += a[i * n + j] * a[i * n + j];
+            }
+        }
+        if (off <= 1e-30 * total) {
+            break;
+        }
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) {
+                double apq = a[p * n + q];
+                if (apq == 0.0) {
+                    continue;
+                }
+                // rotation zeroing a[p][q]: cot 2φ = (a[q][q] - a[p][p]) / (2 a[p][q]) and t = tan φ
+                double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+                for (size_t k = 0; k < n; k++) {
+                    double akp = a[k * n + p];
+                    double akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    double apk = a[p * n + k];
+                    double aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    double vkp = vectors[k * n + p];
+                    double vkq = vectors[k * n + q];
+                    vectors[k * n + p] = c * vkp - s * vkq;
+                    vectors[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+/// @brief Solves a ⋅ x = b by Cholesky factorization
+/// @param a (input/output) the symmetric matrix, row-major (overwritten by the factor)
+/// @param x (input/output) b on input; x on output
+/// @return false if the matrix is not positive-definite
+inline bool solve_cholesky(std::vector<double> &a, std::vector<double> &x, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        double d = a[j * n + j];
+        for (size_t k = 0; k < j; k++) {
+            d -= a[j * n + k] * a[j * n + k];
+        }
+        if (d <= 0.0) {
+            return false;
+        }
+        d = sqrt(d);
+        a[j * n + j] = d;
+        for (size_t i = j + 1; i < n; i++) {
+            double value = a[i * n + j];
+            for (size_t k = 0; k < j; k++) {
+                value -= a[i * n + k] * a[j * n + k];
+            }
+            a[i * n + j] = value / d;
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t k = 0; k < i; k++) {
+            x[i] -= a[i * n + k] * x[k];
+        }
+        x[i] /= a[i * n + i];
+    }
+    for (size_t i = n; i-- > 0;) {
+        for (size_t k = i + 1; k < n; k++) {
+            x[i] -= a[k * n + i] * x[k];
+        }
+        x[i] /= a[i * n + i];
+    }
+    return true;
+}
+
+/// @brief Checks that there is one positive factor per material group
+inline void check_group_factors(const ReducedOrderModel &rom, const std::vector<double> &group_factors) {
+    if (group_factors.size() != rom.number_of_groups) {
+        throw "the reduced-order model requires one factor per material group";
+    }
+    for (auto factor : group_factors) {
+        if (factor <= 0.0) {
+            throw "the material group factors must be positive";
+        }
+    }
+}
+
+/// @brief Calculates the Young's moduli μg ⋅ Eₑ of all elements
+inline void calculate_group_young(std::vector<double> &young,
+                                  const ReducedOrderModel &rom,
+                                  const std::vector<double> &group_factors) {
+    check_group_factors(rom, group_factors);
+    young.resize(rom.young_reference.size());
+    for (size_t e = 0; e < young.size(); e++) {
+        young[e] = group_factors[rom.element_groups[e]] * rom.young_reference[e];
+    }
+}
+
+std::unique_ptr<ReducedOrderModel> ReducedOrderModel::make_new(Fem2d &fem,
+                                                               const std::vector<size_t> &element_groups,
+                                                               const std::vector<std::vector<double>> &load_cases,
+                                                               const std::vector<std::vector<double>> &training_factors,
+                                                               const RomOptions &options) {
+    size_t ncell = fem.number_of_elements;
+    size_t ndof = fem.total_ndof;
+    if (element_groups.size() != ncell || ncell == 0) {
+        throw "the reduced-order model requires one group per element";
+    }
+    if (load_cases.empty() || training_factors.empty()) {
+        throw "the reduced-order model requires at least one load case and one training set";
+    }
+    for (const auto &load : load_cases) {
+        if (load.size() != ndof) {
+            throw "each load case must have one value per DOF";
+        }
+    }
+    for (size_t i = 0; i < ndof; i++) {
+        if (fem.essential_prescribed[i] && fem.essential_boundary_conditions[i] != 0.0) {
+            throw "the reduced-order model requires zero prescribed displacements";
+        }
+    }
+    size_t ngroup = *std::max_element(element_groups.begin(), element_groups.end()) + 1;
+    size_t nload = load_cases.size();
+    auto rom = std::unique_ptr<ReducedOrderModel>{new ReducedOrderModel{
+        fem,
+        element_groups,
+        ngroup,
+        nload,
+        fem.param_young, // young_reference
+        std::vector<double>(ndof * nload, 0.0),
+        std::vector<double>{}, // singular_values
+        0,                     // basis_size
+        std::vector<double>{}, // basis
+        std::vector<double>{}, // reduced_stiffness
+        std::vector<double>{}, // reduced_loads
+        std::vector<double>{}, // load_products
+        std::vector<double>{}, // load_stiffness_products
+        std::vector<double>{}, // stiffness_products
+        options.residual_tolerance,
+        0, // number_of_queries
+        0, // number_of_fallbacks
+    }};
+    for (size_t l = 0; l < nload; l++) {
+        for (size_t i = 0; i < ndof; i++) {
+            rom->load_cases[l * ndof + i] = fem.essential_prescribed[i] ? 0.0 : load_cases[l][i];
+        }
+    }
+
+    // snapshots: one factorization per training set and one solve per load case
+    auto assembly = ParametricAssembly::make_new(fem);
+    auto kk = assembly->new_matrix();
+    auto solver = SolverPardiso::make_new(*PardisoOptions::make_new());
+    size_t nsnap = training_factors.size() * nload;
+    std::vector<double> snapshots(ndof * nsnap);
+    std::vector<double> young, rhs, uu(ndof), load(ndof);
+    for (size_t t = 0; t < training_factors.size(); t++) {
+        calculate_group_young(young, *rom, training_factors[t]);
+        assembly->assemble(kk->values, rhs, young);
+        solver->factorize(*kk);
+        for (size_t l = 0; l < nload; l++) {
+            std::copy_n(&rom->load_cases[l * ndof], ndof, load.begin());
+            solver->solve(uu, load);
+            std::copy_n(uu.begin(), ndof, &snapshots[(t * nload + l) * ndof]);
+        }
+    }
+
+    // POD (method of snapshots): eigenpairs (λₖ, wₖ) of Sᵀ ⋅ S give vₖ = S ⋅ wₖ / √λₖ
+    std::vector<double> correlation(nsnap * nsnap), vectors;
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < nsnap; i++) {
+        for (size_t j = i; j < nsnap; j++) {
+            double value = dot_product(&snapshots[i * ndof], &snapshots[j * ndof], ndof);
+            correlation[i * nsnap + j] = value;
+            correlation[j * nsnap + i] = value;
+        }
+    }
+    calculate_symmetric_eigen(correlation, vectors, nsnap);
+    std::vector<size_t> order(nsnap);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return correlation[a * nsnap + a] > correlation[b * nsnap + b];
+    });
+    double total = 0.0;
+    for (auto k : order) {
+        double lambda = fmax(0.0, correlation[k * nsnap + k]);
+        rom->singular_values.push_back(sqrt(lambda));
+        total += lambda;
+    }
+    if (total <= 0.0) {
+        throw "the snapshots of the reduced-order model are all zero";
+    }
+
+    // truncation: the discarded energy (tail sum, free of cancellation) is at most tol² of the total; the
+    // eigenvalues below the round-off of Sᵀ ⋅ S are discarded as well
+    std::vector<double> tail(nsnap + 1, 0.0);
+    for (size_t k = nsnap; k-- > 0;) {
+        tail[k] = tail[k + 1] + rom->singular_values[k] * rom->singular_values[k];
+    }
+    double tolerance = options.pod_tolerance * options.pod_tolerance * total;
+    double lambda_max = rom->singular_values[0] * rom->singular_values[0];
+
+    // re-orthonormalization: Gram-Schmidt twice; nearly dependent vectors are dropped
+    std::vector<double> v(ndof);
+    for (size_t position = 0; position < nsnap; position++) {
+        size_t k = order[position];
+        double lambda = correlation[k * nsnap + k];
+        if (rom->basis_size >= options.max_basis_size || lambda <= 1e-14 * lambda_max || tail[position] <= tolerance) {
+            break;
+        }
+        std::fill(v.begin(), v.end(), 0.0);
+        for (size_t j = 0; j < nsnap; j++) {
+            double w = vectors[j * nsnap + k];
+            for (size_t i = 0; i < ndof; i++) {
+                v[i] += snapshots[j * ndof + i] * w;
+            }
+        }
+        double norm0 = sqrt(dot_product(v.data(), v.data(), ndof));
+        for (size_t pass = 0; pass < 2; pass++) {
+            for (size_t b = 0; b < rom->basis_size; b++) {
+                const double *vb = &rom->basis[b * ndof];
+                double projection = dot_product(vb, v.data(), ndof);
+                for (size_t i = 0; i < ndof; i++) {
+                    v[i] -= projection * vb[i];
+                }
+            }
+        }
+        double norm = sqrt(dot_product(v.data(), v.data(), ndof));
+        if (norm <= 1e-8 * norm0) {
+            continue;
+        }
+        for (size_t i = 0; i < ndof; i++) {
+            rom->basis.push_back(v[i] / norm);
+        }
+        rom->basis_size++;
+    }
+
+    // Kg ⋅ V for each group (the identity rows of prescribed DOFs multiply zero basis entries)
+    size_t r = rom->basis_size;
+    const auto &basis = rom->basis;
+    std::vector<double> kv(ngroup * r * ndof), column(ndof), product(ndof);
+    for (size_t g = 0; g < ngroup; g++) {
+        for (size_t e = 0; e < ncell; e++) {
+            young[e] = element_groups[e] == g ? rom->young_reference[e] : 0.0;
+        }
+        assembly->assemble(kk->values, rhs, young);
+        for (size_t j = 0; j < r; j++) {
+            std::copy_n(&basis[j * ndof], ndof, column.begin());
+            kk->multiply(product, column);
+            std::copy_n(product.begin(), ndof, &kv[(g * r + j) * ndof]);
+        }
+    }
+
+    // projections and the inner products of the residual norm
+    const auto &loads = rom->load_cases;
+    rom->reduced_stiffness.resize(ngroup * r * r);
+    rom->reduced_loads.resize(nload * r);
+    rom->load_products.resize(nload * nload);
+    rom->load_stiffness_products.resize(nload * ngroup * r);
+    rom->stiffness_products.resize(ngroup * ngroup * r * r);
+    for (size_t g = 0; g < ngroup; g++) {
+        for (size_t i = 0; i < r; i++) {
+            for (size_t j = 0; j < r; j++) {
+                rom->reduced_stiffness[(g * r + i) * r + j] =
+                    dot_product(&basis[i * ndof], &kv[(g * r + j) * ndof], ndof);
+            }
+        }
+    }
+    for (size_t l = 0; l < nload; l++) {
+        for (size_t i = 0; i < r; i++) {
+            rom->reduced_loads[l * r + i] = dot_product(&basis[i * ndof], &loads[l * ndof], ndof);
+        }
+        for (size_t k = 0; k < nload; k++) {
+            rom->load_products[l * nload + k] = dot_product(&loads[l * ndof], &loads[k * ndof], ndof);
+        }
+        for (size_t a = 0; a < ngroup * r; a++) {
+            rom->load_stiffness_products[l * ngroup * r + a] = dot_product(&loads[l * ndof], &kv[a * ndof], ndof);
+        }
+    }
+    size_t nkv = ngroup * r;
+#pragma omp parallel for schedule(dynamic)
+    for (size_t a = 0; a < nkv; a++) {
+        for (size_t b = a; b < nkv; b++) {
+            double value = dot_product(&kv[a * ndof], &kv[b * ndof], ndof);
+            rom->stiffness_products[a * nkv + b] = value;
+            rom->stiffness_products[b * nkv + a] = value;
+        }
+    }
+    return rom;
+}
+
+double ReducedOrderModel::solve_reduced(std::vector<double> &reduced_uu,
+                                        const std::vector<double> &group_factors,
+                                        const std::vector<double> &load_factors) const {
+    if (group_factors.size() != number_of_groups || load_factors.size() != number_of_load_cases) {
+        throw "solve_reduced requires one factor per material group and per load case";
+    }
+    size_t r = basis_size;
+    std::vector<double> a(r * r, 0.0);
+    reduced_uu.assign(r, 0.0);
+    for (size_t g = 0; g < number_of_groups; g++) {
+        for (size_t p = 0; p < r * r; p++) {
+            a[p] += group_factors[g] * reduced_stiffness[g * r * r + p];
+        }
+    }
+    for (size_t l = 0; l < number_of_load_cases; l++) {
+        for (size_t i = 0; i < r; i++) {
+            reduced_uu[i] += load_factors[l] * reduced_loads[l * r + i];
+        }
+    }
+    if (!solve_cholesky(a, reduced_uu, r)) {
+        return INFINITY;
+    }
+
+    // ‖f - K ⋅ V ⋅ ur‖² = fᵀ f - 2 Σ θl μg ur ⋅ (flᵀ Kg V) + Σ μg μh urᵀ (Kg V)ᵀ (Kh V) ur
+    double ff = 0.0;
+    for (size_t l = 0; l < number_of_load_cases; l++) {
+        for (size_t k = 0; k < number_of_load_cases; k++) {
+            ff += load_factors[l] * load_factors[k] * load_products[l * number_of_load_cases + k];
+        }
+    }
+    if (ff <= 0.0) {
+        return 0.0;
+    }
+    size_t nkv = number_of_groups * r;
+    double cross = 0.0;
+    for (size_t l = 0; l < number_of_load_cases; l++) {
+        for (size_t g = 0; g < number_of_groups; g++) {
+            const double *lkv = &load_stiffness_products[l * nkv + g * r];
+            cross += load_factors[l] * group_factors[g] * dot_product(lkv, reduced_uu.data(), r);
+        }
+    }
+    double quadratic = 0.0;
+    for (size_t g = 0; g < number_of_groups; g++) {
+        for (size_t h = 0; h < number_of_groups; h++) {
+            double sum = 0.0;
+            for (size_t i = 0; i < r; i++) {
+                const double *row = &stiffness_products[(g * r + i) * nkv + h * r];
+                sum += reduced_uu[i] * dot_product(row, reduced_uu.data(), r);
+            }
+            quadratic += group_factors[g] * group_factors[h] * sum;
+        }
+    }
+    return sqrt(fmax(0.0, ff - 2.0 * cross + quadratic) / ff);
+}
+
+void ReducedOrderModel::expand(std::vector<double> &uu, const std::vector<double> &reduced_uu) const {
+    size_t ndof = fem.total_ndof;
+    uu.resize(ndof);
+#pragma omp parallel for
+    for (size_t i = 0; i < ndof; i++) {
+        double value = 0.0;
+        for (size_t j = 0; j < basis_size; j++) {
+            value += basis[j * ndof + i] * reduced_uu[j];
+        }
+        uu[i] = value;
+    }
+}
+
+RomQueryResult ReducedOrderModel::query(std::vector<double> &uu,
+                                        const std::vector<double> &group_factors,
+                                        const std::vector<double> &load_factors) {
+    check_group_factors(*this, group_factors);
+    number_of_queries++;
+    std::vector<double> reduced_uu;
+    double indicator = solve_reduced(reduced_uu, group_factors, load_factors);
+    if (indicator <= residual_tolerance) {
+        expand(uu, reduced_uu);
+        return RomQueryResult{true, indicator};
+    }
+
+    // fallback: the full problem (the stiffness is kept by fem while the materials do not change)
+    number_of_fallbacks++;
+    std::vector<double> young;
+    calculate_group_young(young, *this, group_factors);
+    if (young != fem.param_young) {
+        fem.set_param_young(young);
+    }
+    size_t ndof = fem.total_ndof;
+    for (size_t i = 0; i < ndof; i++) {
+        double value = 0.0;
+        for (size_t l = 0; l < number_of_load_cases; l++) {
+            value += load_factors[l] * load_cases[l * ndof + i];
+        }
+        fem.natural_boundary_conditions[i] = value;
+    }
+    fem.mark_dirty(DIRTY_NATURAL_VALUES);
+    fem.solve();
+    uu = fem.uu;
+    return RomQueryResult{false, indicator};
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "fem2d.h"
+
+/// @brief Holds the options of the reduced-order model
+struct RomOptions {
+    /// @brief POD truncation: the discarded snapshot energy is at most pod_tolerance² of the total
+    double pod_tolerance;
+
+    /// @brief Maximum number of basis vectors
+    size_t max_basis_size;
+
+    /// @brief Error indicator (relative residual) above which query falls back to the full solve
+    double residual_tolerance;
+
+    /// @brief Allocates a new RomOptions structure with default values
+    inline static std::unique_ptr<RomOptions> make_new() {
+        return std::unique_ptr<RomOptions>{new RomOptions{
+            1e-7, // pod_tolerance
+            50,   // max_basis_size
+            1e-3, // residual_tolerance
+        }};
+    }
+};
+
+/// @brief Holds the outcome of one query of the reduced-order model
+struct RomQueryResult {
+    /// @brief Indicates that the reduced solution was accepted (false means the full problem was solved)
+    bool reduced;
+
+    /// @brief Error indicator of the reduced solution: ‖f - K ⋅ V ⋅ ur‖ / ‖f‖ (free DOFs)
+    double error_indicator;
+};
+
+/// @brief Implements a projection-based (POD-Galerkin) reduced-order model with affine parameters
+///
+/// The elements are split into material groups, and the Young's modulus of element e in group g is
+/// μg ⋅ Eₑ, where Eₑ are the moduli of the problem given to make_new; the loads are combinations
+/// Σ θl ⋅ fl of given load cases. Hence, K(μ) = Σ μg ⋅ Kg and f(θ) = Σ θl ⋅ fl are affine.
+///
+/// Offline (make_new), the full problem is solved for each training set of factors μ and every load case
+/// (one factorization per μ; fixed-pattern reassembly with ParametricAssembly), the POD basis V is computed
+/// from the snapshots with the method of snapshots, and Vᵀ ⋅ Kg ⋅ V, Vᵀ ⋅ fl, and the inner products needed
+/// by the residual norm are stored. Online (solve_reduced), the dense reduced system Σ μg ⋅ (Vᵀ Kg V) ⋅ ur =
+/// Σ θl ⋅ (Vᵀ fl) is solved by Cholesky, and the residual norm is evaluated from the stored inner products;
+/// neither depends on the number of DOFs. query expands uu = V ⋅ ur and falls back to fem.solve if the
+/// indicator exceeds the tolerance.
+///
+/// @note The prescribed displacements must be zero (the basis vanishes on the prescribed DOFs).
+struct ReducedOrderModel {
+    /// @brief The full problem (mesh, Poisson coefficients, and boundary conditions; used by the fallback)
+    Fem2d &fem;
+
+    /// @brief Group of each element (size = number_of_elements)
+    std::vector<size_t> element_groups;
+
+    /// @brief Number of material groups
+    size_t number_of_groups;
+
+    /// @brief Number of load cases
+    size_t number_of_load_cases;
+
+    /// @brief Young's moduli Eₑ of the reference problem (size = number_of_elements)
+    std::vector<double> young_reference;
+
+    /// @brief The load cases fl, zero on prescribed DOFs (size = total_ndof * number_of_load_cases)
+    std::vector<double> load_cases;
+
+    /// @brief Square roots of the eigenvalues of the snapshot correlation matrix (decreasing)
+    std::vector<double> singular_values;
+
+    /// @brief Number of basis vectors r
+    size_t basis_size;
+
+    /// @brief Orthonormal basis V stored by columns (size = total_ndof * basis_size)
+    std::vector<double> basis;
+
+    /// @brief Vᵀ ⋅ Kg ⋅ V of each group, row-major (size = number_of_groups * r * r)
+    std::vector<double> reduced_stiffness;
+
+    /// @brief Vᵀ ⋅ fl of each load case (size = number_of_load_cases * r)
+    std::vector<double> reduced_loads;
+
+    /// @brief flᵀ ⋅ fk (size = number_of_load_cases²)
+    std::vector<double> load_products;
+
+    /// @brief flᵀ ⋅ (Kg ⋅ V) (size = number_of_load_cases * number_of_groups * r)
+    std::vector<double> load_stiffness_products;
+
+    /// @brief (Kg ⋅ V)ᵀ ⋅ (Kh ⋅ V) (size = number_of_groups² * r²)
+    std::vector<double> stiffness_products;
+
+    /// @brief The error indicator above which query falls back to the full solve
+    double residual_tolerance;
+
+    /// @brief Number of calls to query
+    size_t number_of_queries;
+
+    /// @brief Number of queries solved with the full problem
+    size_t number_of_fallbacks;
+
+    /// @brief Builds the model (offline stage)
+    /// @param fem The full problem; its Young's moduli are the reference moduli Eₑ
+    /// @param element_groups Group of each element; the groups are 0, 1, ..., max (size = number_of_elements)
+    /// @param load_cases The load cases fl; the entries at prescribed DOFs are ignored (each of size total_ndof)
+    /// @param training_factors The training sets of group factors μ (each of size number_of_groups)
+    /// @param options The options
+    static std::unique_ptr<ReducedOrderModel> make_new(Fem2d &fem,
+                                                       const std::vector<size_t> &element_groups,
+                                                       const std::vector<std::vector<double>> &load_cases,
+                                                       const std::vector<std::vector<double>> &training_factors,
+                                                       const RomOptions &options);
+
+    /// @brief Solves the reduced system (online stage; no work proportional to the number of DOFs)
+    /// @param reduced_uu (output) the reduced coordinates ur (size = basis_size)
+    /// @param group_factors The factors μ (size = number_of_groups)
+    /// @param load_factors The factors θ (size = number_of_load_cases)
+    /// @return The error indicator ‖f - K ⋅ V ⋅ ur‖ / ‖f‖ (infinity if the reduced system is not positive-definite)
+    double solve_reduced(std::vector<double> &reduced_uu,
+                         const std::vector<double> &group_factors,
+                         const std::vector<double> &load_factors) const;
+
+    /// @brief Calculates uu = V ⋅ ur
+    void expand(std::vector<double> &uu, const std::vector<double> &reduced_uu) const;
+
+    /// @brief Solves with the reduced model and falls back to fem.solve if the error indicator is too large
+    /// @param uu (output) the displacements (size = total_ndof)
+    /// @param group_factors The factors μ (size = number_of_groups)
+    /// @param load_factors The factors θ (size = number_of_load_cases)
+    /// @note The fallback sets the Young's moduli and natural boundary conditions of fem; the factorization
+    ///       is reused by fem.solve while only the load factors change (see Fem2d::dirty)
+    RomQueryResult query(std::vector<double> &uu,
+                         const std::vector<double> &group_factors,
+                         const std::vector<double> &load_factors);
+};
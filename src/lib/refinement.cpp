@@ -0,0 +1,205 @@
+#include <algorithm>
+
+#include "refinement.h"
+
+std::unique_ptr<CoordinatesAndConnectivity> refine_uniformly(CoordinatesAndConnectivity &mesh) {
+    if (mesh.element_num_node != 2 && mesh.element_num_node != 3) {
+        throw "refine_uniformly works with lin2 and tri3 only";
+    }
+    const auto &topology = mesh.get_topology();
+    size_t nnode = mesh.element_num_node;
+    size_t npoint = mesh.coordinates.size() / 2;
+    size_t ncell = mesh.connectivity.size() / nnode;
+    size_t nedge = topology.number_of_edges();
+    size_t nchild = nnode == 3 ? 4 : 2;
+    bool with_attributes = mesh.attributes.size() == ncell;
+
+    auto fine = std::unique_ptr<CoordinatesAndConnectivity>{new CoordinatesAndConnectivity{
+        std::vector<double>((npoint + nedge) * 2),
+        std::vector<size_t>(nchild * ncell * nnode),
+        std::vector<size_t>(with_attributes ? nchild * ncell : 0),
+        nnode,
+        NULL, // topology
+    }};
+
+    // old nodes followed by the midpoints of the edges
+#pragma omp parallel for
+    for (size_t p = 0; p < npoint * 2; p++) {
+        fine->coordinates[p] = mesh.coordinates[p];
+    }
+#pragma omp parallel for
+    for (size_t i = 0; i < nedge; i++) {
+        size_t a = topology.edges[i * 2];
+        size_t b = topology.edges[i * 2 + 1];
+        fine->coordinates[(npoint + i) * 2] = (mesh.coordinates[a * 2] + mesh.coordinates[b * 2]) / 2.0;
+        fine->coordinates[(npoint + i) * 2 + 1] = (mesh.coordinates[a * 2 + 1] + mesh.coordinates[b * 2 + 1]) / 2.0;
+    }
+
+    // children
+#pragma omp parallel for
+    for (size_t e = 0; e < ncell; e++) {
+        const size_t *c = &mesh.connectivity[e * nnode];
+        size_t *f = &fine->connectivity[e * nchild * nnode];
+        if (nnode == 3) {
+            // local edge k connects the nodes k and (k + 1) % 3
+            size_t mab = npoint + topology.element_edges[e * 3];
+            size_t mbc = npoint + topology.element_edges[e * 3 + 1];
+            size_t mca = npoint + topology.element_edges[e * 3 + 2];
+            size_t children[12] = {c[0], mab, mca, mab, c[1], mbc, mca, mbc, c[2], mab, mbc, mca};
+            for (size_t k = 0; k < 12; k++) {
+                f[k] = children[k];
+            }
+        } else {
+            size_t mid = npoint + topology.element_edges[e];
+            f[0] = c[0];
+            f[1] = mid;
+            f[2] = mid;
+            f[3] = c[1];
+        }
+        if (with_attributes) {
+            for (size_t k = 0; k < nchild; k++) {
+                fine->attributes[e * nchild + k] = mesh.attributes[e];
+            }
+        }
+    }
+    return fine;
+}
+
+std::unique_ptr<CoordinatesAndConnectivity> refine_uniformly(CoordinatesAndConnectivity &mesh, size_t levels) {
+    if (levels == 0) {
+        return std::unique_ptr<CoordinatesAndConnectivity>{new CoordinatesAndConnectivity{
+            mesh.coordinates,
+            mesh.connectivity,
+            mesh.attributes,
+            mesh.element_num_node,
+            NULL, // topology
+        }};
+    }
+    auto fine = refine_uniformly(mesh);
+    for (size_t level = 1; level < levels; level++) {
+        fine = refine_uniformly(*fine);
+    }
+    return fine;
+}
+
+std::unique_ptr<CoordinatesAndConnectivity> refine_marked(CoordinatesAndConnectivity &mesh,
+                                                          const std::vector<bool> &marked,
+                                                          std::vector<size_t> *parents) {
+    if (mesh.element_num_node != 3) {
+        throw "refine_marked works with tri3 only";
+    }
+    const auto &topology = mesh.get_topology();
+    size_t npoint = mesh.coordinates.size() / 2;
+    size_t ncell = mesh.connectivity.size() / 3;
+    size_t nedge = topology.number_of_edges();
+    if (marked.size() != ncell) {
+        throw "refine_marked requires one flag per element";
+    }
+    bool with_attributes = mesh.attributes.size() == ncell;
+
+    // split edges of the red triangles and closure (two or three split edges => red)
+    std::vector<char> split(nedge, 0);
+    std::vector<size_t> queue;
+    for (size_t e = 0; e < ncell; e++) {
+        if (marked[e]) {
+            queue.push_back(e);
+        }
+    }
+    while (!queue.empty()) {
+        size_t e = queue.back();
+        queue.pop_back();
+        for (size_t k = 0; k < 3; k++) {
+            size_t edge = topology.element_edges[e * 3 + k];
+            if (split[edge]) {
+                continue;
+            }
+            split[edge] = 1;
+            // the neighbor across this edge may now have two split edges
+            for (size_t s = 0; s < 2; s++) {
+                size_t f = topology.edge_elements[edge * 2 + s];
+                if (f == NO_ELEMENT || f == e) {
+                    continue;
+                }
+                size_t count = 0;
+                for (size_t kk = 0; kk < 3; kk++) {
+                    count += split[topology.element_edges[f * 3 + kk]];
+                }
+                if (count == 2) {
+                    queue.push_back(f);
+                }
+            }
+        }
+    }
+
+    // new node numbers (in the order of the edges) and number of children of each element
+    std::vector<size_t> edge_node(nedge, 0);
+    size_t nnew = 0;
+    for (size_t i = 0; i < nedge; i++) {
+        if (split[i]) {
+            edge_node[i] = npoint + nnew++;
+        }
+    }
+    std::vector<size_t> first_child(ncell + 1, 0);
+    for (size_t e = 0; e < ncell; e++) {
+        size_t count = 0;
+        for (size_t k = 0; k < 3; k++) {
+            count += split[topology.element_edges[e * 3 + k]];
+        }
+        first_child[e + 1] = first_child[e] + (count == 3 ? 4 : (count == 1 ? 2 : 1));
+    }
+    size_t nchild = first_child[ncell];
+
+    auto fine = std::unique_ptr<CoordinatesAndConnectivity>{new CoordinatesAndConnectivity{
+        std::vector<double>((npoint + nnew) * 2),
+        std::vector<size_t>(nchild * 3),
+        std::vector<size_t>(with_attributes ? nchild : 0),
+        3,
+        NULL, // topology
+    }};
+    if (parents != NULL) {
+        parents->resize(nchild);
+    }
+    std::copy(mesh.coordinates.begin(), mesh.coordinates.end(), fine->coordinates.begin());
+#pragma omp parallel for
+    for (size_t i = 0; i < nedge; i++) {
+        if (split[i]) {
+            size_t a = topology.edges[i * 2];
+            size_t b = topology.edges[i * 2 + 1];
+            fine->coordinates[edge_node[i] * 2] = (mesh.coordinates[a * 2] + mesh.coordinates[b * 2]) / 2.0;
+            fine->coordinates[edge_node[i] * 2 + 1] = (mesh.coordinates[a * 2 + 1] + mesh.coordinates[b * 2 + 1]) / 2.0;
+        }
+    }
+
+#pragma omp parallel for
+    for (size_t e = 0; e < ncell; e++) {
+        const size_t *c = &mesh.connectivity[e * 3];
+        size_t *f = &fine->connectivity[first_child[e] * 3];
+        size_t count = first_child[e + 1] - first_child[e];
+        if (count == 4) {
+            size_t mab = edge_node[topology.element_edges[e * 3]];
+            size_t mbc = edge_node[topology.element_edges[e * 3 + 1]];
+            size_t mca = edge_node[topology.element_edges[e * 3 + 2]];
+            size_t children[12] = {c[0], mab, mca, mab, c[1], mbc, mca, mbc, c[2], mab, mbc, mca};
+            std::copy(children, children + 12, f);
+        } else if (count == 2) {
+            size_t k = 0;
+            while (!split[topology.element_edges[e * 3 + k]]) {
+                k++;
+            }
+            size_t m = edge_node[topology.element_edges[e * 3 + k]];
+            size_t children[6] = {c[k], m, c[(k + 2) % 3], m, c[(k + 1) % 3], c[(k + 2) % 3]};
+            std::copy(children, children + 6, f);
+        } else {
+            std::copy(c, c + 3, f);
+        }
+        for (size_t i = first_child[e]; i < first_child[e + 1]; i++) {
+            if (with_attributes) {
+                fine->attributes[i] = mesh.attributes[e];
+            }
+            if (parents != NULL) {
+                (*parents)[i] = e;
+            }
+        }
+    }
+    return fine;
+}
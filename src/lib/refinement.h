@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "read_mesh.h"
+
+/// @brief Refines a mesh uniformly by splitting every triangle into four and every rod into two
+///
+/// The midpoints are shared through the unique edges of the mesh topology; hence, the refined mesh is
+/// conforming. The numbering is deterministic (independent of the number of threads):
+///
+/// * nodes 0 ≤ p < npoint keep their coordinates, and node npoint + i is the midpoint of edge i
+///   of mesh.get_topology() (this gives the prolongation operator of a mesh hierarchy)
+/// * the children of element e are (4 e, ..., 4 e + 3) for triangles or (2 e, 2 e + 1) for rods,
+///   and they inherit the attribute of e
+///
+/// The triangle (a, b, c) with midpoints (mab, mbc, mca) yields (a, mab, mca), (mab, b, mbc),
+/// (mca, mbc, c), and (mab, mbc, mca); thus, the orientation is preserved. Curved boundaries are
+/// not recovered: the new boundary nodes lie on the chords.
+///
+/// @param mesh The coarse mesh (its topology is built if not available yet)
+/// @return The refined mesh (without topology)
+std::unique_ptr<CoordinatesAndConnectivity> refine_uniformly(CoordinatesAndConnectivity &mesh);
+
+/// @brief Refines a mesh uniformly a number of times (see refine_uniformly)
+/// @param levels Number of refinements (0 returns a copy of the mesh)
+std::unique_ptr<CoordinatesAndConnectivity> refine_uniformly(CoordinatesAndConnectivity &mesh, size_t levels);
+
+/// @brief Refines the marked triangles (red) and closes the mesh with green bisections
+///
+/// The marked triangles are split into four (see refine_uniformly). To keep the mesh conforming, a
+/// triangle with two or three split edges is also split into four; this is repeated until no triangle
+/// has two split edges. The remaining triangles with one split edge k (nodes k → k + 1) are bisected
+/// (green) from the opposite vertex into (k, m, k + 2) and (m, k + 1, k + 2).
+///
+/// The nodes 0 ≤ p < npoint are kept; the midpoints follow in the order of the edges of the topology.
+/// The children of each element are contiguous and inherit its attribute. Green triangles are not
+/// undone in later refinements; thus, repeated refinement near the same green triangles may reduce
+/// the quality of the mesh.
+///
+/// @param mesh The mesh of triangles (its topology is built if not available yet)
+/// @param marked Flags of the triangles to be split into four (size = number_of_elements)
+/// @param parents (output, optional) the parent of each refined element (size = new number of elements)
+/// @return The refined mesh (without topology)
+std::unique_ptr<CoordinatesAndConnectivity> refine_marked(CoordinatesAndConnectivity &mesh,
+                                                          const std::vector<bool> &marked,
+                                                          std::vector<size_t> *parents = NULL);
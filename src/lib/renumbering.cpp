@@ -0,0 +1,484 @@
+#include <algorithm>
+
+#include "renumbering.h"
+
+/// @brief Holds the scratch arrays of the breadth-first searches
+struct BfsWorkspace {
+    /// @brief stamp[node] == current means that node has been visited in the current search
+    std::vector<size_t> stamp;
+
+    /// @brief Identifies the current search
+    size_t current;
+
+    /// @brief Holds the visited nodes, level by level
+    std::vector<size_t> queue;
+};
+
+/// @brief Visits the nodes of a subdomain (label[node] == value) level by level starting at root
+/// @return The number of levels; the nodes of the last level are ws.queue[last_level_start..]
+inline size_t breadth_first_levels(BfsWorkspace &ws,
+                                   const NodeGraph &graph,
+                                   const std::vector<size_t> &label,
+                                   size_t value,
+                                   size_t root,
+                                   size_t &last_level_start) {
+    ws.current++;
+    ws.queue.clear();
+    ws.queue.push_back(root);
+    ws.stamp[root] = ws.current;
+    size_t levels = 0;
+    size_t level_start = 0;
+    while (level_start < ws.queue.size()) {
+        levels++;
+        last_level_start = level_start;
+        size_t level_end = ws.queue.size();
+        for (size_t k = level_start; k < level_end; k++) {
+            size_t u = ws.queue[k];
+            for (size_t p = graph.pointers[u]; p < graph.pointers[u + 1]; p++) {
+                size_t v = graph.adjacency[p];
+                if (label[v] == value && ws.stamp[v] != ws.current) {
+                    ws.stamp[v] = ws.current;
+                    ws.queue.push_back(v);
+                }
+            }
+        }
+        level_start = level_end;
+    }
+    return levels;
+}
+
+/// @brief Finds a pseudo-peripheral node (George-Liu) in the component of start
+inline size_t pseudo_peripheral_node(BfsWorkspace &ws,
+                                     const NodeGraph &graph,
+                                     const std::vector<size_t> &label,
+                                     size_t value,
+                                     size_t start) {
+    size_t root = start;
+    size_t last_level_start = 0;
+    size_t levels = breadth_first_levels(ws, graph, label, value, root, last_level_start);
+    for (size_t iteration = 0; iteration < 8; iteration++) {
+        size_t candidate = ws.queue[last_level_start];
+        for (size_t k = last_level_start + 1; k < ws.queue.size(); k++) {
+            if (graph.degree(ws.queue[k]) < graph.degree(candidate)) {
+                candidate = ws.queue[k];
+            }
+        }
+        size_t candidate_levels = breadth_first_levels(ws, graph, label, value, candidate, last_level_start);
+        if (candidate_levels <= levels) {
+            break;
+        }
+        root = candidate;
+        levels = candidate_levels;
+    }
+    return root;
+}
+
+/// @brief Appends the reverse Cuthill-McKee ordering of the subdomain nodes (label[node] == value) to order
+inline void append_reverse_cuthill_mckee(std::vector<size_t> &order,
+                                         std::vector<bool> &placed,
+                                         BfsWorkspace &ws,
+                                         const NodeGraph &graph,
+                                         const std::vector<size_t> &nodes,
+                                         const std::vector<size_t> &label,
+                                         size_t value) {
+    size_t start = order.size();
+    auto by_degree = [&graph](size_t a, size_t b) { return graph.degree(a) < graph.degree(b); };
+    for (auto node : nodes) {
+        if (placed[node]) {
+            continue;
+        }
+        // Cuthill-McKee on the component of node (order is also the queue)
+        size_t root = pseudo_peripheral_node(ws, graph, label, value, node);
+        placed[root] = true;
+        size_t k = order.size();
+        order.push_back(root);
+        for (; k < order.size(); k++) {
+            size_t u = order[k];
+            size_t neighbors_start = order.size();
+            for (size_t p = graph.pointers[u]; p < graph.pointers[u + 1]; p++) {
+                size_t v = graph.adjacency[p];
+                if (label[v] == value && !placed[v]) {
+                    placed[v] = true;
+                    order.push_back(v);
+                }
+            }
+            std::stable_sort(order.begin() + neighbors_start, order.end(), by_degree);
+        }
+    }
+    std::reverse(order.begin() + start, order.end());
+}
+
+std::unique_ptr<NodeGraph> NodeGraph::make_new(size_t number_of_nodes,
+                                               const std::vector<size_t> &connectivity,
+                                               size_t element_num_node) {
+    size_t number_of_elements = connectivity.size() / element_num_node;
+
+    // count the (possibly repeated) neighbors
+    std::vector<size_t> counts(number_of_nodes + 1, 0);
+    for (size_t e = 0; e < number_of_elements; e++) {
+        for (size_t k = 0; k < element_num_node; k++) {
+            counts[connectivity[e * element_num_node + k] + 1] += element_num_node - 1;
+        }
+    }
+    for (size_t i = 0; i < number_of_nodes; i++) {
+        counts[i + 1] += counts[i];
+    }
+    std::vector<size_t> position(counts.begin(), counts.end() - 1);
+    std::vector<size_t> neighbors(counts[number_of_nodes]);
+    for (size_t e = 0; e < number_of_elements; e++) {
+        const size_t *nodes = &connectivity[e * element_num_node];
+        for (size_t a = 0; a < element_num_node; a++) {
+            for (size_t b = 0; b < element_num_node; b++) {
+                if (a != b) {
+                    neighbors[position[nodes[a]]++] = nodes[b];
+                }
+            }
+        }
+    }
+
+    // sort each row and remove duplicates
+    auto graph = std::unique_ptr<NodeGraph>{new NodeGraph{
+        std::vector<size_t>(number_of_nodes + 1, 0),
+        std::vector<size_t>(),
+    }};
+    graph->adjacency.reserve(counts[number_of_nodes]);
+    for (size_t i = 0; i < number_of_nodes; i++) {
+        auto begin = neighbors.begin() + counts[i];
+        auto end = neighbors.begin() + counts[i + 1];
+        std::sort(begin, end);
+        end = std::unique(begin, end);
+        graph->adjacency.insert(graph->adjacency.end(), begin, end);
+        graph->pointers[i + 1] = graph->adjacency.size();
+    }
+    return graph;
+}
+
+std::unique_ptr<NodeGraph> NodeGraph::make_from_topology(const MeshTopology &topology) {
+    size_t number_of_nodes = topology.number_of_nodes;
+    size_t number_of_edges = topology.number_of_edges();
+    auto graph = std::unique_ptr<NodeGraph>{new NodeGraph{
+        std::vector<size_t>(number_of_nodes + 1, 0),
+        std::vector<size_t>(2 * number_of_edges),
+    }};
+    for (size_t i = 0; i < 2 * number_of_edges; i++) {
+        graph->pointers[topology.edges[i] + 1]++;
+    }
+    for (size_t n = 0; n < number_of_nodes; n++) {
+        graph->pointers[n + 1] += graph->pointers[n];
+    }
+    // the edges are sorted by (a, b); thus, visiting them in order yields sorted rows:
+    // the neighbors a < n of node n come first (increasing a), then the neighbors b > n (increasing b)
+    std::vector<size_t> position(graph->pointers.begin(), graph->pointers.end() - 1);
+    for (size_t i = 0; i < number_of_edges; i++) {
+        size_t a = topology.edges[i * 2];
+        size_t b = topology.edges[i * 2 + 1];
+        graph->adjacency[position[b]++] = a;
+    }
+    for (size_t i = 0; i < number_of_edges; i++) {
+        size_t a = topology.edges[i * 2];
+        size_t b = topology.edges[i * 2 + 1];
+        graph->adjacency[position[a]++] = b;
+    }
+    return graph;
+}
+
+size_t NodeGraph::bandwidth(const std::vector<size_t> &old_to_new) const {
+    size_t result = 0;
+    size_t n = number_of_nodes();
+    for (size_t i = 0; i < n; i++) {
+        size_t new_i = old_to_new.empty() ? i : old_to_new[i];
+        for (size_t p = pointers[i]; p < pointers[i + 1]; p++) {
+            size_t new_j = old_to_new.empty() ? adjacency[p] : old_to_new[adjacency[p]];
+            result = std::max(result, new_i > new_j ? new_i - new_j : new_j - new_i);
+        }
+    }
+    return result;
+}
+
+std::vector<size_t> reverse_cuthill_mckee(const NodeGraph &graph) {
+    size_t n = graph.number_of_nodes();
+    std::vector<size_t> nodes(n);
+    for (size_t i = 0; i < n; i++) {
+        nodes[i] = i;
+    }
+    std::vector<size_t> label(n, 0);
+    std::vector<bool> placed(n, false);
+    BfsWorkspace ws{std::vector<size_t>(n, 0), 0, std::vector<size_t>()};
+    std::vector<size_t> order;
+    order.reserve(n);
+    append_reverse_cuthill_mckee(order, placed, ws, graph, nodes, label, 0);
+    return order;
+}
+
+/// @brief Orders the subdomain nodes recursively: both halves first, then the separator
+/// @note All nodes must have label[node] == value on entry; the labels are changed
+inline void dissect(std::vector<size_t> &order,
+                    std::vector<bool> &placed,
+                    BfsWorkspace &ws,
+                    std::vector<size_t> &label,
+                    size_t &next_label,
+                    const NodeGraph &graph,
+                    const std::vector<double> &coordinates,
+                    std::vector<size_t> &nodes,
+                    size_t value,
+                    size_t leaf_size) {
+    if (nodes.size() <= leaf_size) {
+        append_reverse_cuthill_mckee(order, placed, ws, graph, nodes, label, value);
+        return;
+    }
+
+    // split at the median along the longest side of the bounding box
+    double min[2] = {coordinates[nodes[0] * 2], coordinates[nodes[0] * 2 + 1]};
+    double max[2] = {min[0], min[1]};
+    for (auto node : nodes) {
+        for (size_t d = 0; d < 2; d++) {
+            min[d] = std::min(min[d], coordinates[node * 2 + d]);
+            max[d] = std::max(max[d], coordinates[node * 2 + d]);
+        }
+    }
+    size_t axis = max[0] - min[0] >= max[1] - min[1] ? 0 : 1;
+    size_t half = nodes.size() / 2;
+    std::nth_element(nodes.begin(), nodes.begin() + half, nodes.end(), [&](size_t a, size_t b) {
+        return coordinates[a * 2 + axis] < coordinates[b * 2 + axis];
+    });
+    size_t value_left = next_label++;
+    size_t value_right = next_label++;
+    for (size_t k = 0; k < nodes.size(); k++) {
+        label[nodes[k]] = k < half ? value_left : value_right;
+    }
+
+    // the separator consists of the left nodes connected to the right half
+    std::vector<size_t> left, right(nodes.begin() + half, nodes.end()), separator;
+    for (size_t k = 0; k < half; k++) {
+        size_t u = nodes[k];
+        bool on_interface = false;
+        for (size_t p = graph.pointers[u]; p < graph.pointers[u + 1]; p++) {
+            if (label[graph.adjacency[p]] == value_right) {
+                on_interface = true;
+                break;
+            }
+        }
+        if (on_interface) {
+            separator.push_back(u);
+        } else {
+            left.push_back(u);
+        }
+    }
+    if (left.empty()) {
+        // degenerate split (e.g., coincident coordinates)
+        for (auto node : nodes) {
+            label[node] = value;
+        }
+        append_reverse_cuthill_mckee(order, placed, ws, graph, nodes, label, value);
+        return;
+    }
+    size_t value_separator = next_label++;
+    for (auto node : separator) {
+        label[node] = value_separator;
+    }
+    nodes.clear();
+    nodes.shrink_to_fit();
+    dissect(order, placed, ws, label, next_label, graph, coordinates, left, value_left, leaf_size);
+    dissect(order, placed, ws, label, next_label, graph, coordinates, right, value_right, leaf_size);
+    append_reverse_cuthill_mckee(order, placed, ws, graph, separator, label, value_separator);
+}
+
+std::vector<size_t> nested_dissection(const NodeGraph &graph, const std::vector<double> &coordinates,
+                                      size_t leaf_size) {
+    size_t n = graph.number_of_nodes();
+    if (coordinates.size() != 2 * n) {
+        throw "nested_dissection requires coordinates.size() == 2 * number_of_nodes";
+    }
+    std::vector<size_t> nodes(n);
+    for (size_t i = 0; i < n; i++) {
+        nodes[i] = i;
+    }
+    std::vector<size_t> label(n, 0);
+    size_t next_label = 1;
+    std::vector<bool> placed(n, false);
+    BfsWorkspace ws{std::vector<size_t>(n, 0), 0, std::vector<size_t>()};
+    std::vector<size_t> order;
+    order.reserve(n);
+    if (n > 0) {
+        dissect(order, placed, ws, label, next_label, graph, coordinates, nodes, 0, std::max(leaf_size, size_t(1)));
+    }
+    return order;
+}
+
+std::unique_ptr<NodeRenumbering> NodeRenumbering::make_new(RenumberingMethod method,
+                                                           const std::vector<double> &coordinates,
+                                                           const std::vector<size_t> &connectivity,
+                                                           size_t element_num_node,
+                                                           const MeshTopology *topology) {
+    size_t number_of_nodes = coordinates.size() / 2;
+    auto graph = topology != NULL ? NodeGraph::make_from_topology(*topology)
+                                  : NodeGraph::make_new(number_of_nodes, connectivity, element_num_node);
+    auto renumbering = std::unique_ptr<NodeRenumbering>{new NodeRenumbering{
+        method,
+        std::vector<size_t>(),
+        std::vector<size_t>(number_of_nodes),
+        0,
+        0,
+    }};
+    if (method == RENUMBERING_RCM) {
+        renumbering->new_to_old = reverse_cuthill_mckee(*graph);
+    } else if (method == RENUMBERING_NESTED_DISSECTION) {
+        renumbering->new_to_old = nested_dissection(*graph, coordinates);
+    } else {
+        renumbering->new_to_old.resize(number_of_nodes);
+        for (size_t i = 0; i < number_of_nodes; i++) {
+            renumbering->new_to_old[i] = i;
+        }
+    }
+    for (size_t i = 0; i < number_of_nodes; i++) {
+        renumbering->old_to_new[renumbering->new_to_old[i]] = i;
+    }
+    renumbering->bandwidth_before = graph->bandwidth(std::vector<size_t>());
+    renumbering->bandwidth_after = graph->bandwidth(renumbering->old_to_new);
+    return renumbering;
+}
+
+std::vector<double> NodeRenumbering::to_new_coordinates(const std::vector<double> &coordinates) const {
+    std::vector<double> result(coordinates.size());
+    for (size_t i = 0; i < new_to_old.size(); i++) {
+        result[i * 2] = coordinates[new_to_old[i] * 2];
+        result[i * 2 + 1] = coordinates[new_to_old[i] * 2 + 1];
+    }
+    return result;
+}
+
+std::vector<size_t> NodeRenumbering::to_new_connectivity(const std::vector<size_t> &connectivity) const {
+    std::vector<size_t> result(connectivity.size());
+    for (size_t k = 0; k < connectivity.size(); k++) {
+        result[k] = old_to_new[connectivity[k]];
+    }
+    return result;
+}
+
+std::map<node_dof_pair_t, double> NodeRenumbering::to_new_bcs(const std::map<node_dof_pair_t, double> &bcs) const {
+    std::map<node_dof_pair_t, double> result;
+    for (const auto &[key, value] : bcs) {
+        const auto [node, dof] = key;
+        result[{old_to_new[node], dof}] = value;
+    }
+    return result;
+}
+
+void NodeRenumbering::to_original_dofs(std::vector<double> &original, const std::vector<double> &renumbered) const {
+    original.resize(renumbered.size());
+    for (size_t i = 0; i < old_to_new.size(); i++) {
+        original[i * 2] = renumbered[old_to_new[i] * 2];
+        original[i * 2 + 1] = renumbered[old_to_new[i] * 2 + 1];
+    }
+}
+
+/// @brief Spreads the bits of x such that there is a zero bit between consecutive bits
+inline uint64_t spread_bits(uint32_t x) {
+    uint64_t v = x;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+uint64_t morton_index(uint32_t x, uint32_t y) {
+    return spread_bits(x) | (spread_bits(y) << 1);
+}
+
+uint64_t hilbert_index(uint32_t x, uint32_t y, size_t bits) {
+    uint64_t n = uint64_t(1) << bits;
+    uint64_t xx = x, yy = y, d = 0;
+    for (uint64_t s = n / 2; s > 0; s /= 2) {
+        uint64_t rx = (xx & s) > 0 ? 1 : 0;
+        uint64_t ry = (yy & s) > 0 ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // rotate the quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                xx = n - 1 - xx;
+                yy = n - 1 - yy;
+            }
+            std::swap(xx, yy);
+        }
+    }
+    return d;
+}
+
+std::unique_ptr<ElementOrdering> ElementOrdering::make_new(ElementOrderingMethod method,
+                                                           const std::vector<double> &coordinates,
+                                                           const std::vector<size_t> &connectivity,
+                                                           size_t element_num_node) {
+    size_t number_of_elements = connectivity.size() / element_num_node;
+    auto ordering = std::unique_ptr<ElementOrdering>{new ElementOrdering{
+        method,
+        std::vector<size_t>(number_of_elements),
+    }};
+    for (size_t e = 0; e < number_of_elements; e++) {
+        ordering->new_to_old[e] = e;
+    }
+    if (method == ELEMENT_ORDERING_NONE || number_of_elements == 0) {
+        return ordering;
+    }
+
+    // centroids and bounding box
+    std::vector<double> centroids(2 * number_of_elements, 0.0);
+    double min[2] = {coordinates[connectivity[0] * 2], coordinates[connectivity[0] * 2 + 1]};
+    double max[2] = {min[0], min[1]};
+    for (size_t e = 0; e < number_of_elements; e++) {
+        for (size_t d = 0; d < 2; d++) {
+            for (size_t k = 0; k < element_num_node; k++) {
+                centroids[e * 2 + d] += coordinates[connectivity[e * element_num_node + k] * 2 + d];
+            }
+            centroids[e * 2 + d] /= static_cast<double>(element_num_node);
+            min[d] = std::min(min[d], centroids[e * 2 + d]);
+            max[d] = std::max(max[d], centroids[e * 2 + d]);
+        }
+    }
+
+    // index of the grid cell along the curve (the grid is square to keep the curve isotropic)
+    double cells = static_cast<double>((uint64_t(1) << SPACE_FILLING_CURVE_BITS) - 1);
+    double size = std::max(max[0] - min[0], max[1] - min[1]);
+    double scale = size > 0.0 ? cells / size : 0.0;
+    std::vector<uint64_t> keys(number_of_elements);
+    for (size_t e = 0; e < number_of_elements; e++) {
+        auto x = static_cast<uint32_t>((centroids[e * 2] - min[0]) * scale);
+        auto y = static_cast<uint32_t>((centroids[e * 2 + 1] - min[1]) * scale);
+        keys[e] = method == ELEMENT_ORDERING_HILBERT ? hilbert_index(x, y, SPACE_FILLING_CURVE_BITS)
+                                                     : morton_index(x, y);
+    }
+    std::stable_sort(ordering->new_to_old.begin(), ordering->new_to_old.end(),
+                     [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+    return ordering;
+}
+
+std::vector<size_t> ElementOrdering::to_new_connectivity(const std::vector<size_t> &connectivity) const {
+    std::vector<size_t> result(connectivity.size());
+    size_t element_num_node = new_to_old.empty() ? 0 : connectivity.size() / new_to_old.size();
+    for (size_t e = 0; e < new_to_old.size(); e++) {
+        for (size_t k = 0; k < element_num_node; k++) {
+            result[e * element_num_node + k] = connectivity[new_to_old[e] * element_num_node + k];
+        }
+    }
+    return result;
+}
+
+std::vector<double> ElementOrdering::to_new_element_values(const std::vector<double> &values) const {
+    if (values.empty()) {
+        return std::vector<double>();
+    }
+    std::vector<double> result(new_to_old.size());
+    for (size_t e = 0; e < new_to_old.size(); e++) {
+        result[e] = values[new_to_old[e]];
+    }
+    return result;
+}
+
+void ElementOrdering::to_original_element_values(std::vector<double> &original,
+                                                 const std::vector<double> &reordered) const {
+    original.resize(reordered.size());
+    for (size_t e = 0; e < new_to_old.size(); e++) {
+        original[new_to_old[e]] = reordered[e];
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "fem2d.h"
+#include "mesh_topology.h"
+
+/// @brief Defines the node renumbering methods
+enum RenumberingMethod {
+    RENUMBERING_NONE,              // keep the numbering of the mesh file
+    RENUMBERING_RCM,               // reverse Cuthill-McKee (minimizes the bandwidth)
+    RENUMBERING_NESTED_DISSECTION, // geometric nested dissection (separators last; reduces the fill-in)
+};
+
+/// @brief Defines the element ordering methods (space-filling curve through the element centroids)
+enum ElementOrderingMethod {
+    ELEMENT_ORDERING_NONE,    // keep the order of the mesh file
+    ELEMENT_ORDERING_MORTON,  // Z-order curve
+    ELEMENT_ORDERING_HILBERT, // Hilbert curve (consecutive cells are always neighbors)
+};
+
+/// @brief Number of bits per direction of the space-filling curve grid
+const size_t SPACE_FILLING_CURVE_BITS = 16;
+
+/// @brief Holds the adjacency of the node graph in CSR format (two nodes are adjacent if they share an element)
+struct NodeGraph {
+    /// @brief Row pointers (size = number_of_nodes + 1)
+    std::vector<size_t> pointers;
+
+    /// @brief Adjacent nodes, sorted and without the node itself (size = pointers[number_of_nodes])
+    std::vector<size_t> adjacency;
+
+    /// @brief Builds the node graph from the connectivity
+    /// @param number_of_nodes Number of nodes
+    /// @param connectivity Connectivity (size = element_num_node * number_of_elements)
+    /// @param element_num_node Number of nodes per element (2 or 3)
+    static std::unique_ptr<NodeGraph> make_new(size_t number_of_nodes,
+                                               const std::vector<size_t> &connectivity,
+                                               size_t element_num_node);
+
+    /// @brief Builds the node graph from the unique edges of the topology (without scanning the elements)
+    static std::unique_ptr<NodeGraph> make_from_topology(const MeshTopology &topology);
+
+    /// @brief Returns the number of nodes
+    inline size_t number_of_nodes() const { return pointers.size() - 1; }
+
+    /// @brief Returns the number of adjacent nodes
+    inline size_t degree(size_t node) const { return pointers[node + 1] - pointers[node]; }
+
+    /// @brief Returns the half-bandwidth max|new(i) - new(j)| over all adjacent nodes
+    /// @param old_to_new Maps the current to the new numbering (empty means the identity)
+    size_t bandwidth(const std::vector<size_t> &old_to_new) const;
+};
+
+/// @brief Holds a permutation of the nodes that improves locality (renumbering stage before Fem2d::make_new)
+///
+/// The mesh data are permuted with the to_new_* functions, and the results (e.g., fem.uu) are
+/// mapped back to the numbering of the mesh file with to_original_dofs. Since the DOFs of a node
+/// are 2 * node and 2 * node + 1, the DOF half-bandwidth is about twice the node half-bandwidth.
+struct NodeRenumbering {
+    /// @brief Method used to compute the permutation
+    RenumberingMethod method;
+
+    /// @brief Maps the new to the original node number (size = number_of_nodes)
+    std::vector<size_t> new_to_old;
+
+    /// @brief Maps the original to the new node number (size = number_of_nodes)
+    std::vector<size_t> old_to_new;
+
+    /// @brief Node half-bandwidth with the original numbering
+    size_t bandwidth_before;
+
+    /// @brief Node half-bandwidth with the new numbering
+    size_t bandwidth_after;
+
+    /// @brief Computes the permutation of the nodes
+    /// @param method Renumbering method
+    /// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes; used by nested dissection)
+    /// @param connectivity Connectivity (size = element_num_node * number_of_elements)
+    /// @param element_num_node Number of nodes per element (2 or 3)
+    /// @param topology Cached topology of the mesh used to build the node graph (optional)
+    static std::unique_ptr<NodeRenumbering> make_new(RenumberingMethod method,
+                                                     const std::vector<double> &coordinates,
+                                                     const std::vector<size_t> &connectivity,
+                                                     size_t element_num_node,
+                                                     const MeshTopology *topology = NULL);
+
+    /// @brief Returns the coordinates in the new numbering
+    std::vector<double> to_new_coordinates(const std::vector<double> &coordinates) const;
+
+    /// @brief Returns the connectivity with the new node numbers (the element order is unchanged)
+    std::vector<size_t> to_new_connectivity(const std::vector<size_t> &connectivity) const;
+
+    /// @brief Returns the boundary conditions with the new node numbers
+    std::map<node_dof_pair_t, double> to_new_bcs(const std::map<node_dof_pair_t, double> &bcs) const;
+
+    /// @brief Maps a DOF vector (e.g., fem.uu) from the new to the original numbering
+    /// @param original Vector in the original numbering (size = 2 * number_of_nodes)
+    /// @param renumbered Vector in the new numbering (size = 2 * number_of_nodes)
+    void to_original_dofs(std::vector<double> &original, const std::vector<double> &renumbered) const;
+};
+
+/// @brief Computes the reverse Cuthill-McKee ordering of the node graph
+/// @return The new-to-old map
+std::vector<size_t> reverse_cuthill_mckee(const NodeGraph &graph);
+
+/// @brief Computes a geometric nested dissection ordering of the node graph
+/// @param graph Node graph
+/// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+/// @param leaf_size Subdomains with up to leaf_size nodes are not dissected (they are ordered by RCM)
+/// @return The new-to-old map
+std::vector<size_t> nested_dissection(const NodeGraph &graph, const std::vector<double> &coordinates,
+                                      size_t leaf_size = 64);
+
+/// @brief Holds a permutation of the elements sorted along a space-filling curve through their centroids
+///
+/// Consecutive elements then touch nearby coordinates and (after node renumbering) nearby matrix rows,
+/// which improves the cache reuse of the assembly. To combine both passes, compute the element
+/// ordering with the renumbered coordinates and connectivity.
+struct ElementOrdering {
+    /// @brief Method used to compute the permutation
+    ElementOrderingMethod method;
+
+    /// @brief Maps the new to the original element number (size = number_of_elements)
+    std::vector<size_t> new_to_old;
+
+    /// @brief Computes the permutation of the elements
+    /// @param method Ordering method
+    /// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    /// @param connectivity Connectivity (size = element_num_node * number_of_elements)
+    /// @param element_num_node Number of nodes per element (2 or 3)
+    static std::unique_ptr<ElementOrdering> make_new(ElementOrderingMethod method,
+                                                     const std::vector<double> &coordinates,
+                                                     const std::vector<size_t> &connectivity,
+                                                     size_t element_num_node);
+
+    /// @brief Returns the connectivity with the elements in the new order
+    std::vector<size_t> to_new_connectivity(const std::vector<size_t> &connectivity) const;
+
+    /// @brief Returns element values (e.g., param_young) in the new order (empty vectors are kept empty)
+    std::vector<double> to_new_element_values(const std::vector<double> &values) const;
+
+    /// @brief Maps element values (e.g., stresses) from the new to the original order
+    void to_original_element_values(std::vector<double> &original, const std::vector<double> &reordered) const;
+};
+
+/// @brief Returns the Morton (Z-order) index of the cell (x, y) by interleaving the bits
+uint64_t morton_index(uint32_t x, uint32_t y);
+
+/// @brief Returns the index of the cell (x, y) along the Hilbert curve filling a 2^bits × 2^bits grid
+uint64_t hilbert_index(uint32_t x, uint32_t y, size_t bits);
@@ -0,0 +1,123 @@
+#include "sensitivity.h"
+#include "element_stiffness.h"
+
+/// @brief Throws if the solution is out of date or the parameter does not apply to the elements
+inline void check_sensitivity_inputs(const Fem2d &fem, SensitivityParameter parameter) {
+    if (fem.dirty != DIRTY_NONE) {
+        throw "the sensitivities require an up-to-date solution (call solve first)";
+    }
+    if (parameter == SENSITIVITY_CROSS_AREA && fem.solid_triangle) {
+        throw "the sensitivity with respect to the cross-sectional area requires rods";
+    }
+}
+
+void calculate_element_sensitivities(const Fem2d &fem,
+                                     const std::vector<double> &lambda,
+                                     SensitivityParameter parameter,
+                                     std::vector<double> &gradient) {
+    size_t nnode = fem.solid_triangle ? 3 : 2;
+    size_t nrow = 2 * nnode;
+    gradient.resize(fem.number_of_elements);
+
+#pragma omp parallel for
+    for (size_t e = 0; e < fem.number_of_elements; e++) {
+        size_t m[6];
+        double xy[6];
+        for (size_t k = 0; k < nnode; k++) {
+            size_t node = fem.connectivity[e * nnode + k];
+            m[k * 2] = node * 2;
+            m[k * 2 + 1] = node * 2 + 1;
+            xy[k * 2] = fem.coordinates[node * 2];
+            xy[k * 2 + 1] = fem.coordinates[node * 2 + 1];
+        }
+
+        // ∂Kₑ/∂pₑ = Kₑ(pₑ = 1) because Kₑ is linear in E and A
+        double geo[GEOMETRY_SIZE_SOLID_TRIANGLE];
+        double dkk[PACKED_SIZE_SOLID_TRIANGLE];
+        if (fem.solid_triangle) {
+            geometry_solid_triangle(geo, xy, fem.thickness);
+            packed_stiffness_solid_triangle(dkk, geo, 1.0, fem.param_poisson[e], fem.plane_stress);
+        } else {
+            geometry_elastic_rod(geo, xy);
+            if (parameter == SENSITIVITY_YOUNG) {
+                packed_stiffness_elastic_rod(dkk, geo, 1.0, fem.param_cross_area[e]);
+            } else {
+                packed_stiffness_elastic_rod(dkk, geo, fem.param_young[e], 1.0);
+            }
+        }
+
+        // gₑ = -λₑᵀ ⋅ ∂Kₑ/∂pₑ ⋅ uₑ
+        double sum = 0.0;
+        for (size_t i = 0; i < nrow; i++) {
+            if (lambda[m[i]] == 0.0) {
+                continue;
+            }
+            double row = 0.0;
+            for (size_t j = 0; j < nrow; j++) {
+                row += packed_get(dkk, nrow, i, j) * fem.uu[m[j]];
+            }
+            sum += lambda[m[i]] * row;
+        }
+        gradient[e] = -sum;
+    }
+}
+
+double calculate_response_sensitivity(Fem2d &fem,
+                                      const std::vector<double> &weights,
+                                      SensitivityParameter parameter,
+                                      std::vector<double> &gradient) {
+    check_sensitivity_inputs(fem, parameter);
+    if (weights.size() != fem.total_ndof) {
+        throw "calculate_response_sensitivity requires one weight per DOF";
+    }
+
+    // adjoint: K ⋅ λ = l with the existing factorization (identity rows on prescribed DOFs => λ₂ = 0)
+    std::vector<double> adjoint_rhs(fem.total_ndof);
+    double response = 0.0;
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        adjoint_rhs[i] = fem.essential_prescribed[i] ? 0.0 : weights[i];
+        response += weights[i] * fem.uu[i];
+    }
+    std::vector<double> lambda(fem.total_ndof);
+    fem.lin_sys_solver->solve(lambda, adjoint_rhs);
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        if (fem.essential_prescribed[i]) {
+            lambda[i] = 0.0;
+        }
+    }
+    calculate_element_sensitivities(fem, lambda, parameter, gradient);
+    return response;
+}
+
+double calculate_displacement_sensitivity(Fem2d &fem,
+                                          size_t node,
+                                          LocalDOF dof,
+                                          SensitivityParameter parameter,
+                                          std::vector<double> &gradient) {
+    if (node >= fem.number_of_nodes) {
+        throw "calculate_displacement_sensitivity requires a valid node number";
+    }
+    std::vector<double> weights(fem.total_ndof, 0.0);
+    weights[node * 2 + dof] = 1.0;
+    return calculate_response_sensitivity(fem, weights, parameter, gradient);
+}
+
+double calculate_compliance_sensitivity(Fem2d &fem, SensitivityParameter parameter, std::vector<double> &gradient) {
+    check_sensitivity_inputs(fem, parameter);
+    bool self_adjoint = true;
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        if (fem.essential_prescribed[i] && fem.essential_boundary_conditions[i] != 0.0) {
+            self_adjoint = false;
+            break;
+        }
+    }
+    if (!self_adjoint) {
+        return calculate_response_sensitivity(fem, fem.natural_boundary_conditions, parameter, gradient);
+    }
+    double compliance = 0.0;
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        compliance += fem.natural_boundary_conditions[i] * fem.uu[i];
+    }
+    calculate_element_sensitivities(fem, fem.uu, parameter, gradient); // λ = uu (zero at prescribed DOFs)
+    return compliance;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "fem2d.h"
+
+/// @brief Defines the element parameter with respect to which the sensitivities are computed
+enum SensitivityParameter {
+    SENSITIVITY_YOUNG,      // param_young (rods and triangles)
+    SENSITIVITY_CROSS_AREA, // param_cross_area (rods only)
+};
+
+/// @brief Calculates the derivative of R = lᵀ ⋅ uu with respect to the parameter of each element (adjoint)
+///
+/// The adjoint system K ⋅ λ = l (with l and λ zero at the prescribed DOFs) is solved with the factorization
+/// kept by fem.solve; then, dR/dpₑ = -λₑᵀ ⋅ (∂Kₑ/∂pₑ) ⋅ uₑ is evaluated element by element (in parallel)
+/// with the stiffness kernels. Since Kₑ is linear in E and A, ∂Kₑ/∂pₑ is the element stiffness with pₑ = 1.
+/// The prescribed values enter through uₑ; the natural boundary conditions must not depend on the parameters.
+///
+/// @param fem The problem; solve must have been called after the last change (fem.dirty == DIRTY_NONE)
+/// @param weights The vector l (size = total_ndof; the entries at prescribed DOFs are ignored)
+/// @param parameter The element parameter
+/// @param gradient (output) dR/dpₑ (size = number_of_elements)
+/// @return The response R = lᵀ ⋅ uu
+double calculate_response_sensitivity(Fem2d &fem,
+                                      const std::vector<double> &weights,
+                                      SensitivityParameter parameter,
+                                      std::vector<double> &gradient);
+
+/// @brief Calculates the derivative of the displacement at (node, dof) (see calculate_response_sensitivity)
+/// @return The displacement uu[node * 2 + dof]
+double calculate_displacement_sensitivity(Fem2d &fem,
+                                          size_t node,
+                                          LocalDOF dof,
+                                          SensitivityParameter parameter,
+                                          std::vector<double> &gradient);
+
+/// @brief Calculates the derivative of the compliance C = fᵀ ⋅ uu where f = fem.natural_boundary_conditions
+/// @note If all prescribed values are zero, the problem is self-adjoint (λ = uu) and no extra solve is needed;
+///       then, dC/dpₑ = -uₑᵀ ⋅ (∂Kₑ/∂pₑ) ⋅ uₑ
+/// @return The compliance C
+double calculate_compliance_sensitivity(Fem2d &fem, SensitivityParameter parameter, std::vector<double> &gradient);
+
+/// @brief Calculates gₑ = -λₑᵀ ⋅ (∂Kₑ/∂pₑ) ⋅ uₑ for all elements (in parallel)
+/// @param lambda The adjoint solution (size = total_ndof; zero at the prescribed DOFs)
+void calculate_element_sensitivities(const Fem2d &fem,
+                                     const std::vector<double> &lambda,
+                                     SensitivityParameter parameter,
+                                     std::vector<double> &gradient);
@@ -0,0 +1,112 @@
+#include <cmath>
+
+#include "solver_mixed_precision.h"
+
+/// @brief Returns the Euclidean norm of a vector
+inline double vector_norm(const std::vector<double> &v) {
+    double sum = 0.0;
+    for (auto value : v) {
+        sum += value * value;
+    }
+    return sqrt(sum);
+}
+
+std::unique_ptr<SolverMixedPrecision> SolverMixedPrecision::make_new(const PardisoOptions &options,
+                                                                     double tolerance,
+                                                                     size_t max_refinements) {
+    auto options_single = options;
+    options_single.single_precision = true;
+    return std::unique_ptr<SolverMixedPrecision>{new SolverMixedPrecision{
+        options,
+        tolerance,
+        max_refinements,
+        0.5, // min_reduction
+        SolverPardiso::make_new(options_single),
+        NULL,
+        NULL,
+        0,
+        false,
+        0.0,
+    }};
+}
+
+void SolverMixedPrecision::analyze(const CsrUpper &kk) {
+    solver_double.reset();
+    solver_single->analyze(kk);
+}
+
+void SolverMixedPrecision::factorize(const CsrUpper &kk) {
+    this->kk = &kk;
+    used_fallback = false;
+    solver_double.reset();
+    try {
+        solver_single->factorize(kk);
+    } catch (const char *) {
+        // e.g., a small pivot became non-positive after rounding to single precision
+        fallback_to_double();
+    }
+}
+
+void SolverMixedPrecision::fallback_to_double() {
+    solver_single->release();
+    auto options_double = options;
+    options_double.single_precision = false;
+    solver_double = SolverPardiso::make_new(options_double);
+    solver_double->factorize(*kk);
+    used_fallback = true;
+}
+
+void SolverMixedPrecision::solve(std::vector<double> &x, const std::vector<double> &b) {
+    if (kk == NULL) {
+        throw "SolverMixedPrecision::solve requires factorize to be called first";
+    }
+    refinements = 0;
+    double b_norm = vector_norm(b);
+    if (b_norm == 0.0) {
+        x.assign(kk->dim, 0.0);
+        relative_residual = 0.0;
+        return;
+    }
+
+    if (!used_fallback) {
+        // initial solution with the single-precision factors
+        std::vector<double> r(b);
+        std::vector<double> c(kk->dim);
+        std::vector<double> ax(kk->dim);
+        x.assign(kk->dim, 0.0);
+        double r_norm = b_norm;
+        while (true) {
+            // x := x + c where A ⋅ c = r (single precision)
+            solver_single->solve(c, r);
+            for (size_t i = 0; i < kk->dim; i++) {
+                x[i] += c[i];
+            }
+
+            // r := b - A ⋅ x (double precision)
+            kk->multiply(ax, x);
+            for (size_t i = 0; i < kk->dim; i++) {
+                r[i] = b[i] - ax[i];
+            }
+            double r_norm_new = vector_norm(r);
+            relative_residual = r_norm_new / b_norm;
+            if (relative_residual <= tolerance) {
+                return;
+            }
+            if (refinements >= max_refinements || !(r_norm_new <= min_reduction * r_norm)) {
+                break; // stagnation or divergence
+            }
+            r_norm = r_norm_new;
+            refinements++;
+        }
+        fallback_to_double();
+    }
+
+    // double precision
+    solver_double->solve(x, b);
+    std::vector<double> ax(kk->dim);
+    kk->multiply(ax, x);
+    for (size_t i = 0; i < kk->dim; i++) {
+        ax[i] = b[i] - ax[i];
+    }
+    relative_residual = vector_norm(ax) / b_norm;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "csr_upper.h"
+#include "solver_pardiso.h"
+
+/// @brief Solves the linear system with a single-precision factorization and iterative refinement
+///
+/// The factorization is computed on a single-precision copy of the matrix, which roughly halves
+/// the factor memory. Each refinement step computes the residual r = b - A ⋅ x in double
+/// precision and the correction A ⋅ c = r with the single-precision factors.
+/// If the refinement does not converge (or the single-precision factorization fails),
+/// the matrix is refactorized in double precision automatically.
+struct SolverMixedPrecision {
+    /// @brief Holds the PARDISO options (ordering and threads) used by both factorizations
+    PardisoOptions options;
+
+    /// @brief Relative tolerance on the residual: ‖b - A ⋅ x‖ ≤ tolerance ⋅ ‖b‖
+    double tolerance;
+
+    /// @brief Maximum number of refinement steps before falling back to double precision
+    size_t max_refinements;
+
+    /// @brief Minimum residual reduction per step; slower convergence triggers the fallback
+    double min_reduction;
+
+    /// @brief Holds the single-precision factorization
+    std::unique_ptr<SolverPardiso> solver_single;
+
+    /// @brief Holds the double-precision factorization (fallback)
+    std::unique_ptr<SolverPardiso> solver_double;
+
+    /// @brief Holds the matrix used in the last factorization
+    const CsrUpper *kk;
+
+    /// @brief Number of refinement steps in the last solve
+    size_t refinements;
+
+    /// @brief Indicates that the last solve used the double-precision fallback
+    bool used_fallback;
+
+    /// @brief Relative residual of the last solve
+    double relative_residual;
+
+    /// @brief Allocates a new SolverMixedPrecision
+    /// @param options PARDISO options (single_precision is ignored)
+    /// @param tolerance Relative tolerance on the residual
+    /// @param max_refinements Maximum number of refinement steps
+    static std::unique_ptr<SolverMixedPrecision> make_new(const PardisoOptions &options,
+                                                          double tolerance,
+                                                          size_t max_refinements);
+
+    /// @brief Performs the symbolic analysis of kk (required whenever the sparsity pattern changes)
+    void analyze(const CsrUpper &kk);
+
+    /// @brief Factorizes a single-precision copy of kk (falls back to double precision on failure)
+    /// @note The matrix must outlive the calls to solve
+    void factorize(const CsrUpper &kk);
+
+    /// @brief Solves kk ⋅ x = b to double-precision accuracy
+    void solve(std::vector<double> &x, const std::vector<double> &b);
+
+    /// @brief Discards the single-precision factors and factorizes kk in double precision
+    void fallback_to_double();
+};
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include "solver_pardiso.h"
+
+// real symmetric positive-definite
+const MKL_INT PARDISO_MTYPE = 2;
+
+// default of MKL_PARDISO_OOC_MAX_CORE_SIZE (megabytes)
+const size_t PARDISO_OOC_DEFAULT_MAX_CORE_SIZE_MB = 2000;
+
+std::unique_ptr<SolverPardiso> SolverPardiso::make_new(const PardisoOptions &options) {
+    auto solver = std::unique_ptr<SolverPardiso>{new SolverPardiso{}};
+    solver->options = options;
+    solver->kk = NULL;
+    solver->dim = 0;
+    solver->analyzed_nnz = 0;
+    solver->analyzed = false;
+    solver->factorized = false;
+    for (size_t i = 0; i < 64; i++) {
+        solver->pt[i] = NULL;
+        solver->iparm[i] = 0;
+    }
+    solver->iparm[0] = 1;   // do not use the default values
+    solver->iparm[1] = options.ordering;
+    solver->iparm[7] = 0;   // no internal iterative refinement
+    solver->iparm[9] = 8;   // pivot perturbation 1e-8
+    solver->iparm[17] = -1; // report the number of non-zeros in the factor
+    solver->iparm[23] = options.two_level_factorization ? 1 : 0;
+    solver->iparm[26] = 0;  // do not check the matrix
+    solver->iparm[27] = options.single_precision ? 1 : 0;
+    solver->iparm[34] = 1; // zero-based indexing
+    solver->iparm[59] = options.memory_mode;
+    solver->timing_analyze = PardisoPhaseTiming{0.0, 0.0, 0};
+    solver->timing_factorize = PardisoPhaseTiming{0.0, 0.0, 0};
+    solver->timing_solve = PardisoPhaseTiming{0.0, 0.0, 0};
+    return solver;
+}
+
+SolverPardiso::~SolverPardiso() {
+    release();
+}
+
+void SolverPardiso::release() {
+    if (analyzed) {
+        // the matrix may have been freed already: use the stored dimension only
+        MKL_INT maxfct = 1, mnum = 1, nrhs = 1, msglvl = 0, error = 0;
+        MKL_INT phase = -1;
+        double ddum = 0.0;
+        MKL_INT idum = 0;
+        pardiso(pt, &maxfct, &mnum, &PARDISO_MTYPE, &phase, &dim, &ddum, &idum, &idum,
+                &idum, &nrhs, iparm, &msglvl, &ddum, &ddum, &error);
+    }
+    kk = NULL;
+    analyzed = false;
+    factorized = false;
+}
+
+void SolverPardiso::call(MKL_INT phase, void *b, void *x, PardisoPhaseTiming *timing) {
+    MKL_INT maxfct = 1, mnum = 1, nrhs = 1, msglvl = 0, error = 0;
+    MKL_INT n = static_cast<MKL_INT>(kk->dim);
+    MKL_INT idum = 0;
+    const void *a = options.single_precision ? static_cast<const void *>(values_single.data())
+                                             : static_cast<const void *>(kk->values.data());
+    int previous_num_threads = options.num_threads > 0 ? mkl_set_num_threads_local(options.num_threads) : 0;
+    int num_threads = options.num_threads > 0 ? options.num_threads : mkl_get_max_threads();
+    double wall_start = dsecnd();
+    std::clock_t cpu_start = std::clock();
+    pardiso(pt, &maxfct, &mnum, &PARDISO_MTYPE, &phase, &n, a, kk->row_pointers.data(), kk->column_indices.data(),
+            &idum, &nrhs, iparm, &msglvl, b, x, &error);
+    if (timing != NULL) {
+        timing->wall_seconds = dsecnd() - wall_start;
+        timing->cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        timing->num_threads = num_threads;
+    }
+    if (options.num_threads > 0) {
+        mkl_set_num_threads_local(previous_num_threads);
+    }
+    if (error != 0) {
+        if (error == -4) {
+            throw "SolverPardiso failed because the matrix is not positive-definite (zero or negative pivot)";
+        } else if (error == -2 || error == -9) {
+            throw "SolverPardiso failed because there is not enough memory";
+        } else if (error == -10) {
+            throw "SolverPardiso failed to open the out-of-core files (check ooc_path)";
+        } else if (error == -11) {
+            throw "SolverPardiso failed to read or write the out-of-core files (check the free disk space)";
+        }
+        throw "SolverPardiso failed";
+    }
+}
+
+void SolverPardiso::analyze(const CsrUpper &kk) {
+    if (analyzed) {
+        release();
+    }
+    this->kk = &kk;
+    dim = static_cast<MKL_INT>(kk.dim);
+    analyzed_nnz = kk.nnz();
+    if (options.single_precision) {
+        values_single.assign(kk.values.begin(), kk.values.end());
+    }
+    double ddum = 0.0;
+    call(11, &ddum, &ddum, &timing_analyze);
+    analyzed = true;
+    factorized = false;
+}
+
+void SolverPardiso::factorize(const CsrUpper &kk) {
+    if (!analyzed || dim != static_cast<MKL_INT>(kk.dim) || analyzed_nnz != kk.nnz()) {
+        analyze(kk);
+    }
+    this->kk = &kk;
+    if (options.single_precision) {
+        values_single.assign(kk.values.begin(), kk.values.end());
+    }
+    double ddum = 0.0;
+    call(22, &ddum, &ddum, &timing_factorize);
+    factorized = true;
+}
+
+void SolverPardiso::solve(std::vector<double> &x, const std::vector<double> &b) {
+    if (!factorized) {
+        throw "SolverPardiso::solve requires factorize to be called first";
+    }
+    x.resize(kk->dim);
+    if (options.single_precision) {
+        std::vector<float> b_single(b.begin(), b.end());
+        std::vector<float> x_single(kk->dim);
+        call(33, b_single.data(), x_single.data(), &timing_solve);
+        std::copy(x_single.begin(), x_single.end(), x.begin());
+    } else {
+        std::vector<double> b_copy(b); // PARDISO may modify b
+        call(33, b_copy.data(), x.data(), &timing_solve);
+    }
+}
+
+size_t SolverPardiso::peak_memory_kb() const {
+    // iparm[14]: peak analysis; iparm[15]: permanent; iparm[16]: factorization and solution
+    return static_cast<size_t>(std::max(iparm[14], iparm[15] + iparm[16]));
+}
+
+size_t SolverPardiso::factor_nnz() const {
+    return static_cast<size_t>(iparm[17]);
+}
+
+bool SolverPardiso::used_out_of_core() const {
+    if (options.memory_mode == PARDISO_IN_CORE) {
+        return false;
+    } else if (options.memory_mode == PARDISO_OUT_OF_CORE) {
+        return true;
+    }
+    // PARDISO keeps the factors in RAM if they fit in MKL_PARDISO_OOC_MAX_CORE_SIZE
+    const char *variable = getenv("MKL_PARDISO_OOC_MAX_CORE_SIZE");
+    size_t max_core_size_mb = variable != NULL ? std::strtoull(variable, NULL, 10) : 0;
+    if (max_core_size_mb == 0) {
+        max_core_size_mb = PARDISO_OOC_DEFAULT_MAX_CORE_SIZE_MB;
+    }
+    return static_cast<size_t>(iparm[15] + iparm[16]) > max_core_size_mb * 1024;
+}
+
+void SolverPardiso::print_timings() const {
+    printf("PARDISO: %s; peak memory = %zu KB; factor nnz = %zu\n",
+           used_out_of_core() ? "out-of-core" : "in-core", peak_memory_kb(), factor_nnz());
+    if (options.memory_mode != PARDISO_IN_CORE) {
+        printf("minimum out-of-core memory = %zu KB\n", static_cast<size_t>(iparm[62]));
+    }
+    printf("%-12s %12s %12s %8s %12s\n", "phase", "wall (s)", "cpu (s)", "threads", "~idle (s)");
+    const char *names[] = {"analyze", "factorize", "solve"};
+    const PardisoPhaseTiming *timings[] = {&timing_analyze, &timing_factorize, &timing_solve};
+    for (size_t i = 0; i < 3; i++) {
+        printf("%-12s %12.6f %12.6f %8d %12.6f\n", names[i], timings[i]->wall_seconds, timings[i]->cpu_seconds,
+               timings[i]->num_threads, timings[i]->estimated_idle_seconds());
+    }
+}
+
+void set_pardiso_out_of_core_environment(const PardisoOptions &options) {
+    // PARDISO reads these variables (or pardiso_ooc.cfg) in the analysis and factorization phases
+    if (!options.ooc_path.empty()) {
+        setenv("MKL_PARDISO_OOC_PATH", options.ooc_path.c_str(), 1);
+    }
+    if (options.ooc_max_core_size_mb > 0) {
+        setenv("MKL_PARDISO_OOC_MAX_CORE_SIZE", std::to_string(options.ooc_max_core_size_mb).c_str(), 1);
+    }
+    setenv("MKL_PARDISO_OOC_KEEP_FILE", options.ooc_keep_files ? "1" : "0", 1);
+}
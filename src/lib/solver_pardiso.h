@@ -0,0 +1,165 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "csr_upper.h"
+#include "mkl.h"
+
+/// @brief Defines the fill-in reducing ordering (iparm[1])
+enum PardisoOrdering {
+    PARDISO_MINIMUM_DEGREE = 0,
+    PARDISO_NESTED_DISSECTION = 2,
+    PARDISO_PARALLEL_NESTED_DISSECTION = 3,
+};
+
+/// @brief Defines where the factors are stored (iparm[59])
+enum PardisoMemoryMode {
+    PARDISO_IN_CORE = 0,               // factors in RAM
+    PARDISO_OUT_OF_CORE_IF_NEEDED = 1, // factors in RAM if they fit in ooc_max_core_size_mb; on disk otherwise
+    PARDISO_OUT_OF_CORE = 2,           // factors on disk
+};
+
+/// @brief Holds the options for the PARDISO solver (real symmetric positive-definite matrices)
+struct PardisoOptions {
+    /// @brief Factorize a single-precision copy of the matrix (iparm[27] = 1)
+    bool single_precision;
+
+    /// @brief Fill-in reducing ordering (iparm[1])
+    PardisoOrdering ordering;
+
+    /// @brief Use the two-level factorization algorithm (iparm[23] = 1); better for many threads
+    bool two_level_factorization;
+
+    /// @brief Number of threads used by PARDISO (0 means the MKL default)
+    int num_threads;
+
+    /// @brief Keep the factors in RAM or write them to ooc_path (iparm[59])
+    PardisoMemoryMode memory_mode;
+
+    /// @brief Path and file prefix of the out-of-core scratch files (MKL_PARDISO_OOC_PATH; empty means the default)
+    /// @note The ooc_* options are process-wide; see set_pardiso_out_of_core_environment
+    std::string ooc_path;
+
+    /// @brief Maximum RAM in megabytes for the out-of-core mode (MKL_PARDISO_OOC_MAX_CORE_SIZE; 0 means the default)
+    size_t ooc_max_core_size_mb;
+
+    /// @brief Keep the out-of-core scratch files after releasing the solver (MKL_PARDISO_OOC_KEEP_FILE)
+    bool ooc_keep_files;
+
+    /// @brief Allocates a new PardisoOptions structure with default values
+    inline static std::unique_ptr<PardisoOptions> make_new() {
+        return std::unique_ptr<PardisoOptions>{new PardisoOptions{
+            false,                     // single_precision
+            PARDISO_NESTED_DISSECTION, // ordering
+            false,                     // two_level_factorization
+            0,                         // num_threads
+            PARDISO_IN_CORE,           // memory_mode
+            "",                        // ooc_path
+            0,                         // ooc_max_core_size_mb
+            false,                     // ooc_keep_files
+        }};
+    }
+};
+
+/// @brief Holds the elapsed (wall) and processor (CPU) times of one PARDISO phase
+struct PardisoPhaseTiming {
+    /// @brief Elapsed time in seconds
+    double wall_seconds;
+
+    /// @brief Processor time in seconds of the whole process (std::clock; includes other concurrent solvers)
+    double cpu_seconds;
+
+    /// @brief Number of threads available to PARDISO during the phase
+    int num_threads;
+
+    /// @brief Estimates the idle time as wall - cpu / num_threads
+    /// @note This is only an estimate: it includes the I/O waits of the out-of-core mode, but also idle threads
+    inline double estimated_idle_seconds() const {
+        double busy = num_threads > 0 ? cpu_seconds / num_threads : cpu_seconds;
+        return wall_seconds > busy ? wall_seconds - busy : 0.0;
+    }
+};
+
+/// @brief Wraps MKL PARDISO for symmetric positive-definite matrices given by CsrUpper
+struct SolverPardiso {
+    /// @brief Holds the options
+    PardisoOptions options;
+
+    /// @brief Internal PARDISO memory pointer
+    void *pt[64];
+
+    /// @brief PARDISO parameters
+    MKL_INT iparm[64];
+
+    /// @brief Holds the single-precision copy of the values (if options.single_precision)
+    std::vector<float> values_single;
+
+    /// @brief Holds the matrix used in the last factorization (required by the solve phase)
+    /// @note Not used by release; hence, the matrix may be freed before this solver
+    const CsrUpper *kk;
+
+    /// @brief Dimension of the analyzed matrix (required by the release phase)
+    MKL_INT dim;
+
+    /// @brief Number of non-zero values of the analyzed matrix
+    size_t analyzed_nnz;
+
+    /// @brief Indicates that the symbolic analysis has been performed
+    bool analyzed;
+
+    /// @brief Indicates that the numeric factorization has been performed
+    bool factorized;
+
+    /// @brief Timing of the last analysis (phase 11)
+    PardisoPhaseTiming timing_analyze;
+
+    /// @brief Timing of the last factorization (phase 22)
+    PardisoPhaseTiming timing_factorize;
+
+    /// @brief Timing of the last solve (phase 33)
+    PardisoPhaseTiming timing_solve;
+
+    /// @brief Allocates a new SolverPardiso
+    static std::unique_ptr<SolverPardiso> make_new(const PardisoOptions &options);
+
+    /// @brief Releases the PARDISO memory
+    ~SolverPardiso();
+
+    /// @brief Performs the reordering and symbolic factorization (phase 11)
+    void analyze(const CsrUpper &kk);
+
+    /// @brief Performs the numeric factorization (phase 22); calls analyze if needed
+    /// @note The analysis is reused unless nothing has been analyzed yet or the dimension or number of non-zeros
+    ///       changed. Thus, the owner of the matrix must call analyze whenever it rebuilds the sparsity pattern.
+    ///       The matrix must outlive the calls to solve
+    void factorize(const CsrUpper &kk);
+
+    /// @brief Solves kk ⋅ x = b (phase 33)
+    void solve(std::vector<double> &x, const std::vector<double> &b);
+
+    /// @brief Returns the peak memory (in kilobytes) used by the analysis and factorization
+    size_t peak_memory_kb() const;
+
+    /// @brief Returns the number of non-zeros in the factor
+    size_t factor_nnz() const;
+
+    /// @brief Indicates that the last factorization was stored out-of-core (on disk)
+    bool used_out_of_core() const;
+
+    /// @brief Prints the memory usage and the phase timings (including the estimated idle time)
+    void print_timings() const;
+
+    /// @brief Releases the internal PARDISO memory (phase -1)
+    void release();
+
+    /// @brief Calls PARDISO and throws an exception on error
+    void call(MKL_INT phase, void *b, void *x, PardisoPhaseTiming *timing);
+};
+
+/// @brief Sets the process-wide MKL_PARDISO_OOC_* environment variables from the ooc_* options
+/// @note The variables apply to all PARDISO solvers of the process, and setenv is not thread-safe.
+///       Hence, call this once before creating the solvers (e.g., at the start of main), not while
+///       other threads are running (e.g., solve_batch or MonteCarloEnsemble).
+void set_pardiso_out_of_core_environment(const PardisoOptions &options);
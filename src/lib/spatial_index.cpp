@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+
+#include "spatial_index.h"
+
+/// @brief Appends the nodes of the cells (c0..c1, r) that satisfy the predicate
+template <typename Predicate>
+inline void collect_nodes(std::vector<size_t> &result,
+                          const SpatialIndex &index,
+                          size_t r,
+                          size_t c0,
+                          size_t c1,
+                          const Predicate &predicate) {
+    for (size_t c = c0; c <= c1; c++) {
+        size_t cell = r * index.ncol + c;
+        for (size_t p = index.cell_pointers[cell]; p < index.cell_pointers[cell + 1]; p++) {
+            size_t node = index.cell_nodes[p];
+            if (predicate(index.coordinates[node * 2], index.coordinates[node * 2 + 1])) {
+                result.push_back(node);
+            }
+        }
+    }
+}
+
+std::unique_ptr<SpatialIndex> SpatialIndex::make_new(const std::vector<double> &coordinates, double nodes_per_cell) {
+    size_t number_of_nodes = coordinates.size() / 2;
+    if (number_of_nodes == 0) {
+        throw "SpatialIndex requires at least one node";
+    }
+    double min[2] = {coordinates[0], coordinates[1]};
+    double max[2] = {coordinates[0], coordinates[1]};
+    for (size_t n = 0; n < number_of_nodes; n++) {
+        for (size_t d = 0; d < 2; d++) {
+            min[d] = std::min(min[d], coordinates[n * 2 + d]);
+            max[d] = std::max(max[d], coordinates[n * 2 + d]);
+        }
+    }
+
+    // cell size such that there are about nodes_per_cell nodes per cell; the lower bound keeps the
+    // number of cells O(number_of_nodes) if the nodes are (nearly) on a line, e.g., y = ±1e-12
+    double width = max[0] - min[0];
+    double height = max[1] - min[1];
+    double cells = std::max(1.0, static_cast<double>(number_of_nodes) / nodes_per_cell);
+    double cell_size = std::max(sqrt(width * height / cells), std::max(width, height) / cells);
+    if (cell_size <= 0.0) {
+        cell_size = 1.0; // coincident nodes
+    }
+    auto index = std::unique_ptr<SpatialIndex>{new SpatialIndex{
+        coordinates,
+        min[0],
+        min[1],
+        cell_size,
+        static_cast<size_t>(width / cell_size) + 1,
+        static_cast<size_t>(height / cell_size) + 1,
+        std::vector<size_t>(),
+        std::vector<size_t>(number_of_nodes),
+    }};
+
+    // counting sort of the nodes by cell
+    size_t ncell = index->ncol * index->nrow;
+    index->cell_pointers.assign(ncell + 1, 0);
+    std::vector<size_t> node_cell(number_of_nodes);
+    for (size_t n = 0; n < number_of_nodes; n++) {
+        node_cell[n] = index->row(coordinates[n * 2 + 1]) * index->ncol + index->column(coordinates[n * 2]);
+        index->cell_pointers[node_cell[n] + 1]++;
+    }
+    for (size_t c = 0; c < ncell; c++) {
+        index->cell_pointers[c + 1] += index->cell_pointers[c];
+    }
+    std::vector<size_t> position(index->cell_pointers.begin(), index->cell_pointers.end() - 1);
+    for (size_t n = 0; n < number_of_nodes; n++) {
+        index->cell_nodes[position[node_cell[n]]++] = n;
+    }
+    return index;
+}
+
+size_t SpatialIndex::column(double x) const {
+    if (x <= xmin) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>((x - xmin) / cell_size), ncol - 1);
+}
+
+size_t SpatialIndex::row(double y) const {
+    if (y <= ymin) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>((y - ymin) / cell_size), nrow - 1);
+}
+
+std::vector<size_t> SpatialIndex::nodes_in_box(double xa, double ya, double xb, double yb) const {
+    std::vector<size_t> result;
+    double x0 = std::min(xa, xb), x1 = std::max(xa, xb);
+    double y0 = std::min(ya, yb), y1 = std::max(ya, yb);
+    size_t c0 = column(x0), c1 = column(x1);
+    for (size_t r = row(y0); r <= row(y1); r++) {
+        collect_nodes(result, *this, r, c0, c1,
+                      [&](double x, double y) { return x >= x0 && x <= x1 && y >= y0 && y <= y1; });
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<size_t> SpatialIndex::nodes_on_segment(double xa, double ya, double xb, double yb,
+                                                   double tolerance) const {
+    std::vector<size_t> result;
+    double dx = xb - xa, dy = yb - ya;
+    double length2 = dx * dx + dy * dy;
+    auto near = [&](double x, double y) {
+        double t = length2 > 0.0 ? std::clamp(((x - xa) * dx + (y - ya) * dy) / length2, 0.0, 1.0) : 0.0;
+        double ex = xa + t * dx - x, ey = ya + t * dy - y;
+        return ex * ex + ey * ey <= tolerance * tolerance;
+    };
+    // visit, row by row, the cells crossed by the segment (expanded by tolerance)
+    size_t r0 = row(std::min(ya, yb) - tolerance), r1 = row(std::max(ya, yb) + tolerance);
+    for (size_t r = r0; r <= r1; r++) {
+        double band_low = ymin + r * cell_size - tolerance;
+        double band_high = ymin + (r + 1) * cell_size + tolerance;
+        double t0 = 0.0, t1 = 1.0;
+        if (dy != 0.0) {
+            double ta = (band_low - ya) / dy, tb = (band_high - ya) / dy;
+            t0 = std::max(0.0, std::min(ta, tb));
+            t1 = std::min(1.0, std::max(ta, tb));
+        }
+        if (t0 > t1) {
+            continue;
+        }
+        double x0 = std::min(xa + t0 * dx, xa + t1 * dx) - tolerance;
+        double x1 = std::max(xa + t0 * dx, xa + t1 * dx) + tolerance;
+        collect_nodes(result, *this, r, column(x0), column(x1), near);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<size_t> SpatialIndex::nodes_on_circle(double xc, double yc, double radius, double tolerance) const {
+    std::vector<size_t> result;
+    double r_low = std::max(0.0, radius - tolerance), r_high = radius + tolerance;
+    auto near = [&](double x, double y) {
+        double d = sqrt((x - xc) * (x - xc) + (y - yc) * (y - yc));
+        return d >= r_low && d <= r_high;
+    };
+    for (size_t r = row(yc - r_high); r <= row(yc + r_high); r++) {
+        for (size_t c = column(xc - r_high); c <= column(xc + r_high); c++) {
+            // skip the cells that do not intersect the annulus
+            double x0 = xmin + c * cell_size, x1 = x0 + cell_size;
+            double y0 = ymin + r * cell_size, y1 = y0 + cell_size;
+            double nx = std::clamp(xc, x0, x1) - xc, ny = std::clamp(yc, y0, y1) - yc;
+            double fx = std::max(fabs(x0 - xc), fabs(x1 - xc)), fy = std::max(fabs(y0 - yc), fabs(y1 - yc));
+            if (nx * nx + ny * ny > r_high * r_high || fx * fx + fy * fy < r_low * r_low) {
+                continue;
+            }
+            collect_nodes(result, *this, r, c, c, near);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<size_t> SpatialIndex::nodes_in_circle(double xc, double yc, double radius) const {
+    std::vector<size_t> result;
+    for (size_t r = row(yc - radius); r <= row(yc + radius); r++) {
+        collect_nodes(result, *this, r, column(xc - radius), column(xc + radius), [&](double x, double y) {
+            return (x - xc) * (x - xc) + (y - yc) * (y - yc) <= radius * radius;
+        });
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+size_t SpatialIndex::nearest_node(double x, double y) const {
+    // search rings of cells around (x, y) until no closer node is possible
+    size_t c = column(x), r = row(y);
+    size_t best = cell_nodes.size();
+    double best_distance2 = 0.0;
+    size_t max_ring = std::max(ncol, nrow);
+    for (size_t ring = 0; ring <= max_ring; ring++) {
+        if (best < cell_nodes.size()) {
+            // distance from (x, y) to the cells of this ring (excluding the point's offset inside its cell)
+            double gap = (static_cast<double>(ring) - 1.0) * cell_size;
+            if (gap > 0.0 && gap * gap > best_distance2) {
+                break;
+            }
+        }
+        size_t r0 = r >= ring ? r - ring : 0, r1 = std::min(r + ring, nrow - 1);
+        size_t c0 = c >= ring ? c - ring : 0, c1 = std::min(c + ring, ncol - 1);
+        for (size_t rr = r0; rr <= r1; rr++) {
+            for (size_t cc = c0; cc <= c1; cc++) {
+                bool on_ring = rr + ring == r || rr == r + ring || cc + ring == c || cc == c + ring;
+                if (!on_ring) {
+                    continue;
+                }
+                size_t cell = rr * ncol + cc;
+                for (size_t p = cell_pointers[cell]; p < cell_pointers[cell + 1]; p++) {
+                    size_t node = cell_nodes[p];
+                    double dx = coordinates[node * 2] - x, dy = coordinates[node * 2 + 1] - y;
+                    double d2 = dx * dx + dy * dy;
+                    if (best == cell_nodes.size() || d2 < best_distance2 || (d2 == best_distance2 && node < best)) {
+                        best = node;
+                        best_distance2 = d2;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+std::vector<size_t> SpatialIndex::nearest_nodes(const std::vector<double> &points) const {
+    size_t npoint = points.size() / 2;
+    std::vector<size_t> result(npoint);
+#pragma omp parallel for
+    for (size_t i = 0; i < npoint; i++) {
+        result[i] = nearest_node(points[i * 2], points[i * 2 + 1]);
+    }
+    return result;
+}
+
+void insert_bcs(std::map<node_dof_pair_t, double> &bcs, const std::vector<size_t> &nodes, LocalDOF dof, double value) {
+    auto hint = bcs.end();
+    for (auto node : nodes) {
+        hint = bcs.insert_or_assign(hint, {node, dof}, value);
+    }
+}
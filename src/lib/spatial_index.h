@@ -0,0 +1,64 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "fem2d.h"
+
+/// @brief Implements a uniform grid over the nodes for geometric queries
+///
+/// The nodes are sorted by grid cell (counting sort); thus, a query only visits the cells
+/// touched by the shape instead of scanning all nodes. All queries return sorted node lists.
+struct SpatialIndex {
+    /// @brief Holds the coordinates x0 y0  x1 y1  ...  xnn ynn (must outlive the index)
+    const std::vector<double> &coordinates;
+
+    /// @brief Lower-left corner of the grid
+    double xmin, ymin;
+
+    /// @brief Side length of the (square) cells
+    double cell_size;
+
+    /// @brief Number of cells along x and y
+    size_t ncol, nrow;
+
+    /// @brief Row pointers of cell → nodes (size = ncol * nrow + 1)
+    std::vector<size_t> cell_pointers;
+
+    /// @brief Nodes of each cell (size = number_of_nodes)
+    std::vector<size_t> cell_nodes;
+
+    /// @brief Allocates a new index
+    /// @param coordinates x0 y0  x1 y1  ...  xnn ynn (size = 2 * number_of_nodes)
+    /// @param nodes_per_cell Average number of nodes per cell (controls the cell size)
+    static std::unique_ptr<SpatialIndex> make_new(const std::vector<double> &coordinates, double nodes_per_cell = 4.0);
+
+    /// @brief Returns the nodes inside the box [xa, xb] × [ya, yb]
+    std::vector<size_t> nodes_in_box(double xa, double ya, double xb, double yb) const;
+
+    /// @brief Returns the nodes whose distance to the segment (xa, ya) → (xb, yb) is at most tolerance
+    std::vector<size_t> nodes_on_segment(double xa, double ya, double xb, double yb, double tolerance) const;
+
+    /// @brief Returns the nodes whose distance to the center (xc, yc) differs from radius by at most tolerance
+    std::vector<size_t> nodes_on_circle(double xc, double yc, double radius, double tolerance) const;
+
+    /// @brief Returns the nodes whose distance to the center (xc, yc) is at most radius
+    std::vector<size_t> nodes_in_circle(double xc, double yc, double radius) const;
+
+    /// @brief Returns the node closest to (x, y)
+    size_t nearest_node(double x, double y) const;
+
+    /// @brief Returns the nodes closest to each point (in parallel)
+    /// @param points x0 y0  x1 y1  ...  (size = 2 * number of points)
+    std::vector<size_t> nearest_nodes(const std::vector<double> &points) const;
+
+    /// @brief Returns the cell column of x (clamped to the grid)
+    size_t column(double x) const;
+
+    /// @brief Returns the cell row of y (clamped to the grid)
+    size_t row(double y) const;
+};
+
+/// @brief Adds the same prescribed value to one DOF of all nodes (e.g., the nodes returned by SpatialIndex)
+void insert_bcs(std::map<node_dof_pair_t, double> &bcs, const std::vector<size_t> &nodes, LocalDOF dof, double value);
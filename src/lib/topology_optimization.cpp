@@ -0,0 +1,334 @@
+#include <cmath>
+
+#include "parametric_assembly.h"
+#include "sensitivity.h"
+#include "solver_pardiso.h"
+#include "topology_optimization.h"
+
+/// @brief Calculates the area and centroid of each triangle
+inline void calculate_areas_and_centroids(std::vector<double> &areas,
+                                          std::vector<double> &centroids,
+                                          const std::vector<double> &coordinates,
+                                          const std::vector<size_t> &connectivity) {
+    size_t ncell = connectivity.size() / 3;
+    areas.resize(ncell);
+    centroids.resize(2 * ncell);
+    for (size_t e = 0; e < ncell; e++) {
+        const size_t *c = &connectivity[e * 3];
+        double x0 = coordinates[c[0] * 2], y0 = coordinates[c[0] * 2 + 1];
+        double x1 = coordinates[c[1] * 2], y1 = coordinates[c[1] * 2 + 1];
+        double x2 = coordinates[c[2] * 2], y2 = coordinates[c[2] * 2 + 1];
+        areas[e] = ((x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0)) / 2.0;
+        centroids[e * 2] = (x0 + x1 + x2) / 3.0;
+        centroids[e * 2 + 1] = (y0 + y1 + y2) / 3.0;
+    }
+}
+
+/// @brief Finds the elements whose centroids lie within the radius by walking the element neighbors from e
+/// @param found (output) the elements; found[0] = e (also used as the queue of the walk)
+/// @param distances (output) r - |cₑ - cⱼ| of each element found
+/// @param visited (input/output) per-thread markers (size = number_of_elements; visited[j] = e if j was tested)
+inline void find_filter_neighborhood(std::vector<size_t> &found,
+                                     std::vector<double> &distances,
+                                     std::vector<size_t> &visited,
+                                     size_t e,
+                                     const std::vector<double> &centroids,
+                                     const MeshTopology &topology,
+                                     double radius) {
+    found.assign(1, e);
+    distances.assign(1, radius > 0.0 ? radius : 1.0);
+    if (radius <= 0.0) {
+        return;
+    }
+    visited[e] = e;
+    for (size_t k = 0; k < found.size(); k++) {
+        size_t a = found[k];
+        for (size_t p = topology.element_neighbor_pointers[a]; p < topology.element_neighbor_pointers[a + 1]; p++) {
+            size_t b = topology.element_neighbors[p];
+            if (visited[b] == e) {
+                continue;
+            }
+            visited[b] = e;
+            double dx = centroids[b * 2] - centroids[e * 2];
+            double dy = centroids[b * 2 + 1] - centroids[e * 2 + 1];
+            double d = sqrt(dx * dx + dy * dy);
+            if (d < radius) {
+                found.push_back(b);
+                distances.push_back(radius - d);
+            }
+        }
+    }
+}
+
+std::unique_ptr<DensityFilter> DensityFilter::make_new(const std::vector<double> &coordinates,
+                                                       const std::vector<size_t> &connectivity,
+                                                       const MeshTopology &topology,
+                                                       double radius) {
+    size_t ncell = connectivity.size() / 3;
+    if (topology.element_num_node != 3 || topology.number_of_elements != ncell) {
+        throw "DensityFilter requires the topology of the mesh of triangles";
+    }
+    std::vector<double> areas, centroids;
+    calculate_areas_and_centroids(areas, centroids, coordinates, connectivity);
+    auto filter = std::unique_ptr<DensityFilter>{new DensityFilter{
+        std::vector<size_t>(ncell + 1, 0),
+        std::vector<size_t>{},
+        std::vector<double>{},
+        std::vector<size_t>(ncell + 1, 0),
+        std::vector<size_t>{},
+        std::vector<double>{},
+    }};
+
+    // first pass: size of each neighborhood
+#pragma omp parallel
+    {
+        std::vector<size_t> found, visited(ncell, ncell);
+        std::vector<double> distances;
+#pragma omp for
+        for (size_t e = 0; e < ncell; e++) {
+            find_filter_neighborhood(found, distances, visited, e, centroids, topology, radius);
+            filter->pointers[e + 1] = found.size();
+        }
+    }
+    for (size_t e = 0; e < ncell; e++) {
+        filter->pointers[e + 1] += filter->pointers[e];
+    }
+    size_t nnz = filter->pointers[ncell];
+    filter->indices.resize(nnz);
+    filter->weights.resize(nnz);
+
+    // second pass: normalized weights (r - dₑⱼ) ⋅ Aⱼ / Σₖ (r - dₑₖ) ⋅ Aₖ
+#pragma omp parallel
+    {
+        std::vector<size_t> found, visited(ncell, ncell);
+        std::vector<double> distances;
+#pragma omp for
+        for (size_t e = 0; e < ncell; e++) {
+            find_filter_neighborhood(found, distances, visited, e, centroids, topology, radius);
+            double sum = 0.0;
+            for (size_t k = 0; k < found.size(); k++) {
+                sum += distances[k] * areas[found[k]];
+            }
+            size_t start = filter->pointers[e];
+            for (size_t k = 0; k < found.size(); k++) {
+                filter->indices[start + k] = found[k];
+                filter->weights[start + k] = distances[k] * areas[found[k]] / sum;
+            }
+        }
+    }
+
+    // transpose (counting sort; the rows of the transpose come out sorted)
+    for (size_t p = 0; p < nnz; p++) {
+        filter->transposed_pointers[filter->indices[p] + 1]++;
+    }
+    for (size_t e = 0; e < ncell; e++) {
+        filter->transposed_pointers[e + 1] += filter->transposed_pointers[e];
+    }
+    filter->transposed_indices.resize(nnz);
+    filter->transposed_weights.resize(nnz);
+    std::vector<size_t> next(filter->transposed_pointers.begin(), filter->transposed_pointers.end() - 1);
+    for (size_t e = 0; e < ncell; e++) {
+        for (size_t p = filter->pointers[e]; p < filter->pointers[e + 1]; p++) {
+            size_t q = next[filter->indices[p]]++;
+            filter->transposed_indices[q] = e;
+            filter->transposed_weights[q] = filter->weights[p];
+        }
+    }
+    return filter;
+}
+
+void DensityFilter::apply(std::vector<double> &filtered, const std::vector<double> &x) const {
+    size_t ncell = pointers.size() - 1;
+    filtered.resize(ncell);
+#pragma omp parallel for
+    for (size_t e = 0; e < ncell; e++) {
+        double sum = 0.0;
+        for (size_t p = pointers[e]; p < pointers[e + 1]; p++) {
+            sum += weights[p] * x[indices[p]];
+        }
+        filtered[e] = sum;
+    }
+}
+
+void DensityFilter::apply_transpose(std::vector<double> &gradient,
+                                    const std::vector<double> &filtered_gradient) const {
+    size_t ncell = transposed_pointers.size() - 1;
+    gradient.resize(ncell);
+#pragma omp parallel for
+    for (size_t e = 0; e < ncell; e++) {
+        double sum = 0.0;
+        for (size_t p = transposed_pointers[e]; p < transposed_pointers[e + 1]; p++) {
+            sum += transposed_weights[p] * filtered_gradient[transposed_indices[p]];
+        }
+        gradient[e] = sum;
+    }
+}
+
+void TopologyOptimization::calculate_simp_young(std::vector<double> &param_young,
+                                                std::vector<double> &derivatives,
+                                                const std::vector<double> &young_solid,
+                                                const std::vector<double> &physical,
+                                                const TopologyOptions &options) {
+    size_t ncell = young_solid.size();
+    param_young.resize(ncell);
+    derivatives.resize(ncell);
+    double p = options.penalty;
+    for (size_t e = 0; e < ncell; e++) {
+        double range = young_solid[e] * (1.0 - options.young_min_ratio);
+        param_young[e] = young_solid[e] * options.young_min_ratio + pow(physical[e], p) * range;
+        derivatives[e] = p * pow(physical[e], p - 1.0) * range;
+    }
+}
+
+/// @brief Updates the densities with the optimality criteria: xₑ ← clamp(xₑ ⋅ √(-dCₑ / (λ ⋅ dVₑ)))
+///
+/// The multiplier λ is found by bisection such that the volume of the filtered densities equals the target.
+///
+/// @param x_new (output) the new densities
+/// @param physical_new (output) the new filtered densities
+/// @return The maximum change of the densities
+inline double update_optimality_criteria(std::vector<double> &x_new,
+                                         std::vector<double> &physical_new,
+                                         const std::vector<double> &x,
+                                         const std::vector<double> &dc,
+                                         const std::vector<double> &dv,
+                                         const std::vector<double> &areas,
+                                         const DensityFilter &filter,
+                                         double target_volume,
+                                         double move) {
+    size_t ncell = x.size();
+    x_new.resize(ncell);
+    auto update = [&](double lambda) {
+#pragma omp parallel for
+        for (size_t e = 0; e < ncell; e++) {
+            double value = x[e] * sqrt(fmax(0.0, -dc[e]) / (dv[e] * lambda));
+            x_new[e] = fmax(fmax(0.0, x[e] - move), fmin(fmin(1.0, x[e] + move), value));
+        }
+        filter.apply(physical_new, x_new);
+        double volume = 0.0;
+#pragma omp parallel for reduction(+ : volume)
+        for (size_t e = 0; e < ncell; e++) {
+            volume += areas[e] * physical_new[e];
+        }
+        return volume;
+    };
+
+    // the volume decreases with λ: bracket and bisect (l2 always satisfies the constraint)
+    double l1 = 0.0;
+    double l2 = 0.0;
+    for (size_t e = 0; e < ncell; e++) {
+        l2 = fmax(l2, -dc[e] / dv[e]);
+    }
+    if (l2 <= 0.0) {
+        l2 = 1.0;
+    }
+    for (size_t k = 0; k < 200 && update(l2) > target_volume; k++) {
+        l2 *= 2.0;
+    }
+    while (l2 - l1 > 1e-9 * (l1 + l2)) {
+        double middle = (l1 + l2) / 2.0;
+        if (update(middle) > target_volume) {
+            l1 = middle;
+        } else {
+            l2 = middle;
+        }
+    }
+    update(l2);
+
+    double change = 0.0;
+    for (size_t e = 0; e < ncell; e++) {
+        change = fmax(change, fabs(x_new[e] - x[e]));
+    }
+    return change;
+}
+
+std::unique_ptr<TopologyOptimization> TopologyOptimization::make_new(Fem2d &fem,
+                                                                     const MeshTopology &topology,
+                                                                     const TopologyOptions &options) {
+    if (!fem.solid_triangle) {
+        throw "TopologyOptimization works with tri3 only";
+    }
+    if (options.volume_fraction <= 0.0 || options.volume_fraction > 1.0) {
+        throw "the volume fraction must be in (0, 1]";
+    }
+    if (options.penalty < 1.0) {
+        throw "the SIMP penalty must be at least 1";
+    }
+    if (options.young_min_ratio <= 0.0 || options.young_min_ratio >= 1.0) {
+        throw "the minimum Young's modulus ratio must be in (0, 1)";
+    }
+    if (options.move_limit <= 0.0) {
+        throw "the move limit must be positive";
+    }
+    for (size_t i = 0; i < fem.total_ndof; i++) {
+        if (fem.essential_prescribed[i] && fem.essential_boundary_conditions[i] != 0.0) {
+            throw "TopologyOptimization requires zero prescribed displacements";
+        }
+    }
+    size_t ncell = fem.number_of_elements;
+    auto optimization = std::unique_ptr<TopologyOptimization>{new TopologyOptimization{
+        DensityFilter::make_new(fem.coordinates, fem.connectivity, topology, options.filter_radius),
+        std::vector<double>{},                               // areas
+        std::vector<double>(ncell, options.volume_fraction), // densities
+        std::vector<double>(ncell, options.volume_fraction), // physical_densities
+        std::vector<TopologyIteration>{},
+        false, // converged
+    }};
+    auto &areas = optimization->areas;
+    auto &x = optimization->densities;
+    auto &physical = optimization->physical_densities;
+    const auto &filter = *optimization->filter;
+    std::vector<double> centroids;
+    calculate_areas_and_centroids(areas, centroids, fem.coordinates, fem.connectivity);
+    double total_area = 0.0;
+    for (auto area : areas) {
+        total_area += area;
+    }
+
+    // symbolic work done once: pattern, scatter, unit element stiffnesses, and the PARDISO analysis
+    auto young_solid = fem.param_young;
+    auto assembly = ParametricAssembly::make_new(fem);
+    auto kk = assembly->new_matrix();
+    auto solver = SolverPardiso::make_new(*PardisoOptions::make_new());
+
+    std::vector<double> young, dyoung, rhs, dc_physical, dc, dv, x_new, physical_new;
+    filter.apply_transpose(dv, areas); // dV/dx = Wᵀ ⋅ A
+    fem.uu.resize(fem.total_ndof);
+    for (size_t iteration = 0; iteration < options.max_iterations; iteration++) {
+        // analysis
+        calculate_simp_young(young, dyoung, young_solid, physical, options);
+        assembly->assemble(kk->values, rhs, young);
+        solver->factorize(*kk);
+        solver->solve(fem.uu, rhs);
+        double compliance = 0.0;
+        double volume = 0.0;
+        for (size_t i = 0; i < fem.total_ndof; i++) {
+            compliance += fem.natural_boundary_conditions[i] * fem.uu[i];
+        }
+        for (size_t e = 0; e < ncell; e++) {
+            volume += areas[e] * physical[e];
+        }
+
+        // dC/dx = Wᵀ ⋅ (dC/dEₑ ⋅ dEₑ/dx̃ₑ) with λ = u (self-adjoint)
+        calculate_element_sensitivities(fem, fem.uu, SENSITIVITY_YOUNG, dc_physical);
+        for (size_t e = 0; e < ncell; e++) {
+            dc_physical[e] *= dyoung[e];
+        }
+        filter.apply_transpose(dc, dc_physical);
+
+        // update
+        double change = update_optimality_criteria(x_new, physical_new, x, dc, dv, areas, filter,
+                                                   options.volume_fraction * total_area, options.move_limit);
+        optimization->history.push_back(TopologyIteration{compliance, volume / total_area, change});
+        x.swap(x_new);
+        physical.swap(physical_new);
+        if (change < options.tolerance) {
+            optimization->converged = true;
+            break;
+        }
+    }
+
+    calculate_simp_young(young, dyoung, young_solid, physical, options);
+    fem.set_param_young(young);
+    return optimization;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "fem2d.h"
+#include "mesh_topology.h"
+
+/// @brief Holds the options of the SIMP topology optimization
+struct TopologyOptions {
+    /// @brief Target ratio between the material volume and the volume of the design domain
+    double volume_fraction;
+
+    /// @brief SIMP penalty p in Eₑ = Eminₑ + x̃ₑᵖ ⋅ (E0ₑ - Eminₑ)
+    double penalty;
+
+    /// @brief Ratio Eminₑ / E0ₑ of the void material (keeps the stiffness non-singular)
+    double young_min_ratio;
+
+    /// @brief Radius of the density filter (distance between centroids); ≤ 0 disables the filter
+    double filter_radius;
+
+    /// @brief Maximum change of a density in one update
+    double move_limit;
+
+    /// @brief Maximum number of iterations
+    size_t max_iterations;
+
+    /// @brief The optimization stops when the maximum change of the densities is smaller than this
+    double tolerance;
+
+    /// @brief Allocates a new TopologyOptions structure with default values
+    inline static std::unique_ptr<TopologyOptions> make_new() {
+        return std::unique_ptr<TopologyOptions>{new TopologyOptions{
+            0.5,  // volume_fraction
+            3.0,  // penalty
+            1e-9, // young_min_ratio
+            0.0,  // filter_radius
+            0.2,  // move_limit
+            200,  // max_iterations
+            0.01, // tolerance
+        }};
+    }
+};
+
+/// @brief Implements the density filter x̃ₑ = Σⱼ wₑⱼ ⋅ xⱼ with wₑⱼ ∝ (r - |cₑ - cⱼ|) ⋅ Aⱼ and Σⱼ wₑⱼ = 1
+///
+/// The neighborhood of each element is found by walking the element-neighbor adjacency of the topology
+/// from the element itself, keeping the elements whose centroids lie within the radius. The weights of
+/// each row are normalized; thus, the filter preserves constant fields. The transpose (for the chain rule
+/// of the sensitivities) is stored as well, so that both products run in parallel without conflicts.
+struct DensityFilter {
+    /// @brief Row pointers of the weights (size = number_of_elements + 1)
+    std::vector<size_t> pointers;
+
+    /// @brief Column (element) of each weight
+    std::vector<size_t> indices;
+
+    /// @brief Normalized weights
+    std::vector<double> weights;
+
+    /// @brief Row pointers of the transposed weights (size = number_of_elements + 1)
+    std::vector<size_t> transposed_pointers;
+
+    /// @brief Column (element) of each transposed weight
+    std::vector<size_t> transposed_indices;
+
+    /// @brief Transposed weights
+    std::vector<double> transposed_weights;
+
+    /// @brief Allocates a new filter for a mesh of triangles
+    /// @param coordinates The coordinates (size = 2 * number_of_nodes)
+    /// @param connectivity The connectivity (size = 3 * number_of_elements)
+    /// @param topology The topology of the mesh (element_neighbors)
+    /// @param radius The radius; ≤ 0 gives the identity
+    static std::unique_ptr<DensityFilter> make_new(const std::vector<double> &coordinates,
+                                                   const std::vector<size_t> &connectivity,
+                                                   const MeshTopology &topology,
+                                                   double radius);
+
+    /// @brief Calculates the filtered field x̃ = W ⋅ x
+    void apply(std::vector<double> &filtered, const std::vector<double> &x) const;
+
+    /// @brief Calculates the derivatives with respect to x from the derivatives with respect to x̃ (Wᵀ ⋅ g̃)
+    void apply_transpose(std::vector<double> &gradient, const std::vector<double> &filtered_gradient) const;
+};
+
+/// @brief Holds the summary of one iteration of the topology optimization
+struct TopologyIteration {
+    /// @brief Compliance fᵀ ⋅ u of the analyzed design
+    double compliance;
+
+    /// @brief Volume fraction of the analyzed (filtered) design
+    double volume_fraction;
+
+    /// @brief Maximum change of the densities in the update following the analysis
+    double change;
+};
+
+/// @brief Minimizes the compliance of a mesh of triangles subject to a volume constraint (SIMP)
+///
+/// The Young's moduli of the problem are the moduli E0ₑ of the solid material. Each iteration filters the
+/// densities, reassembles the global stiffness on the fixed pattern of a ParametricAssembly, refactorizes
+/// (the PARDISO analysis of the first iteration is reused), solves, evaluates the compliance sensitivities
+/// in parallel (calculate_element_sensitivities), and updates the densities with the optimality criteria
+/// (OC) method, finding the Lagrange multiplier of the volume constraint by bisection.
+struct TopologyOptimization {
+    /// @brief The density filter
+    std::unique_ptr<DensityFilter> filter;
+
+    /// @brief Element areas
+    std::vector<double> areas;
+
+    /// @brief Final design densities x (size = number_of_elements)
+    std::vector<double> densities;
+
+    /// @brief Final filtered (physical) densities x̃ (size = number_of_elements)
+    std::vector<double> physical_densities;
+
+    /// @brief The summary of each iteration
+    std::vector<TopologyIteration> history;
+
+    /// @brief Indicates that the change of the densities became smaller than the tolerance
+    bool converged;
+
+    /// @brief Runs the optimization
+    /// @param fem The problem (tri3; zero prescribed displacements). On return, its Young's moduli are those
+    ///        of the final physical densities (solve it to analyze the final design)
+    /// @param topology The topology of the mesh
+    /// @param options The options
+    static std::unique_ptr<TopologyOptimization> make_new(Fem2d &fem,
+                                                          const MeshTopology &topology,
+                                                          const TopologyOptions &options);
+
+    /// @brief Calculates the SIMP Young's moduli and their derivatives with respect to the physical densities
+    /// @param param_young (output) the Young's moduli (size = number_of_elements)
+    /// @param derivatives (output) dEₑ/dx̃ₑ (size = number_of_elements)
+    /// @param young_solid The moduli E0ₑ of the solid material
+    /// @param physical The physical densities x̃
+    static void calculate_simp_young(std::vector<double> &param_young,
+                                     std::vector<double> &derivatives,
+                                     const std::vector<double> &young_solid,
+                                     const std::vector<double> &physical,
+                                     const TopologyOptions &options);
+};
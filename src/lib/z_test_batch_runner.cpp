@@ -0,0 +1,111 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "batch_runner.h"
+#include "constants.h"
+#include "laclib.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("batch_runner") {
+    // Felippa's three-member truss (see z_test_truss2d)
+    auto felippa = BatchModel{
+        false, // solid_triangle
+        false, // plane_stress
+        1.0,   // thickness
+        vector<double>{0.0, 0.0, 10.0, 0.0, 10.0, 10.0},
+        vector<size_t>{0, 1, 1, 2, 2, 0},
+        vector<double>{100.0, 50.0, 200.0},
+        vector<double>{},
+        vector<double>{1.0, 1.0, SQRT_2},
+        map<node_dof_pair_t, double>{{{0, AlongX}, 0.0}, {{0, AlongY}, 0.0}, {{1, AlongY}, 0.0}},
+        map<node_dof_pair_t, double>{{{2, AlongX}, 2.0}, {{2, AlongY}, 1.0}},
+    };
+
+    // Smith's Example 5.2 (see z_test_solid2d)
+    auto smith = BatchModel{
+        true,  // solid_triangle
+        false, // plane_stress
+        1.0,   // thickness
+        vector<double>{0.0, 0.0, 0.5, 0.0, 1.0, 0.0, 0.0, -0.5, 0.5, -0.5, 1.0, -0.5, 0.0, -1.0, 0.5, -1.0, 1.0, -1.0},
+        vector<size_t>{1, 0, 3, 3, 4, 1, 2, 1, 4, 4, 5, 2, 4, 3, 6, 6, 7, 4, 5, 4, 7, 7, 8, 5},
+        vector<double>(8, 1e6),
+        vector<double>(8, 0.3),
+        vector<double>{},
+        map<node_dof_pair_t, double>{
+            {{0, AlongX}, 0.0},
+            {{3, AlongX}, 0.0},
+            {{6, AlongX}, 0.0},
+            {{6, AlongY}, 0.0},
+            {{7, AlongY}, 0.0},
+            {{8, AlongY}, 0.0}},
+        map<node_dof_pair_t, double>{{{0, AlongY}, -0.25}, {{1, AlongY}, -0.5}, {{2, AlongY}, -0.25}},
+    };
+
+    SUBCASE("variants of the load") {
+        // the response is proportional to the load factor
+        size_t nvariant = 200;
+        vector<BatchModel> models;
+        for (size_t i = 0; i < nvariant; i++) {
+            auto model = i % 2 == 0 ? felippa : smith;
+            double factor = 1.0 + static_cast<double>(i / 2);
+            for (auto &[key, value] : model.natural_bcs) {
+                value *= factor;
+            }
+            models.push_back(model);
+        }
+        auto options = BatchOptions::make_new();
+        options->number_of_threads = 4;
+        auto results = solve_batch(models, *options);
+        REQUIRE(results.size() == nvariant);
+
+        auto felippa_uu = vector<double>{0.0, 0.0, 0.0, 0.0, 0.4, -0.2};
+        auto felippa_reactions = vector<double>{-2.0, -2.0, 0.0, 1.0, 0.0, 0.0};
+        auto smith_uy_top = -9.1e-7;
+        for (size_t i = 0; i < nvariant; i++) {
+            double factor = 1.0 + static_cast<double>(i / 2);
+            CHECK(results[i].success);
+            CHECK(results[i].seconds >= 0.0);
+            CHECK(results[i].equilibrium.relative_error < 1e-14);
+            if (i % 2 == 0) {
+                for (size_t k = 0; k < 6; k++) {
+                    CHECK(fabs(results[i].uu[k] - factor * felippa_uu[k]) < 1e-14 * factor);
+                    CHECK(fabs(results[i].reactions[k] - factor * felippa_reactions[k]) < 1e-13 * factor);
+                }
+            } else {
+                CHECK(results[i].uu.size() == 18);
+                CHECK(fabs(results[i].uu[1] - factor * smith_uy_top) < 1e-15 * factor);
+                CHECK(fabs(results[i].reactions[6 * 2 + 1] - factor * 0.25) < 1e-14 * factor);
+            }
+        }
+
+        // the same results with one thread and without reactions
+        options->number_of_threads = 1;
+        options->with_reactions = false;
+        auto serial = solve_batch(models, *options);
+        for (size_t i = 0; i < nvariant; i++) {
+            CHECK(serial[i].uu == results[i].uu);
+            CHECK(serial[i].reactions.empty());
+        }
+    }
+
+    SUBCASE("failures do not stop the batch") {
+        auto wrong = felippa;
+        wrong.param_young.pop_back();
+        auto out_of_range = smith;
+        out_of_range.natural_bcs[{9, AlongX}] = 1.0;
+        auto results = solve_batch(vector<BatchModel>{felippa, wrong, out_of_range, smith}, *BatchOptions::make_new());
+        CHECK(results[0].success);
+        CHECK(!results[1].success);
+        CHECK(results[1].error == "BatchModel requires one Young's modulus per element");
+        CHECK(!results[2].success);
+        CHECK(results[2].error == "BatchModel has a boundary condition out of range");
+        CHECK(results[3].success);
+    }
+}
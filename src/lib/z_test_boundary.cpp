@@ -0,0 +1,126 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "boundary.h"
+#include "fem2d.h"
+#include "laclib.h"
+#include "mesh_topology.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("boundary") {
+    // Smith's Example 5.2 (see examples/smith_plane_strain_5dot2.cpp)
+    auto coordinates = vector<double>{
+        0.0, 0.0,   // 0
+        0.5, 0.0,   // 1
+        1.0, 0.0,   // 2
+        0.0, -0.5,  // 3
+        0.5, -0.5,  // 4
+        1.0, -0.5,  // 5
+        0.0, -1.0,  // 6
+        0.5, -1.0,  // 7
+        1.0, -1.0}; // 8
+    auto connectivity = vector<size_t>{
+        1, 0, 3,  // 0
+        3, 4, 1,  // 1
+        2, 1, 4,  // 2
+        4, 5, 2,  // 3
+        4, 3, 6,  // 4
+        6, 7, 4,  // 5
+        5, 4, 7,  // 6
+        7, 8, 5}; // 7
+    auto topology = MeshTopology::make_new(9, connectivity, 3);
+    auto boundary = BoundaryEdges::make_new(coordinates, connectivity, *topology);
+
+    SUBCASE("boundary edges") {
+        CHECK(boundary->size() == 8);
+        CHECK(boundary->unique_nodes() == vector<size_t>{0, 1, 2, 3, 5, 6, 7, 8});
+
+        // the outward normals point away from the center (0.5, -0.5)
+        for (size_t i = 0; i < boundary->size(); i++) {
+            size_t a = boundary->nodes[i * 2];
+            size_t b = boundary->nodes[i * 2 + 1];
+            double nx = coordinates[b * 2 + 1] - coordinates[a * 2 + 1];
+            double ny = coordinates[a * 2] - coordinates[b * 2];
+            double mx = (coordinates[a * 2] + coordinates[b * 2]) / 2.0 - 0.5;
+            double my = (coordinates[a * 2 + 1] + coordinates[b * 2 + 1]) / 2.0 + 0.5;
+            CHECK(nx * mx + ny * my > 0.0);
+        }
+    }
+
+    SUBCASE("selection") {
+        auto top = boundary->select(coordinates, [](double x, double y) { return fabs(y) < 1e-10; });
+        CHECK(top->size() == 2);
+        CHECK(top->unique_nodes() == vector<size_t>{0, 1, 2});
+
+        auto attributes = vector<size_t>{1, 1, 2, 2, 1, 1, 1, 1};
+        auto right_top = boundary->select_by_attribute(attributes, 2);
+        CHECK(right_top->size() == 2); // edges (1,2) of element 2 and (5,2) of element 3
+        CHECK(right_top->unique_nodes() == vector<size_t>{1, 2, 5});
+    }
+
+    SUBCASE("pressure and traction loads") {
+        auto top = boundary->select(coordinates, [](double x, double y) { return fabs(y) < 1e-10; });
+        auto forces = vector<double>(18, 0.0);
+        top->add_pressure_loads(forces, coordinates, 1.0, 1.0);
+        auto correct = vector<double>(18, 0.0);
+        correct[0 * 2 + 1] = -0.25;
+        correct[1 * 2 + 1] = -0.5;
+        correct[2 * 2 + 1] = -0.25;
+        CHECK(equal_vectors_tol(forces, correct, 1e-15));
+
+        // the same load as a traction vector and as a (constant) variable pressure
+        fill(forces.begin(), forces.end(), 0.0);
+        top->add_traction_loads(forces, coordinates, 0.0, -1.0, 1.0);
+        CHECK(equal_vectors_tol(forces, correct, 1e-15));
+        fill(forces.begin(), forces.end(), 0.0);
+        top->add_variable_pressure_loads(forces, coordinates, [](double x, double y) { return 1.0; }, 1.0);
+        CHECK(equal_vectors_tol(forces, correct, 1e-15));
+
+        // linear pressure p = x: the resultant is ∫ x dx = 0.5 acting at x = 2/3
+        fill(forces.begin(), forces.end(), 0.0);
+        top->add_variable_pressure_loads(forces, coordinates, [](double x, double y) { return x; }, 1.0);
+        double resultant = forces[1] + forces[3] + forces[5];
+        double moment = forces[3] * 0.5 + forces[5] * 1.0;
+        CHECK(fabs(resultant + 0.5) < 1e-15);
+        CHECK(fabs(moment / resultant - 2.0 / 3.0) < 1e-15);
+    }
+
+    SUBCASE("Smith's Example 5.2 with pressure loads") {
+        map<node_dof_pair_t, double> essential_bcs{
+            {{0, AlongX}, 0.0},
+            {{3, AlongX}, 0.0},
+            {{6, AlongX}, 0.0},
+            {{6, AlongY}, 0.0},
+            {{7, AlongY}, 0.0},
+            {{8, AlongY}, 0.0}};
+        auto fem = Fem2d::make_new(true, false, 1.0, true, false,
+                                   coordinates,
+                                   connectivity,
+                                   vector<double>(8, 1e6),
+                                   vector<double>(8, 0.3),
+                                   vector<double>{},
+                                   essential_bcs,
+                                   map<node_dof_pair_t, double>{});
+        auto top = boundary->select(coordinates, [](double x, double y) { return fabs(y) < 1e-10; });
+        top->add_pressure_loads(fem->natural_boundary_conditions, coordinates, 1.0, fem->thickness);
+        fem->solve();
+        auto correct_uu = vector<double>{
+            0.000000000000000e+00, -9.100000000000005e-07, // 0
+            1.950000000000001e-07, -9.100000000000006e-07, // 1
+            3.900000000000002e-07, -9.100000000000000e-07, // 2
+            0.000000000000000e+00, -4.550000000000002e-07, // 3
+            1.950000000000002e-07, -4.550000000000004e-07, // 4
+            3.900000000000004e-07, -4.549999999999999e-07, // 5
+            0.000000000000000e+00, 0.000000000000000e+00,  // 6
+            1.950000000000004e-07, 0.000000000000000e+00,  // 7
+            3.900000000000004e-07, 0.000000000000000e+00}; // 8
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+    }
+}
@@ -0,0 +1,119 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "element_matrix_store.h"
+#include "element_stiffness.h"
+#include "fem2d.h"
+#include "laclib.h"
+#include "matrix_free.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("element_matrix_store") {
+    // Smith's Example 5.2 (see z_test_solid2d.cpp)
+    auto coordinates = vector<double>{
+        0.0, 0.0,   // 0
+        0.5, 0.0,   // 1
+        1.0, 0.0,   // 2
+        0.0, -0.5,  // 3
+        0.5, -0.5,  // 4
+        1.0, -0.5,  // 5
+        0.0, -1.0,  // 6
+        0.5, -1.0,  // 7
+        1.0, -1.0}; // 8
+    auto connectivity = vector<size_t>{
+        1, 0, 3,  // 0
+        3, 4, 1,  // 1
+        2, 1, 4,  // 2
+        4, 5, 2,  // 3
+        4, 3, 6,  // 4
+        6, 7, 4,  // 5
+        5, 4, 7,  // 6
+        7, 8, 5}; // 7
+    auto param_young = vector<double>(8, 1e6);
+    auto param_poisson = vector<double>(8, 0.3);
+    auto param_cross_area = vector<double>{};
+    map<node_dof_pair_t, double> essential_bcs{
+        {{0, AlongX}, 0.0},
+        {{3, AlongX}, 0.0},
+        {{6, AlongX}, 0.0},
+        {{6, AlongY}, 0.0},
+        {{7, AlongY}, 0.0},
+        {{8, AlongY}, 0.0}};
+    map<node_dof_pair_t, double> natural_bcs{
+        {{0, AlongY}, -0.25},
+        {{1, AlongY}, -0.50},
+        {{2, AlongY}, -0.25}};
+    auto correct_uu = vector<double>{
+        0.000000000000000e+00, -9.100000000000005e-07, // 0
+        1.950000000000001e-07, -9.100000000000006e-07, // 1
+        3.900000000000002e-07, -9.100000000000000e-07, // 2
+        0.000000000000000e+00, -4.550000000000002e-07, // 3
+        1.950000000000002e-07, -4.550000000000004e-07, // 4
+        3.900000000000004e-07, -4.549999999999999e-07, // 5
+        0.000000000000000e+00, 0.000000000000000e+00,  // 6
+        1.950000000000004e-07, 0.000000000000000e+00,  // 7
+        3.900000000000004e-07, 0.000000000000000e+00}; // 8
+
+    auto fem = Fem2d::make_new(true, false, 1.0, false, false,
+                               coordinates,
+                               connectivity,
+                               param_young,
+                               param_poisson,
+                               param_cross_area,
+                               essential_bcs,
+                               natural_bcs);
+
+    SUBCASE("the store is switched off above the memory budget") {
+        size_t required = ElementMatrixStore::memory_required(PACKED_SIZE_SOLID_TRIANGLE, 8);
+        CHECK(required == 21 * 8 * 8); // 1344 bytes (already a multiple of the alignment)
+        CHECK(ElementMatrixStore::memory_required(PACKED_SIZE_ELASTIC_ROD, 3) == 256); // 240 bytes rounded up
+        CHECK(fem->enable_element_matrix_store(required - 1) == false);
+        CHECK(!fem->element_matrices);
+        CHECK(fem->enable_element_matrix_store(required) == true);
+        CHECK(fem->element_matrices->memory_bytes() == required);
+        CHECK(fem->element_matrices->ready == false);
+        CHECK(reinterpret_cast<size_t>(fem->element_matrices->get(0)) % ELEMENT_MATRIX_STORE_ALIGNMENT == 0);
+    }
+
+    SUBCASE("the store is filled by the assembly and reused afterwards") {
+        CHECK(fem->enable_element_matrix_store(1024 * 1024) == true);
+        fem->solve();
+        CHECK(fem->element_matrices->ready == true);
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+
+        // check the packed values
+        for (size_t e = 0; e < 8; e++) {
+            const double *kk = fem->element_matrices->get(e);
+            fem->calculate_element_stiffness(e);
+            for (size_t i = 0; i < 6; i++) {
+                for (size_t j = i; j < 6; j++) {
+                    CHECK(equal_scalars_tol(kk[packed_index(6, i, j)], fem->kk_element->get(i, j), 1e-8));
+                }
+            }
+        }
+
+        // strain energy = ½ fᵀ ⋅ u because the prescribed displacements are zero
+        double work = 0.0;
+        for (size_t i = 0; i < fem->total_ndof; i++) {
+            work += 0.5 * fem->natural_boundary_conditions[i] * fem->uu[i];
+        }
+        CHECK(equal_scalars_tol(fem->calculate_strain_energy(), work, 1e-18));
+
+        // reassembly (e.g., after changing the boundary conditions) uses the stored values
+        fem->calculate_rhs_and_global_stiffness();
+        fem->solve();
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+
+        // the matrix-free operator also uses the stored values
+        auto op = MatrixFreeOperator::make_new(*fem, false);
+        auto uu = vector<double>{};
+        op->solve(uu, 1e-14, 100);
+        CHECK(equal_vectors_tol(uu, correct_uu, 1e-15));
+    }
+}
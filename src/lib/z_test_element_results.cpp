@@ -0,0 +1,108 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "constants.h"
+#include "element_results.h"
+#include "generate_mesh.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Allocates a FEM problem on a mesh and sets uu to a linear displacement field
+/// @note ux = a x + b y and uy = c x + d y
+unique_ptr<Fem2d> linear_field(const CoordinatesAndConnectivity &mesh,
+                               bool plane_stress,
+                               double a,
+                               double b,
+                               double c,
+                               double d) {
+    bool solid_triangle = mesh.element_num_node == 3;
+    size_t ncell = mesh.connectivity.size() / mesh.element_num_node;
+    auto fem = Fem2d::make_new(solid_triangle, plane_stress, 1.0, true, false,
+                               mesh.coordinates,
+                               mesh.connectivity,
+                               vector<double>(ncell, 1000.0),
+                               vector<double>(solid_triangle ? ncell : 0, 0.25),
+                               vector<double>(solid_triangle ? 0 : ncell, 0.5),
+                               map<node_dof_pair_t, double>{},
+                               map<node_dof_pair_t, double>{});
+    for (size_t p = 0; p < fem->number_of_nodes; p++) {
+        double x = mesh.coordinates[p * 2], y = mesh.coordinates[p * 2 + 1];
+        fem->uu[p * 2] = a * x + b * y;
+        fem->uu[p * 2 + 1] = c * x + d * y;
+    }
+    return fem;
+}
+
+TEST_CASE("element_results") {
+    // patch test: every element has the same strain
+    double a = 1e-3, b = 2e-3, c = -1e-3, d = 3e-3;
+    auto mesh = generate_rectangle(0.0, 0.0, 3.0, 2.0, 3, 2);
+    size_t ncell = mesh->connectivity.size() / 3;
+
+    SUBCASE("plane-strain") {
+        auto fem = linear_field(*mesh, false, a, b, c, d);
+        auto results = ElementResults::make_new(*fem, true);
+        CHECK(results->axial_force.size() == 0);
+        CHECK(results->von_mises.size() == ncell);
+
+        // E = 1000 and ν = 0.25 give D00 = 1200, D01 = 400, and 2 G = 800
+        for (size_t e = 0; e < ncell; e++) {
+            CHECK(fabs(results->strain_xx[e] - a) < 1e-15);
+            CHECK(fabs(results->strain_yy[e] - d) < 1e-15);
+            CHECK(results->strain_zz[e] == 0.0);
+            CHECK(fabs(results->strain_xy[e] - (b + c) / SQRT_2) < 1e-15);
+            CHECK(fabs(results->stress_xx[e] - 2.4) < 1e-12);
+            CHECK(fabs(results->stress_yy[e] - 4.0) < 1e-12);
+            CHECK(fabs(results->stress_zz[e] - 1.6) < 1e-12);
+            CHECK(fabs(results->stress_xy[e] - 0.4 * SQRT_2) < 1e-12);
+            CHECK(fabs(results->von_mises[e] - sqrt(4.96)) < 1e-12);
+            CHECK(fabs(results->principal_1[e] - (3.2 + sqrt(0.8))) < 1e-12);
+            CHECK(fabs(results->principal_2[e] - (3.2 - sqrt(0.8))) < 1e-12);
+            CHECK(fabs(results->principal_angle[e] - atan2(0.8, -1.6) / 2.0) < 1e-12);
+        }
+
+        // recalculate after changing the displacements
+        for (auto &u : fem->uu) {
+            u *= 2.0;
+        }
+        results->calculate(*fem);
+        CHECK(fabs(results->stress_yy[0] - 8.0) < 1e-12);
+    }
+
+    SUBCASE("plane-stress") {
+        auto fem = linear_field(*mesh, true, a, b, c, d);
+        auto results = ElementResults::make_new(*fem);
+        CHECK(results->von_mises.size() == 0);
+
+        // E = 1000 and ν = 0.25 give D00 = 1066.67, D01 = 266.67, and 2 G = 800
+        double c0 = 1000.0 / (1.0 - 0.0625);
+        for (size_t e = 0; e < ncell; e++) {
+            CHECK(fabs(results->strain_zz[e] + 0.25 * (a + d) / 0.75) < 1e-15);
+            CHECK(fabs(results->stress_xx[e] - c0 * (a + 0.25 * d)) < 1e-12);
+            CHECK(fabs(results->stress_yy[e] - c0 * (0.25 * a + d)) < 1e-12);
+            CHECK(results->stress_zz[e] == 0.0);
+            CHECK(fabs(results->stress_xy[e] - 0.4 * SQRT_2) < 1e-12);
+        }
+    }
+
+    SUBCASE("rods") {
+        auto truss = generate_rectangle(0.0, 0.0, 2.0, 1.0, 2, 1, 2);
+        auto fem = linear_field(*truss, false, a, 0.0, 0.0, 0.0);
+        auto results = ElementResults::make_new(*fem, true);
+        CHECK(results->stress_xx.size() == 0);
+        CHECK(results->von_mises.size() == 0);
+        for (size_t e = 0; e < truss->attributes.size(); e++) {
+            // horizontal: ε = a; vertical: ε = 0; diagonal at 45°: ε = a / 2
+            double strain = truss->attributes[e] == 1 ? a : (truss->attributes[e] == 2 ? 0.0 : a / 2.0);
+            CHECK(fabs(results->axial_strain[e] - strain) < 1e-15);
+            CHECK(fabs(results->axial_stress[e] - 1000.0 * strain) < 1e-12);
+            CHECK(fabs(results->axial_force[e] - 500.0 * strain) < 1e-12);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "adaptive_refinement.h"
+#include "boundary.h"
+#include "error_estimator.h"
+#include "generate_mesh.h"
+#include "refinement.h"
+#include "spatial_index.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Allocates a plane-strain problem on a mesh (without boundary conditions)
+unique_ptr<Fem2d> new_plane_strain(const CoordinatesAndConnectivity &mesh) {
+    size_t ncell = mesh.connectivity.size() / 3;
+    return Fem2d::make_new(true, false, 1.0, true, false,
+                           mesh.coordinates,
+                           mesh.connectivity,
+                           vector<double>(ncell, 1000.0),
+                           vector<double>(ncell, 0.25),
+                           vector<double>{},
+                           map<node_dof_pair_t, double>{},
+                           map<node_dof_pair_t, double>{});
+}
+
+/// @brief Sets the displacements of a problem to a given field and estimates the error
+unique_ptr<ErrorEstimate> estimate_field(CoordinatesAndConnectivity &mesh,
+                                         double (*ux)(double, double),
+                                         double (*uy)(double, double)) {
+    auto fem = new_plane_strain(mesh);
+    for (size_t p = 0; p < mesh.coordinates.size() / 2; p++) {
+        fem->uu[p * 2] = ux(mesh.coordinates[p * 2], mesh.coordinates[p * 2 + 1]);
+        fem->uu[p * 2 + 1] = uy(mesh.coordinates[p * 2], mesh.coordinates[p * 2 + 1]);
+    }
+    auto results = ElementResults::make_new(*fem);
+    auto nodal = NodalStresses::make_new(NODAL_RECOVERY_SPR, mesh.coordinates, mesh.connectivity,
+                                         mesh.get_topology(), *results);
+    return ErrorEstimate::make_new(*fem, *results, *nodal);
+}
+
+TEST_CASE("error_estimator") {
+    SUBCASE("linear displacements have no error") {
+        auto mesh = generate_rectangle(0.0, 0.0, 3.0, 2.0, 6, 4);
+        auto estimate = estimate_field(
+            *mesh, [](double x, double y) { return 0.001 * x; }, [](double x, double y) { return 0.003 * y; });
+        CHECK(estimate->element_errors.size() == 48);
+        CHECK(estimate->error < 1e-14);
+        CHECK(estimate->relative_error < 1e-12);
+        // ‖u‖² = σ : ε × area = (2.4 × 0.001 + 4.0 × 0.003) × 6
+        CHECK(fabs(estimate->energy - 0.0864) < 1e-14);
+    }
+
+    SUBCASE("quadratic displacements") {
+        // the error decreases as O(h) in the energy norm
+        auto coarse = generate_rectangle(0.0, 0.0, 1.0, 1.0, 4, 4);
+        auto fine = refine_uniformly(*coarse);
+        auto ux = [](double x, double y) { return 0.001 * x * x; };
+        auto uy = [](double x, double y) { return 0.002 * x * y; };
+        auto e_coarse = estimate_field(*coarse, ux, uy);
+        auto e_fine = estimate_field(*fine, ux, uy);
+        CHECK(e_coarse->relative_error > 0.0);
+        CHECK(e_coarse->relative_error < 1.0);
+        double rate = e_fine->error / e_coarse->error;
+        CHECK(rate > 0.4);
+        CHECK(rate < 0.6);
+
+        // Dörfler marking
+        auto all = e_fine->mark(1.0);
+        CHECK(count(all.begin(), all.end(), true) == (long)all.size());
+        auto some = e_fine->mark(0.3);
+        size_t nmarked = count(some.begin(), some.end(), true);
+        CHECK(nmarked > 0);
+        CHECK(nmarked < some.size());
+        double marked2 = 0.0, largest_unmarked = 0.0, smallest_marked = 1e100;
+        for (size_t e = 0; e < some.size(); e++) {
+            double ee = e_fine->element_errors[e];
+            if (some[e]) {
+                marked2 += ee * ee;
+                smallest_marked = min(smallest_marked, ee);
+            } else {
+                largest_unmarked = max(largest_unmarked, ee);
+            }
+        }
+        CHECK(marked2 >= 0.3 * e_fine->error * e_fine->error);
+        CHECK(smallest_marked >= largest_unmarked);
+        CHECK_THROWS(e_fine->mark(0.0));
+    }
+
+    SUBCASE("adaptive refinement of the pressurized cylinder") {
+        double a = 3.0, b = 6.0;
+        auto factory = [&](CoordinatesAndConnectivity &mesh) {
+            auto fem = new_plane_strain(mesh);
+            auto index = SpatialIndex::make_new(mesh.coordinates);
+            fem->set_essential_bcs(index->nodes_on_segment(0.0, 0.0, 0.0, b, 1e-11), AlongX, 0.0);
+            fem->set_essential_bcs(index->nodes_on_segment(0.0, 0.0, b, 0.0, 1e-11), AlongY, 0.0);
+            auto boundary = BoundaryEdges::make_new(mesh.coordinates, mesh.connectivity, mesh.get_topology());
+            auto inner = boundary->select(mesh.coordinates, [&](double x, double y) { return hypot(x, y) < a + 1e-6; });
+            inner->add_pressure_loads(fem->natural_boundary_conditions, mesh.coordinates, 1.0, 1.0);
+            return fem;
+        };
+        auto options = AdaptiveOptions::make_new();
+        options->target_relative_error = 0.1;
+        auto adaptive = AdaptiveRefinement::make_new(generate_quarter_ring(a, b, 2, 3), factory, *options);
+        CHECK(adaptive->converged);
+        CHECK(adaptive->history.size() > 1);
+        CHECK(adaptive->history.back().relative_error <= 0.1);
+        CHECK(adaptive->history.back().relative_error < adaptive->history.front().relative_error);
+        CHECK(adaptive->history.back().number_of_elements == adaptive->mesh->connectivity.size() / 3);
+        CHECK(adaptive->fem->number_of_elements == adaptive->mesh->connectivity.size() / 3);
+
+        // the uniform refinement needs more elements to reach the same estimated error
+        auto uniform = generate_quarter_ring(a, b, 2, 3);
+        double relative_error = 1.0;
+        while (relative_error > 0.1) {
+            uniform = refine_uniformly(*uniform);
+            auto fem = factory(*uniform);
+            fem->solve();
+            auto results = ElementResults::make_new(*fem);
+            auto nodal = NodalStresses::make_new(NODAL_RECOVERY_SPR, uniform->coordinates, uniform->connectivity,
+                                                 uniform->get_topology(), *results);
+            relative_error = ErrorEstimate::make_new(*fem, *results, *nodal)->relative_error;
+        }
+        CHECK(adaptive->history.back().number_of_elements < uniform->connectivity.size() / 3);
+
+        options->max_cycles = 0;
+        auto single = AdaptiveRefinement::make_new(generate_quarter_ring(a, b, 2, 3), factory, *options);
+        CHECK(!single->converged);
+        CHECK(single->history.size() == 1);
+    }
+}
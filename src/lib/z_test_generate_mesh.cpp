@@ -0,0 +1,107 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "generate_mesh.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Returns the signed area of triangle e (positive if counterclockwise)
+double signed_area(const CoordinatesAndConnectivity &mesh, size_t e) {
+    const size_t *c = &mesh.connectivity[e * 3];
+    double xa = mesh.coordinates[c[0] * 2], ya = mesh.coordinates[c[0] * 2 + 1];
+    double xb = mesh.coordinates[c[1] * 2], yb = mesh.coordinates[c[1] * 2 + 1];
+    double xc = mesh.coordinates[c[2] * 2], yc = mesh.coordinates[c[2] * 2 + 1];
+    return ((xb - xa) * (yc - ya) - (yb - ya) * (xc - xa)) / 2.0;
+}
+
+/// @brief Returns the number of boundary edges
+size_t count_boundary_edges(CoordinatesAndConnectivity &mesh) {
+    const auto &topology = mesh.get_topology();
+    size_t count = 0;
+    for (size_t i = 0; i < topology.number_of_edges(); i++) {
+        if (topology.boundary_edge(i)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST_CASE("generate_mesh") {
+    SUBCASE("rectangle with triangles") {
+        auto mesh = generate_rectangle(1.0, 2.0, 4.0, 4.0, 3, 4);
+        CHECK(mesh->element_num_node == 3);
+        CHECK(mesh->coordinates.size() == 2 * 4 * 5);
+        CHECK(mesh->connectivity.size() == 3 * 24);
+        CHECK(mesh->attributes == vector<size_t>(24, 1));
+        CHECK(mesh->coordinates[0] == 1.0);
+        CHECK(mesh->coordinates[1] == 2.0);
+        CHECK(mesh->coordinates[19 * 2] == 4.0);
+        CHECK(mesh->coordinates[19 * 2 + 1] == 4.0);
+        double area = 0.0;
+        for (size_t e = 0; e < 24; e++) {
+            double ae = signed_area(*mesh, e);
+            CHECK(ae > 0.0);
+            area += ae;
+        }
+        CHECK(fabs(area - 6.0) < 1e-14);
+        CHECK(count_boundary_edges(*mesh) == 2 * (3 + 4));
+    }
+
+    SUBCASE("rectangle with rods") {
+        auto mesh = generate_rectangle(0.0, 0.0, 2.0, 1.0, 2, 1, 2);
+        CHECK(mesh->element_num_node == 2);
+        CHECK(mesh->connectivity == vector<size_t>{
+                                        0, 1, 1, 2, 3, 4, 4, 5, // horizontal
+                                        0, 3, 1, 4, 2, 5,       // vertical
+                                        0, 4, 1, 5});           // diagonal
+        CHECK(mesh->attributes == vector<size_t>{1, 1, 1, 1, 2, 2, 2, 3, 3});
+    }
+
+    SUBCASE("quarter ring") {
+        double a = 3.0, b = 6.0;
+        size_t nr = 0, nt = 0;
+        quarter_ring_divisions(nr, nt, a, b, 20000);
+        CHECK(nr > 0);
+        CHECK(nt > nr); // the arc is longer than the radial side
+        CHECK(fabs(2.0 * nr * nt / 20000.0 - 1.0) < 0.05);
+
+        auto mesh = generate_quarter_ring(a, b, nr, nt);
+        size_t npoint = mesh->coordinates.size() / 2;
+        size_t ncell = mesh->connectivity.size() / 3;
+        CHECK(npoint == (nr + 1) * (nt + 1));
+        CHECK(ncell == 2 * nr * nt);
+        size_t on_left = 0, on_bottom = 0;
+        for (size_t p = 0; p < npoint; p++) {
+            double r = hypot(mesh->coordinates[p * 2], mesh->coordinates[p * 2 + 1]);
+            CHECK(r >= a - 1e-14);
+            CHECK(r <= b + 1e-14);
+            on_left += mesh->coordinates[p * 2] == 0.0 ? 1 : 0;
+            on_bottom += mesh->coordinates[p * 2 + 1] == 0.0 ? 1 : 0;
+        }
+        CHECK(on_left == nr + 1);
+        CHECK(on_bottom == nr + 1);
+
+        // the chords make the area of the mesh slightly smaller than π (b² - a²) / 4
+        double area = 0.0;
+        for (size_t e = 0; e < ncell; e++) {
+            double ae = signed_area(*mesh, e);
+            CHECK(ae > 0.0);
+            area += ae;
+        }
+        double exact = M_PI * (b * b - a * a) / 4.0;
+        CHECK(area < exact);
+        CHECK((exact - area) / exact < 1e-3);
+        CHECK(count_boundary_edges(*mesh) == 2 * (nr + nt));
+    }
+
+    SUBCASE("errors") {
+        CHECK_THROWS(generate_rectangle(0.0, 0.0, 1.0, 1.0, 0, 1));
+        CHECK_THROWS(generate_rectangle(0.0, 0.0, 1.0, 1.0, 1, 1, 4));
+        CHECK_THROWS(generate_quarter_ring(3.0, 2.0, 1, 1));
+    }
+}
@@ -0,0 +1,174 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "constants.h"
+#include "fem2d.h"
+#include "laclib.h"
+#include "linear_solver.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("linear_solver") {
+    // Felippa's three-member truss with prescribed displacements (see z_test_truss2d.cpp)
+    auto coordinates = vector<double>{0.0, 0.0, 10.0, 0.0, 10.0, 10.0};
+    auto connectivity = vector<size_t>{0, 1, 1, 2, 2, 0};
+    auto param_young = vector<double>{100.0, 50.0, 200.0};
+    auto param_poisson = vector<double>{};
+    auto param_cross_area = vector<double>{1.0, 1.0, SQRT_2};
+    map<node_dof_pair_t, double> essential_bcs{
+        {{0, AlongX}, 0.0},
+        {{0, AlongY}, -0.5},
+        {{1, AlongY}, 0.4}};
+    map<node_dof_pair_t, double> natural_bcs{
+        {{2, AlongX}, 2.0},
+        {{2, AlongY}, 1.0}};
+    auto correct_uu = vector<double>{0.0, -0.5, 0.0, 0.4, -0.5, 0.2};
+    auto correct_rhs = vector<double>{0.0, -0.5, 0.0, 0.4, -3.0, -2.0};
+
+    auto options = LinearSolverOptions::make_new();
+    options->tolerance = 1e-14;
+
+    SUBCASE("all backends give the same solution") {
+        for (auto kind : {SOLVER_DSS, SOLVER_PARDISO, SOLVER_MIXED_PRECISION, SOLVER_PCG, SOLVER_MATRIX_FREE_PCG}) {
+            auto fem = Fem2d::make_new(false, false, 1.0, false, false,
+                                       coordinates,
+                                       connectivity,
+                                       param_young,
+                                       param_poisson,
+                                       param_cross_area,
+                                       essential_bcs,
+                                       natural_bcs);
+            CHECK(fem->lin_sys_solver->kind() == SOLVER_DSS);
+            fem->set_linear_solver(kind, *options);
+            CHECK(fem->lin_sys_solver->kind() == kind);
+            fem->solve();
+            CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-14));
+            CHECK(equal_vectors_tol(fem->rhs, correct_rhs, 1e-14));
+            if (kind == SOLVER_DSS) {
+                CHECK(fem->kk_csr);
+                CHECK(!fem->kk_upper);
+            } else if (kind == SOLVER_MATRIX_FREE_PCG) {
+                CHECK(!fem->kk_csr);
+                CHECK(!fem->kk_upper);
+                CHECK(!fem->kk_coo);
+            } else {
+                CHECK(!fem->kk_csr);
+                CHECK(fem->kk_upper);
+            }
+        }
+    }
+
+    SUBCASE("the PARDISO solvers outlive the stiffness they factorized") {
+        // run under valgrind (ctest -T memcheck): the solver must not read the freed kk_upper
+        auto young_doubled = vector<double>{200.0, 100.0, 400.0};
+        for (auto kind : {SOLVER_PARDISO, SOLVER_MIXED_PRECISION}) {
+            auto reference = Fem2d::make_new(false, false, 1.0, false, false,
+                                             coordinates,
+                                             connectivity,
+                                             young_doubled,
+                                             param_poisson,
+                                             param_cross_area,
+                                             essential_bcs,
+                                             natural_bcs);
+            reference->solve();
+            auto fem = Fem2d::make_new(false, false, 1.0, false, false,
+                                       coordinates,
+                                       connectivity,
+                                       param_young,
+                                       param_poisson,
+                                       param_cross_area,
+                                       essential_bcs,
+                                       natural_bcs);
+            fem->set_linear_solver(kind, *options);
+            fem->solve();
+            CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-14));
+
+            // the materials keep the pattern: the values are refilled in place and the analysis is reused
+            CHECK(fem->phase_counts.pattern_updates == 1);
+            auto kk_upper = fem->kk_upper.get();
+            fem->set_param_young(young_doubled);
+            CHECK(fem->kk_upper.get() == kk_upper);
+            fem->solve();
+            CHECK(fem->kk_upper.get() == kk_upper);
+            CHECK(fem->phase_counts.pattern_updates == 1);
+            CHECK(fem->phase_counts.factorizations == 2);
+            CHECK(equal_vectors_tol(fem->uu, reference->uu, 1e-14));
+        } // fem is destroyed here (kk_upper after lin_sys_solver)
+    }
+
+    SUBCASE("a new sparsity pattern is analyzed again") {
+        auto essential_more = essential_bcs;
+        essential_more[{1, AlongX}] = 0.0;
+        for (auto kind : {SOLVER_PARDISO, SOLVER_MIXED_PRECISION}) {
+            auto reference = Fem2d::make_new(false, false, 1.0, false, false,
+                                             coordinates,
+                                             connectivity,
+                                             param_young,
+                                             param_poisson,
+                                             param_cross_area,
+                                             essential_more,
+                                             natural_bcs);
+            reference->solve();
+            auto fem = Fem2d::make_new(false, false, 1.0, false, false,
+                                       coordinates,
+                                       connectivity,
+                                       param_young,
+                                       param_poisson,
+                                       param_cross_area,
+                                       essential_bcs,
+                                       natural_bcs);
+            fem->set_linear_solver(kind, *options);
+            fem->solve();
+
+            // the new constraint discards kk_upper (the solver must not read it) and changes its pattern
+            fem->set_essential_bcs(vector<size_t>{1}, AlongX, 0.0);
+            CHECK(fem->kk_upper.get() == NULL);
+            fem->solve();
+            CHECK(fem->phase_counts.pattern_updates == 2);
+            CHECK(equal_vectors_tol(fem->uu, reference->uu, 1e-14));
+        }
+    }
+
+    SUBCASE("PARDISO options are passed through") {
+        options->pardiso.ordering = PARDISO_PARALLEL_NESTED_DISSECTION;
+        options->pardiso.two_level_factorization = true;
+        options->pardiso.num_threads = 1;
+        auto solver = LinearSolver::make_new(SOLVER_PARDISO, *options);
+        auto pardiso = dynamic_cast<LinearSolverPardiso *>(solver.get());
+        CHECK(pardiso);
+        CHECK(pardiso->solver->iparm[1] == 3);
+        CHECK(pardiso->solver->iparm[23] == 1);
+    }
+
+    SUBCASE("comparison mode") {
+        auto fem = Fem2d::make_new(false, false, 1.0, false, false,
+                                   coordinates,
+                                   connectivity,
+                                   param_young,
+                                   param_poisson,
+                                   param_cross_area,
+                                   essential_bcs,
+                                   natural_bcs);
+        fem->set_linear_solver(SOLVER_PCG, *options);
+        fem->solve();
+        auto results = compare_linear_solvers(*fem, *options);
+        print_linear_solver_comparison(results);
+        CHECK(results.size() == 5);
+        for (const auto &r : results) {
+            CHECK(r.success);
+            CHECK(r.relative_residual < 1e-13);
+        }
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-14));
+
+        // the comparison replaced kk_upper: the solver of fem is set up again
+        size_t factorizations = fem->phase_counts.factorizations;
+        fem->solve();
+        CHECK(fem->phase_counts.factorizations == factorizations + 1);
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-14));
+    }
+}
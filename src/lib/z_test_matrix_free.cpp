@@ -0,0 +1,151 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "constants.h"
+#include "element_stiffness.h"
+#include "fem2d.h"
+#include "laclib.h"
+#include "matrix_free.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("matrix_free") {
+    SUBCASE("three-member truss with prescribed displacements (Felippa)") {
+        // see z_test_truss2d.cpp
+        auto coordinates = vector<double>{0.0, 0.0, 10.0, 0.0, 10.0, 10.0};
+        auto connectivity = vector<size_t>{0, 1, 1, 2, 2, 0};
+        auto param_young = vector<double>{100.0, 50.0, 200.0};
+        auto param_poisson = vector<double>{};
+        auto param_cross_area = vector<double>{1.0, 1.0, SQRT_2};
+        map<node_dof_pair_t, double> essential_bcs{
+            {{0, AlongX}, 0.0},
+            {{0, AlongY}, -0.5},
+            {{1, AlongY}, 0.4}};
+        map<node_dof_pair_t, double> natural_bcs{
+            {{2, AlongX}, 2.0},
+            {{2, AlongY}, 1.0}};
+        auto fem = Fem2d::make_new(false, false, 1.0, false, false,
+                                   coordinates,
+                                   connectivity,
+                                   param_young,
+                                   param_poisson,
+                                   param_cross_area,
+                                   essential_bcs,
+                                   natural_bcs);
+
+        // the COO matrix is not allocated before the assembly
+        CHECK(!fem->kk_coo);
+
+        for (auto cache_geometry : {false, true}) {
+            auto op = MatrixFreeOperator::make_new(*fem, cache_geometry);
+
+            // check packed element stiffness
+            double kk[PACKED_SIZE_ELASTIC_ROD];
+            for (size_t e = 0; e < 3; e++) {
+                op->element_stiffness(kk, e);
+                fem->calculate_element_stiffness(e);
+                for (size_t i = 0; i < 4; i++) {
+                    for (size_t j = i; j < 4; j++) {
+                        CHECK(equal_scalars_tol(kk[packed_index(4, i, j)], fem->kk_element->get(i, j), 1e-14));
+                    }
+                }
+            }
+
+            // check right-hand side
+            auto rhs = vector<double>(6);
+            op->calculate_rhs(rhs);
+            auto correct_rhs = vector<double>{0.0, -0.5, 0.0, 0.4, -3.0, -2.0}; // Felippa I-FEM page 3-13
+            CHECK(equal_vectors_tol(rhs, correct_rhs, 1e-14));
+
+            // check solution
+            auto uu = vector<double>{};
+            op->solve(uu, 1e-14, 100);
+            auto correct_uu = vector<double>{0.0, -0.5, 0.0, 0.4, -0.5, 0.2};
+            CHECK(equal_vectors_tol(uu, correct_uu, 1e-14));
+        }
+    }
+
+    SUBCASE("plane-stress bracket (Bhatti example 1.6)") {
+        // see z_test_solid2d.cpp
+        auto coordinates = vector<double>{
+            0.0, 0.0,  // 0
+            0.0, 2.0,  // 1
+            2.0, 0.0,  // 2
+            2.0, 1.5,  // 3
+            4.0, 0.0,  // 4
+            4.0, 1.0}; // 5
+        auto connectivity = vector<size_t>{
+            0, 2, 3,  // 0
+            3, 1, 0,  // 1
+            2, 4, 5,  // 2
+            5, 3, 2}; // 3
+        auto param_young = vector<double>{10000.0, 10000.0, 10000.0, 10000.0};
+        auto param_poisson = vector<double>{0.2, 0.2, 0.2, 0.2};
+        auto param_cross_area = vector<double>{};
+        map<node_dof_pair_t, double> essential_bcs{
+            {{0, AlongX}, 0.0},
+            {{0, AlongY}, 0.0},
+            {{1, AlongX}, 0.0},
+            {{1, AlongY}, 0.0}};
+        map<node_dof_pair_t, double> natural_bcs{
+            {{1, AlongX}, -1.25},
+            {{1, AlongY}, -5.0},
+            {{3, AlongX}, -2.5},
+            {{3, AlongY}, -10.0},
+            {{5, AlongX}, -1.25},
+            {{5, AlongY}, -5.0}};
+        auto fem = Fem2d::make_new(true, true, 0.25, true, false,
+                                   coordinates,
+                                   connectivity,
+                                   param_young,
+                                   param_poisson,
+                                   param_cross_area,
+                                   essential_bcs,
+                                   natural_bcs);
+        auto op = MatrixFreeOperator::make_new(*fem, true);
+
+        // check packed element stiffness
+        double kk[PACKED_SIZE_SOLID_TRIANGLE];
+        for (size_t e = 0; e < 4; e++) {
+            op->element_stiffness(kk, e);
+            fem->calculate_element_stiffness(e);
+            for (size_t i = 0; i < 6; i++) {
+                for (size_t j = i; j < 6; j++) {
+                    CHECK(equal_scalars_tol(kk[packed_index(6, i, j)], fem->kk_element->get(i, j), 1e-12));
+                }
+            }
+        }
+
+        // check y = K ⋅ x against the assembled (upper triangle) matrix
+        fem->calculate_rhs_and_global_stiffness();
+        auto kk_global = fem->kk_coo->as_matrix();
+        auto x = vector<double>{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0};
+        auto y = vector<double>(12);
+        op->multiply(y, x);
+        for (size_t i = 0; i < 12; i++) {
+            double correct = 0.0;
+            for (size_t j = 0; j < 12; j++) {
+                correct += (i <= j ? kk_global->get(i, j) : kk_global->get(j, i)) * x[j];
+            }
+            CHECK(equal_scalars_tol(y[i], correct, 1e-10));
+        }
+
+        // check solution
+        auto uu = vector<double>{};
+        auto iterations = op->solve(uu, 1e-15, 100);
+        CHECK(iterations > 0);
+        auto correct_uu = vector<double>{
+            0.000000000000000e+00, 0.000000000000000e+00,   // 0
+            0.000000000000000e+00, 0.000000000000000e+00,   // 1
+            -1.035527877607004e-02, -2.552969847657423e-02, // 2
+            4.727650463081949e-03, -2.473565538172127e-02,  // 3
+            -1.313941349422282e-02, -5.549310752960183e-02, // 4
+            8.389015766816341e-05, -5.556637423271112e-02}; // 5
+        CHECK(equal_vectors_tol(uu, correct_uu, 1e-14));
+    }
+}
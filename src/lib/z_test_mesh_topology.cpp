@@ -0,0 +1,111 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <vector>
+
+#include "../util/doctest.h"
+#include "mesh_topology.h"
+#include "read_mesh.h"
+#include "renumbering.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Returns the elements of a node
+vector<size_t> elements_of_node(const MeshTopology &topology, size_t node) {
+    return vector<size_t>(topology.node_elements.begin() + topology.node_element_pointers[node],
+                          topology.node_elements.begin() + topology.node_element_pointers[node + 1]);
+}
+
+/// @brief Returns the neighbors of an element
+vector<size_t> neighbors_of_element(const MeshTopology &topology, size_t e) {
+    return vector<size_t>(topology.element_neighbors.begin() + topology.element_neighbor_pointers[e],
+                          topology.element_neighbors.begin() + topology.element_neighbor_pointers[e + 1]);
+}
+
+TEST_CASE("mesh_topology") {
+    SUBCASE("triangles") {
+        // Bhatti's Example 1.6 (see z_test_solid2d.cpp)
+        auto connectivity = vector<size_t>{
+            0, 2, 3,  // 0
+            3, 1, 0,  // 1
+            2, 4, 5,  // 2
+            5, 3, 2}; // 3
+        auto topology = MeshTopology::make_new(6, connectivity, 3);
+        CHECK(topology->number_of_elements == 4);
+
+        CHECK(elements_of_node(*topology, 0) == vector<size_t>{0, 1});
+        CHECK(elements_of_node(*topology, 1) == vector<size_t>{1});
+        CHECK(elements_of_node(*topology, 2) == vector<size_t>{0, 2, 3});
+        CHECK(elements_of_node(*topology, 3) == vector<size_t>{0, 1, 3});
+        CHECK(elements_of_node(*topology, 4) == vector<size_t>{2});
+        CHECK(elements_of_node(*topology, 5) == vector<size_t>{2, 3});
+
+        CHECK(topology->number_of_edges() == 9);
+        CHECK(topology->edges == vector<size_t>{0, 1, 0, 2, 0, 3, 1, 3, 2, 3, 2, 4, 2, 5, 3, 5, 4, 5});
+        CHECK(topology->find_edge(3, 0) == 2);
+        CHECK(topology->find_edge(5, 4) == 8);
+        CHECK(topology->find_edge(1, 5) == NO_EDGE);
+
+        // element 1 = (3, 1, 0): local edges (3,1) (1,0) (0,3)
+        CHECK(topology->element_edges[1 * 3 + 0] == 3);
+        CHECK(topology->element_edges[1 * 3 + 1] == 0);
+        CHECK(topology->element_edges[1 * 3 + 2] == 2);
+
+        size_t boundary = 0;
+        for (size_t i = 0; i < topology->number_of_edges(); i++) {
+            if (topology->boundary_edge(i)) {
+                boundary++;
+            }
+        }
+        CHECK(boundary == 6);
+        CHECK(topology->edge_elements[2 * 2] == 0); // edge (0,3) between elements 0 and 1
+        CHECK(topology->edge_elements[2 * 2 + 1] == 1);
+
+        CHECK(neighbors_of_element(*topology, 0) == vector<size_t>{1, 3});
+        CHECK(neighbors_of_element(*topology, 1) == vector<size_t>{0});
+        CHECK(neighbors_of_element(*topology, 2) == vector<size_t>{3});
+        CHECK(neighbors_of_element(*topology, 3) == vector<size_t>{0, 2});
+    }
+
+    SUBCASE("rods") {
+        // Felippa's three-member truss (see z_test_truss2d.cpp)
+        auto connectivity = vector<size_t>{0, 1, 1, 2, 2, 0};
+        auto topology = MeshTopology::make_new(3, connectivity, 2);
+        CHECK(topology->number_of_edges() == 3);
+        CHECK(topology->element_edges == vector<size_t>{0, 2, 1}); // (0,1) (1,2) (0,2)
+        CHECK(neighbors_of_element(*topology, 0) == vector<size_t>{1, 2});
+        CHECK(neighbors_of_element(*topology, 1) == vector<size_t>{0, 2});
+        CHECK(neighbors_of_element(*topology, 2) == vector<size_t>{0, 1});
+    }
+
+    SUBCASE("node graph from the cached topology") {
+        size_t nx = 12, ny = 7;
+        auto mesh = CoordinatesAndConnectivity{};
+        mesh.element_num_node = 3;
+        mesh.coordinates.resize(2 * (nx + 1) * (ny + 1));
+        for (size_t j = 0; j <= ny; j++) {
+            for (size_t i = 0; i <= nx; i++) {
+                mesh.coordinates[(j * (nx + 1) + i) * 2] = static_cast<double>(i);
+                mesh.coordinates[(j * (nx + 1) + i) * 2 + 1] = static_cast<double>(j);
+            }
+        }
+        for (size_t j = 0; j < ny; j++) {
+            for (size_t i = 0; i < nx; i++) {
+                size_t a = j * (nx + 1) + i, b = a + 1, c = a + nx + 2, d = a + nx + 1;
+                mesh.connectivity.insert(mesh.connectivity.end(), {a, b, c, c, d, a});
+            }
+        }
+        const auto &topology = mesh.get_topology();
+        CHECK(&topology == &mesh.get_topology()); // cached
+        CHECK(topology.number_of_edges() == nx * (ny + 1) + ny * (nx + 1) + nx * ny);
+
+        auto from_edges = NodeGraph::make_from_topology(topology);
+        auto from_elements = NodeGraph::make_new(topology.number_of_nodes, mesh.connectivity, 3);
+        CHECK(from_edges->pointers == from_elements->pointers);
+        CHECK(from_edges->adjacency == from_elements->adjacency);
+
+        mesh.reset_topology();
+        CHECK(!mesh.topology);
+    }
+}
@@ -0,0 +1,131 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "laclib.h"
+#include "monte_carlo.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("monte_carlo") {
+    // Smith's Example 5.2 (see z_test_solid2d)
+    auto coordinates = vector<double>{
+        0.0, 0.0,   // 0
+        0.5, 0.0,   // 1
+        1.0, 0.0,   // 2
+        0.0, -0.5,  // 3
+        0.5, -0.5,  // 4
+        1.0, -0.5,  // 5
+        0.0, -1.0,  // 6
+        0.5, -1.0,  // 7
+        1.0, -1.0}; // 8
+    auto connectivity = vector<size_t>{1, 0, 3, 3, 4, 1, 2, 1, 4, 4, 5, 2, 4, 3, 6, 6, 7, 4, 5, 4, 7, 7, 8, 5};
+    auto fem = Fem2d::make_new(true, false, 1.0, true, false,
+                               coordinates,
+                               connectivity,
+                               vector<double>(8, 1e6),
+                               vector<double>(8, 0.3),
+                               vector<double>{},
+                               map<node_dof_pair_t, double>{},
+                               map<node_dof_pair_t, double>{});
+    auto left = vector<size_t>{0, 3, 6};
+    auto bottom = vector<size_t>{6, 7, 8};
+    fem->set_essential_bcs(left, AlongX, 0.0);
+    fem->set_essential_bcs(bottom, AlongY, 0.0);
+    fem->set_natural_bcs(vector<size_t>{0, 1, 2},
+                         vector<LocalDOF>{AlongY, AlongY, AlongY},
+                         vector<double>{-0.25, -0.5, -0.25});
+
+    SUBCASE("numeric reassembly") {
+        // a settlement makes the right-hand side depend on the Young's moduli
+        fem->update_essential_values(bottom, vector<LocalDOF>(3, AlongY), vector<double>(3, -1e-6));
+        auto ensemble = MonteCarloEnsemble::make_new(*fem);
+        CHECK(ensemble->assembly->rhs_elements.size() == 4);
+        auto young = vector<double>{1e6, 2e6, 3e6, 4e6, 5e6, 6e6, 7e6, 8e6};
+        vector<double> values, rhs;
+        ensemble->assembly->assemble(values, rhs, young);
+
+        fem->set_param_young(young);
+        auto kk = CsrUpper::make_from_fem(*fem);
+        fem->calculate_rhs();
+        CHECK(kk->row_pointers == ensemble->assembly->pattern->row_pointers);
+        CHECK(kk->column_indices == ensemble->assembly->pattern->column_indices);
+        CHECK(equal_vectors_tol(values, kk->values, 1e-8));
+        CHECK(equal_vectors_tol(rhs, fem->rhs, 1e-15));
+    }
+
+    SUBCASE("uniform scaling of the Young's modulus") {
+        // uu = uu_ref / f with f = 1, 2, 3, 4 (25 samples each)
+        fem->solve();
+        auto uu_ref = fem->uu;
+        auto ensemble = MonteCarloEnsemble::make_new(*fem);
+        auto sampler = [](vector<double> &young, size_t sample) {
+            fill(young.begin(), young.end(), 1e6 * static_cast<double>(1 + sample % 4));
+        };
+        double mean_inv = (1.0 + 1.0 / 2.0 + 1.0 / 3.0 + 1.0 / 4.0) / 4.0;
+        double mean_inv2 = (1.0 + 1.0 / 4.0 + 1.0 / 9.0 + 1.0 / 16.0) / 4.0;
+        double variance_inv = (mean_inv2 - mean_inv * mean_inv) * 100.0 / 99.0;
+
+        auto statistics = ensemble->run(100, sampler, 3);
+        CHECK(statistics->number_of_samples == 100);
+        vector<double> variance;
+        statistics->calculate_variance(variance);
+        for (size_t i = 0; i < fem->total_ndof; i++) {
+            CHECK(fabs(statistics->mean_uu[i] - mean_inv * uu_ref[i]) < 1e-20);
+            CHECK(fabs(variance[i] - variance_inv * uu_ref[i] * uu_ref[i]) < 1e-25);
+        }
+
+        // the same statistics with one thread
+        auto serial = ensemble->run(100, sampler, 1);
+        CHECK(equal_vectors_tol(serial->mean_uu, statistics->mean_uu, 1e-20));
+        CHECK(equal_vectors_tol(serial->m2_uu, statistics->m2_uu, 1e-20));
+    }
+
+    SUBCASE("random fields") {
+        // compare with solving each sample with Fem2d
+        auto sampler = [](vector<double> &young, size_t sample) {
+            mt19937_64 generator(sample);
+            lognormal_distribution<double> distribution(log(1e6), 0.3);
+            for (auto &value : young) {
+                value = distribution(generator);
+            }
+        };
+        auto ensemble = MonteCarloEnsemble::make_new(*fem);
+        auto statistics = ensemble->run(20, sampler, 2);
+        auto reference = EnsembleStatistics::make_new(fem->total_ndof);
+        vector<double> young(8);
+        for (size_t sample = 0; sample < 20; sample++) {
+            sampler(young, sample);
+            fem->set_param_young(young);
+            fem->solve();
+            reference->add(fem->uu);
+        }
+        CHECK(equal_vectors_tol(statistics->mean_uu, reference->mean_uu, 1e-18));
+        CHECK(equal_vectors_tol(statistics->m2_uu, reference->m2_uu, 1e-24));
+        for (size_t i = 0; i < fem->total_ndof; i++) {
+            CHECK(reference->m2_uu[i] >= 0.0);
+        }
+    }
+
+    SUBCASE("errors") {
+        // any exception of the sampler is reported after the parallel region
+        auto ensemble = MonteCarloEnsemble::make_new(*fem);
+        auto failing = [](vector<double> &young, size_t sample) {
+            if (sample == 7) {
+                throw std::runtime_error("sampler failed");
+            }
+            young.assign(8, 1e6);
+        };
+        CHECK_THROWS_AS(ensemble->run(20, failing, 2), const char *);
+
+        fem->set_param_young(vector<double>(8, 0.0));
+        CHECK_THROWS(MonteCarloEnsemble::make_new(*fem));
+    }
+}
@@ -0,0 +1,86 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "generate_mesh.h"
+#include "nodal_recovery.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("nodal_recovery") {
+    auto mesh = generate_rectangle(0.0, 0.0, 3.0, 2.0, 6, 4);
+    size_t npoint = mesh->coordinates.size() / 2;
+    size_t ncell = mesh->connectivity.size() / 3;
+    auto fem = Fem2d::make_new(true, false, 1.0, true, false,
+                               mesh->coordinates,
+                               mesh->connectivity,
+                               vector<double>(ncell, 1000.0),
+                               vector<double>(ncell, 0.25),
+                               vector<double>{},
+                               map<node_dof_pair_t, double>{},
+                               map<node_dof_pair_t, double>{});
+    const auto &topology = mesh->get_topology();
+
+    SUBCASE("constant stress") {
+        // ux = 0.001 x and uy = 0.003 y give σxx = 2.4, σyy = 4.0, σzz = 1.6 (see z_test_element_results)
+        for (size_t p = 0; p < npoint; p++) {
+            fem->uu[p * 2] = 0.001 * mesh->coordinates[p * 2];
+            fem->uu[p * 2 + 1] = 0.003 * mesh->coordinates[p * 2 + 1];
+        }
+        auto results = ElementResults::make_new(*fem);
+        for (auto method : {NODAL_RECOVERY_AVERAGING, NODAL_RECOVERY_SPR}) {
+            auto nodal = NodalStresses::make_new(method, mesh->coordinates, mesh->connectivity, topology, *results);
+            CHECK(nodal->size() == npoint);
+            for (size_t p = 0; p < npoint; p++) {
+                CHECK(fabs(nodal->stress_xx[p] - 2.4) < 1e-12);
+                CHECK(fabs(nodal->stress_yy[p] - 4.0) < 1e-12);
+                CHECK(fabs(nodal->stress_zz[p] - 1.6) < 1e-12);
+                CHECK(fabs(nodal->stress_xy[p]) < 1e-12);
+            }
+            vector<double> von_mises;
+            nodal->calculate_von_mises(von_mises);
+            CHECK(fabs(von_mises[0] - sqrt(4.48)) < 1e-12);
+        }
+    }
+
+    SUBCASE("linear stress field sampled at the centroids") {
+        // SPR recovers a linear field exactly (also at the boundary); averaging does not
+        auto results = ElementResults::make_new(*fem);
+        auto field = [](double x, double y) { return 1.0 + 2.0 * x - 3.0 * y; };
+        for (size_t e = 0; e < ncell; e++) {
+            double xc = 0.0, yc = 0.0;
+            for (size_t k = 0; k < 3; k++) {
+                size_t node = mesh->connectivity[e * 3 + k];
+                xc += mesh->coordinates[node * 2] / 3.0;
+                yc += mesh->coordinates[node * 2 + 1] / 3.0;
+            }
+            results->stress_xx[e] = field(xc, yc);
+            results->stress_yy[e] = -field(xc, yc);
+            results->stress_zz[e] = 0.0;
+            results->stress_xy[e] = 0.5 * field(xc, yc);
+        }
+        auto spr = NodalStresses::make_new(NODAL_RECOVERY_SPR, mesh->coordinates, mesh->connectivity, topology, *results);
+        auto avg = NodalStresses::make_new(NODAL_RECOVERY_AVERAGING, mesh->coordinates, mesh->connectivity, topology,
+                                           *results);
+        double max_error_avg = 0.0;
+        for (size_t p = 0; p < npoint; p++) {
+            double correct = field(mesh->coordinates[p * 2], mesh->coordinates[p * 2 + 1]);
+            CHECK(fabs(spr->stress_xx[p] - correct) < 1e-12);
+            CHECK(fabs(spr->stress_yy[p] + correct) < 1e-12);
+            CHECK(fabs(spr->stress_xy[p] - 0.5 * correct) < 1e-12);
+            max_error_avg = max(max_error_avg, fabs(avg->stress_xx[p] - correct));
+        }
+        CHECK(max_error_avg > 0.1);
+    }
+
+    SUBCASE("errors") {
+        auto truss = generate_rectangle(0.0, 0.0, 1.0, 1.0, 1, 1, 2);
+        CHECK_THROWS(NodalStresses::make_new(NODAL_RECOVERY_SPR, truss->coordinates, truss->connectivity,
+                                             truss->get_topology(), *ElementResults::make_new(*fem)));
+    }
+}
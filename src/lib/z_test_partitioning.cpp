@@ -0,0 +1,109 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "partitioning.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Generates a structured mesh of nx × ny squares split into triangles and rotated by angle
+void rotated_grid(vector<double> &coordinates, vector<size_t> &connectivity, size_t nx, size_t ny, double angle) {
+    auto id = [&](size_t i, size_t j) { return j * (nx + 1) + i; };
+    coordinates.assign(2 * (nx + 1) * (ny + 1), 0.0);
+    for (size_t j = 0; j <= ny; j++) {
+        for (size_t i = 0; i <= nx; i++) {
+            auto x = static_cast<double>(i);
+            auto y = static_cast<double>(j);
+            coordinates[id(i, j) * 2] = cos(angle) * x - sin(angle) * y;
+            coordinates[id(i, j) * 2 + 1] = sin(angle) * x + cos(angle) * y;
+        }
+    }
+    connectivity.clear();
+    for (size_t j = 0; j < ny; j++) {
+        for (size_t i = 0; i < nx; i++) {
+            connectivity.insert(connectivity.end(), {id(i, j), id(i + 1, j), id(i + 1, j + 1)});
+            connectivity.insert(connectivity.end(), {id(i + 1, j + 1), id(i, j + 1), id(i, j)});
+        }
+    }
+}
+
+/// @brief Checks the consistency of the parts
+void check_parts(const MeshPartitioning &partitioning, const vector<size_t> &connectivity, size_t number_of_nodes) {
+    size_t number_of_elements = connectivity.size() / 3;
+    REQUIRE(partitioning.element_part.size() == number_of_elements);
+    vector<size_t> parts_per_node(number_of_nodes, 0);
+    size_t total = 0;
+    for (size_t p = 0; p < partitioning.parts.size(); p++) {
+        const auto &part = partitioning.parts[p];
+        total += part.elements.size();
+        for (auto e : part.elements) {
+            CHECK(partitioning.element_part[e] == p);
+            for (size_t k = 0; k < 3; k++) {
+                CHECK(binary_search(part.local_to_global.begin(), part.local_to_global.end(), connectivity[e * 3 + k]));
+            }
+        }
+        for (auto node : part.local_to_global) {
+            parts_per_node[node]++;
+        }
+        for (auto node : part.interface_nodes) {
+            CHECK(binary_search(partitioning.interface_nodes.begin(), partitioning.interface_nodes.end(), node));
+        }
+    }
+    CHECK(total == number_of_elements);
+    size_t shared = 0;
+    for (size_t node = 0; node < number_of_nodes; node++) {
+        CHECK(parts_per_node[node] >= 1);
+        if (parts_per_node[node] > 1) {
+            shared++;
+        }
+    }
+    CHECK(shared == partitioning.interface_nodes.size());
+}
+
+TEST_CASE("partitioning") {
+    vector<double> coordinates;
+    vector<size_t> connectivity;
+
+    SUBCASE("coordinate bisection") {
+        rotated_grid(coordinates, connectivity, 16, 16, 0.0);
+        for (size_t k : {1, 2, 3, 4, 7}) {
+            auto partitioning = MeshPartitioning::make_new(PARTITIONING_COORDINATE_BISECTION, k,
+                                                           coordinates, connectivity, 3);
+            CHECK(partitioning->parts.size() == k);
+            check_parts(*partitioning, connectivity, 17 * 17);
+            CHECK(partitioning->imbalance() <= 1.02); // within one element (e.g., 74 vs 512 / 7)
+            if (k == 1) {
+                CHECK(partitioning->interface_nodes.empty());
+            }
+            if (k == 4) {
+                // two straight cuts through the middle
+                CHECK(partitioning->interface_nodes.size() <= 2 * 17 + 2);
+            }
+        }
+    }
+
+    SUBCASE("inertial bisection follows a rotated strip") {
+        rotated_grid(coordinates, connectivity, 32, 2, M_PI / 4.0);
+        auto partitioning = MeshPartitioning::make_new(PARTITIONING_INERTIAL_BISECTION, 2,
+                                                       coordinates, connectivity, 3);
+        check_parts(*partitioning, connectivity, 33 * 3);
+        CHECK(partitioning->imbalance() == 1.0);
+        CHECK(partitioning->interface_nodes.size() <= 5); // a cut across the width
+    }
+
+    SUBCASE("METIS") {
+        rotated_grid(coordinates, connectivity, 16, 16, 0.0);
+#ifdef USE_METIS
+        auto partitioning = MeshPartitioning::make_new(PARTITIONING_METIS, 4, coordinates, connectivity, 3);
+        check_parts(*partitioning, connectivity, 17 * 17);
+        CHECK(partitioning->imbalance() <= 1.1);
+#else
+        CHECK_THROWS(MeshPartitioning::make_new(PARTITIONING_METIS, 4, coordinates, connectivity, 3));
+#endif
+    }
+}
@@ -29,6 +29,8 @@ TEST_CASE("read_mesh") {
             2, 0}; // 2
         CHECK(equal_vectors_tol(mesh->coordinates, correct_coo, 1e-15));
         CHECK(equal_vectors(mesh->connectivity, correct_con));
+        CHECK(mesh->element_num_node == 2);
+        CHECK(equal_vectors(mesh->attributes, vector<size_t>{1, 1, 1}));
     }
 
     SUBCASE("read_mesh works (smith_plane_strain_5dot2)") {
@@ -54,5 +56,7 @@ TEST_CASE("read_mesh") {
             7, 8, 5}; // 7
         CHECK(equal_vectors_tol(mesh->coordinates, correct_coo, 1e-15));
         CHECK(equal_vectors(mesh->connectivity, correct_con));
+        CHECK(mesh->element_num_node == 3);
+        CHECK(mesh->attributes.size() == 8);
     }
 }
@@ -0,0 +1,168 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "csr_upper.h"
+#include "generate_mesh.h"
+#include "reduced_order_model.h"
+#include "spatial_index.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Returns the relative difference ‖a - b‖ / ‖b‖
+double relative_difference(const vector<double> &a, const vector<double> &b) {
+    double diff = 0.0, norm = 0.0;
+    for (size_t i = 0; i < b.size(); i++) {
+        diff += (a[i] - b[i]) * (a[i] - b[i]);
+        norm += b[i] * b[i];
+    }
+    return sqrt(diff / norm);
+}
+
+TEST_CASE("reduced_order_model") {
+    // cantilever [0, 2] × [0, 1] clamped at x = 0 (no loads)
+    auto mesh = generate_rectangle(0.0, 0.0, 2.0, 1.0, 16, 8);
+    size_t ncell = mesh->connectivity.size() / 3;
+    auto fem = Fem2d::make_new(true, true, 1.0, true, false,
+                               mesh->coordinates,
+                               mesh->connectivity,
+                               vector<double>(ncell, 1000.0),
+                               vector<double>(ncell, 0.3),
+                               vector<double>{},
+                               map<node_dof_pair_t, double>{},
+                               map<node_dof_pair_t, double>{});
+    auto index = SpatialIndex::make_new(mesh->coordinates);
+    auto left = index->nodes_on_segment(0.0, 0.0, 0.0, 1.0, 1e-11);
+    fem->set_essential_bcs(left, AlongX, 0.0);
+    fem->set_essential_bcs(left, AlongY, 0.0);
+    size_t tip = index->nearest_node(2.0, 0.5);
+    size_t ndof = fem->total_ndof;
+
+    // two material groups (left and right halves) and two load cases at the tip (vertical and horizontal)
+    vector<size_t> groups(ncell);
+    for (size_t e = 0; e < ncell; e++) {
+        size_t a = mesh->connectivity[e * 3];
+        groups[e] = mesh->coordinates[a * 2] < 1.0 - 1e-12 ? 0 : 1;
+    }
+    vector<vector<double>> loads(2, vector<double>(ndof, 0.0));
+    loads[0][tip * 2 + 1] = -1.0;
+    loads[1][tip * 2] = 1.0;
+    vector<vector<double>> training;
+    for (double mu0 : {0.5, 1.0, 2.0}) {
+        for (double mu1 : {0.5, 1.0, 2.0}) {
+            training.push_back(vector<double>{mu0, mu1});
+        }
+    }
+
+    // full solution with a separate problem
+    auto reference = Fem2d::make_new(true, true, 1.0, true, false,
+                                     mesh->coordinates,
+                                     mesh->connectivity,
+                                     vector<double>(ncell, 1000.0),
+                                     vector<double>(ncell, 0.3),
+                                     vector<double>{},
+                                     map<node_dof_pair_t, double>{},
+                                     map<node_dof_pair_t, double>{});
+    reference->set_essential_bcs(left, AlongX, 0.0);
+    reference->set_essential_bcs(left, AlongY, 0.0);
+    auto solve_full = [&](const vector<double> &mu, const vector<double> &theta) {
+        vector<double> young(ncell);
+        for (size_t e = 0; e < ncell; e++) {
+            young[e] = 1000.0 * mu[groups[e]];
+        }
+        reference->set_param_young(young);
+        reference->set_natural_bcs(vector<size_t>{tip, tip},
+                                   vector<LocalDOF>{AlongX, AlongY},
+                                   vector<double>{theta[1], -theta[0]});
+        reference->solve();
+        return reference->uu;
+    };
+
+    SUBCASE("offline and online stages") {
+        auto options = RomOptions::make_new();
+        auto rom = ReducedOrderModel::make_new(*fem, groups, loads, training, *options);
+        CHECK(rom->number_of_groups == 2);
+        CHECK(rom->singular_values.size() == 18);
+        REQUIRE(rom->basis_size > 1);
+        CHECK(rom->basis_size <= 18);
+
+        // orthonormal basis vanishing on the prescribed DOFs
+        for (size_t i = 0; i < rom->basis_size; i++) {
+            for (size_t j = 0; j < rom->basis_size; j++) {
+                double product = 0.0;
+                for (size_t k = 0; k < ndof; k++) {
+                    product += rom->basis[i * ndof + k] * rom->basis[j * ndof + k];
+                }
+                CHECK(fabs(product - (i == j ? 1.0 : 0.0)) < 1e-12);
+            }
+            for (size_t k = 0; k < ndof; k++) {
+                if (fem->essential_prescribed[k]) {
+                    CHECK(rom->basis[i * ndof + k] == 0.0);
+                }
+            }
+        }
+
+        // a training point is reproduced
+        vector<double> uu;
+        auto result = rom->query(uu, vector<double>{2.0, 0.5}, vector<double>{1.0, 0.0});
+        CHECK(result.reduced);
+        CHECK(result.error_indicator < 1e-5);
+        CHECK(relative_difference(uu, solve_full(vector<double>{2.0, 0.5}, vector<double>{1.0, 0.0})) < 1e-5);
+
+        // a new point: the indicator equals the residual norm computed with the full stiffness
+        auto mu = vector<double>{0.7, 1.5};
+        auto theta = vector<double>{1.0, -0.5};
+        result = rom->query(uu, mu, theta);
+        CHECK(result.reduced);
+        auto uu_full = solve_full(mu, theta);
+        CHECK(relative_difference(uu, uu_full) < 1e-3);
+        auto kk = CsrUpper::make_from_fem(*reference);
+        vector<double> ku(ndof);
+        kk->multiply(ku, uu);
+        double residual = 0.0, norm = 0.0;
+        for (size_t i = 0; i < ndof; i++) {
+            double f = reference->essential_prescribed[i] ? 0.0 : reference->natural_boundary_conditions[i];
+            residual += (f - ku[i]) * (f - ku[i]);
+            norm += f * f;
+        }
+        CHECK(fabs(result.error_indicator - sqrt(residual / norm)) < 1e-6);
+        CHECK(rom->number_of_queries == 2);
+        CHECK(rom->number_of_fallbacks == 0);
+    }
+
+    SUBCASE("fallback to the full solve") {
+        auto options = RomOptions::make_new();
+        options->residual_tolerance = 1e-14;
+        auto rom = ReducedOrderModel::make_new(*fem, groups, loads, training, *options);
+        auto mu = vector<double>{0.7, 1.5};
+        vector<double> uu;
+        auto result = rom->query(uu, mu, vector<double>{1.0, -0.5});
+        CHECK(!result.reduced);
+        CHECK(result.error_indicator > 1e-14);
+        CHECK(relative_difference(uu, solve_full(mu, vector<double>{1.0, -0.5})) < 1e-12);
+
+        // only the loads change: the factorization of fem is reused
+        size_t factorizations = fem->phase_counts.factorizations;
+        rom->query(uu, mu, vector<double>{0.0, 1.0});
+        CHECK(fem->phase_counts.factorizations == factorizations);
+        CHECK(relative_difference(uu, solve_full(mu, vector<double>{0.0, 1.0})) < 1e-12);
+        CHECK(rom->number_of_fallbacks == 2);
+    }
+
+    SUBCASE("errors") {
+        auto options = RomOptions::make_new();
+        CHECK_THROWS(ReducedOrderModel::make_new(*fem, vector<size_t>(3, 0), loads, training, *options));
+        CHECK_THROWS(ReducedOrderModel::make_new(*fem, groups, vector<vector<double>>{}, training, *options));
+        auto rom = ReducedOrderModel::make_new(*fem, groups, loads, training, *options);
+        vector<double> uu;
+        CHECK_THROWS(rom->query(uu, vector<double>{1.0}, vector<double>{1.0, 0.0}));
+        CHECK_THROWS(rom->query(uu, vector<double>{1.0, -1.0}, vector<double>{1.0, 0.0}));
+        fem->update_essential_values(vector<size_t>{0}, vector<LocalDOF>{AlongX}, vector<double>{1e-3});
+        CHECK_THROWS(ReducedOrderModel::make_new(*fem, groups, loads, training, *options));
+    }
+}
@@ -0,0 +1,153 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "generate_mesh.h"
+#include "refinement.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Returns the sorted (x, y) pairs of a mesh
+vector<pair<double, double>> sorted_points(const CoordinatesAndConnectivity &mesh) {
+    vector<pair<double, double>> points;
+    for (size_t p = 0; p < mesh.coordinates.size() / 2; p++) {
+        points.push_back({mesh.coordinates[p * 2], mesh.coordinates[p * 2 + 1]});
+    }
+    sort(points.begin(), points.end());
+    return points;
+}
+
+/// @brief Returns the total area of a mesh of triangles (all areas must be positive)
+double total_area(const CoordinatesAndConnectivity &mesh) {
+    double area = 0.0;
+    for (size_t e = 0; e < mesh.connectivity.size() / 3; e++) {
+        const size_t *c = &mesh.connectivity[e * 3];
+        double xa = mesh.coordinates[c[0] * 2], ya = mesh.coordinates[c[0] * 2 + 1];
+        double xb = mesh.coordinates[c[1] * 2], yb = mesh.coordinates[c[1] * 2 + 1];
+        double xc = mesh.coordinates[c[2] * 2], yc = mesh.coordinates[c[2] * 2 + 1];
+        double ae = ((xb - xa) * (yc - ya) - (yb - ya) * (xc - xa)) / 2.0;
+        CHECK(ae > 0.0);
+        area += ae;
+    }
+    return area;
+}
+
+TEST_CASE("refinement") {
+    SUBCASE("triangles") {
+        auto coarse = generate_rectangle(0.0, 0.0, 2.0, 1.0, 2, 1);
+        coarse->attributes = vector<size_t>{7, 7, 8, 8};
+        auto fine = refine_uniformly(*coarse);
+        CHECK(fine->element_num_node == 3);
+        CHECK(fine->coordinates.size() == 2 * 15);
+        CHECK(fine->connectivity.size() == 3 * 16);
+        CHECK(fine->attributes == vector<size_t>{7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8});
+
+        // the old nodes are kept and the midpoints follow the edges of the topology
+        const auto &topology = coarse->get_topology();
+        for (size_t p = 0; p < 6; p++) {
+            CHECK(fine->coordinates[p * 2] == coarse->coordinates[p * 2]);
+            CHECK(fine->coordinates[p * 2 + 1] == coarse->coordinates[p * 2 + 1]);
+        }
+        for (size_t i = 0; i < topology.number_of_edges(); i++) {
+            size_t a = topology.edges[i * 2], b = topology.edges[i * 2 + 1];
+            CHECK(fine->coordinates[(6 + i) * 2] == (coarse->coordinates[a * 2] + coarse->coordinates[b * 2]) / 2.0);
+        }
+
+        // same points and area as the 4 × 2 structured mesh
+        auto reference = generate_rectangle(0.0, 0.0, 2.0, 1.0, 4, 2);
+        CHECK(sorted_points(*fine) == sorted_points(*reference));
+        CHECK(fabs(total_area(*fine) - 2.0) < 1e-15);
+
+        // conforming: the boundary has twice as many edges
+        const auto &fine_topology = fine->get_topology();
+        size_t boundary = 0;
+        for (size_t i = 0; i < fine_topology.number_of_edges(); i++) {
+            boundary += fine_topology.boundary_edge(i) ? 1 : 0;
+        }
+        CHECK(boundary == 12);
+    }
+
+    SUBCASE("hierarchy") {
+        auto coarse = generate_quarter_ring(3.0, 6.0, 2, 3);
+        auto fine = refine_uniformly(*coarse, 3);
+        CHECK(fine->connectivity.size() / 3 == 12 * 64);
+        CHECK(fine->coordinates.size() / 2 == (16 + 1) * (24 + 1));
+        CHECK(fabs(total_area(*fine) - total_area(*coarse)) < 1e-12);
+        auto copy = refine_uniformly(*coarse, 0);
+        CHECK(copy->connectivity == coarse->connectivity);
+    }
+
+    SUBCASE("rods") {
+        auto coarse = generate_rectangle(0.0, 0.0, 1.0, 1.0, 1, 1, 2);
+        auto fine = refine_uniformly(*coarse);
+        CHECK(fine->element_num_node == 2);
+        CHECK(fine->coordinates.size() == 2 * 9);
+        CHECK(fine->connectivity.size() == 2 * 10);
+        CHECK(fine->attributes == vector<size_t>{1, 1, 1, 1, 2, 2, 2, 2, 3, 3});
+        // the diagonal (0, 3) is split at (0.5, 0.5)
+        size_t mid = fine->connectivity[8 * 2 + 1];
+        CHECK(fine->connectivity[8 * 2] == 0);
+        CHECK(fine->connectivity[9 * 2] == mid);
+        CHECK(fine->connectivity[9 * 2 + 1] == 3);
+        CHECK(fine->coordinates[mid * 2] == 0.5);
+        CHECK(fine->coordinates[mid * 2 + 1] == 0.5);
+    }
+
+    SUBCASE("marked triangles") {
+        auto coarse = generate_rectangle(0.0, 0.0, 4.0, 4.0, 4, 4);
+        coarse->attributes = vector<size_t>(32, 5);
+        size_t ncell = coarse->connectivity.size() / 3;
+
+        // nothing marked gives a copy
+        vector<size_t> parents;
+        auto same = refine_marked(*coarse, vector<bool>(ncell, false), &parents);
+        CHECK(same->connectivity == coarse->connectivity);
+        CHECK(parents.size() == ncell);
+
+        // mark one corner triangle, then refine the new corner triangles again
+        auto marked = vector<bool>(ncell, false);
+        marked[0] = true;
+        auto fine = refine_marked(*coarse, marked, &parents);
+        size_t nfine = fine->connectivity.size() / 3;
+        CHECK(nfine == ncell + 3 + 2); // red (4) and two green neighbours (2 each)
+        CHECK(fine->coordinates.size() / 2 == 25 + 3);
+        CHECK(parents.size() == nfine);
+        CHECK(fine->attributes == vector<size_t>(nfine, 5));
+        CHECK(is_sorted(parents.begin(), parents.end()));
+        CHECK(count(parents.begin(), parents.end(), 0) == 4);
+        for (size_t k = 0; k < 4; k++) {
+            CHECK(parents[k] == 0);
+        }
+        for (size_t level = 0; level < 3; level++) {
+            marked = vector<bool>(fine->connectivity.size() / 3, false);
+            marked[0] = true;
+            fine = refine_marked(*fine, marked);
+        }
+
+        // conforming: same area and the boundary consists of the 16 coarse edges plus the split ones
+        CHECK(fabs(total_area(*fine) - 16.0) < 1e-14);
+        const auto &topology = fine->get_topology();
+        double perimeter = 0.0;
+        for (size_t i = 0; i < topology.number_of_edges(); i++) {
+            if (topology.boundary_edge(i)) {
+                size_t a = topology.edges[i * 2], b = topology.edges[i * 2 + 1];
+                perimeter += hypot(fine->coordinates[a * 2] - fine->coordinates[b * 2],
+                                   fine->coordinates[a * 2 + 1] - fine->coordinates[b * 2 + 1]);
+            }
+        }
+        CHECK(fabs(perimeter - 16.0) < 1e-14);
+
+        // all marked is the same as the uniform refinement
+        auto all = refine_marked(*coarse, vector<bool>(ncell, true));
+        auto uniform = refine_uniformly(*coarse);
+        CHECK(sorted_points(*all) == sorted_points(*uniform));
+        CHECK(all->connectivity.size() == uniform->connectivity.size());
+
+        CHECK_THROWS(refine_marked(*coarse, vector<bool>(ncell - 1, false)));
+    }
+}
@@ -0,0 +1,221 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "fem2d.h"
+#include "laclib.h"
+#include "renumbering.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Checks that new_to_old and old_to_new are inverse permutations
+void check_permutation(const NodeRenumbering &renumbering, size_t number_of_nodes) {
+    CHECK(renumbering.new_to_old.size() == number_of_nodes);
+    CHECK(renumbering.old_to_new.size() == number_of_nodes);
+    auto sorted = renumbering.new_to_old;
+    sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < number_of_nodes; i++) {
+        CHECK(sorted[i] == i);
+        CHECK(renumbering.old_to_new[renumbering.new_to_old[i]] == i);
+    }
+}
+
+/// @brief Generates a structured mesh of nx × ny squares split into triangles with scrambled node numbers
+void scrambled_grid(vector<double> &coordinates, vector<size_t> &connectivity, size_t nx, size_t ny) {
+    size_t npoint = (nx + 1) * (ny + 1);
+    auto id = [&](size_t i, size_t j) { return ((j * (nx + 1) + i) * 7919) % npoint; }; // npoint must not divide 7919
+    coordinates.assign(2 * npoint, 0.0);
+    for (size_t j = 0; j <= ny; j++) {
+        for (size_t i = 0; i <= nx; i++) {
+            coordinates[id(i, j) * 2] = static_cast<double>(i);
+            coordinates[id(i, j) * 2 + 1] = static_cast<double>(j);
+        }
+    }
+    connectivity.clear();
+    for (size_t j = 0; j < ny; j++) {
+        for (size_t i = 0; i < nx; i++) {
+            connectivity.insert(connectivity.end(), {id(i, j), id(i + 1, j), id(i + 1, j + 1)});
+            connectivity.insert(connectivity.end(), {id(i + 1, j + 1), id(i, j + 1), id(i, j)});
+        }
+    }
+}
+
+/// @brief Returns the mean distance between the centroids of consecutive triangles
+double mean_centroid_jump(const vector<double> &coordinates, const vector<size_t> &connectivity) {
+    size_t ncell = connectivity.size() / 3;
+    double previous[2] = {0.0, 0.0};
+    double sum = 0.0;
+    for (size_t e = 0; e < ncell; e++) {
+        double centroid[2] = {0.0, 0.0};
+        for (size_t k = 0; k < 3; k++) {
+            centroid[0] += coordinates[connectivity[e * 3 + k] * 2] / 3.0;
+            centroid[1] += coordinates[connectivity[e * 3 + k] * 2 + 1] / 3.0;
+        }
+        if (e > 0) {
+            sum += hypot(centroid[0] - previous[0], centroid[1] - previous[1]);
+        }
+        previous[0] = centroid[0];
+        previous[1] = centroid[1];
+    }
+    return sum / static_cast<double>(ncell - 1);
+}
+
+TEST_CASE("space-filling curves") {
+    CHECK(morton_index(0, 0) == 0);
+    CHECK(morton_index(1, 0) == 1);
+    CHECK(morton_index(0, 1) == 2);
+    CHECK(morton_index(1, 1) == 3);
+    CHECK(morton_index(2, 0) == 4);
+    CHECK(morton_index(3, 3) == 15);
+
+    // the Hilbert curve visits all cells once and consecutive cells are neighbors
+    size_t bits = 3, n = 8;
+    vector<size_t> x_of(n * n, n), y_of(n * n, n);
+    for (uint32_t y = 0; y < n; y++) {
+        for (uint32_t x = 0; x < n; x++) {
+            auto d = hilbert_index(x, y, bits);
+            REQUIRE(d < n * n);
+            CHECK(x_of[d] == n); // not visited before
+            x_of[d] = x;
+            y_of[d] = y;
+        }
+    }
+    CHECK(x_of[0] == 0);
+    CHECK(y_of[0] == 0);
+    for (size_t d = 1; d < n * n; d++) {
+        auto dx = x_of[d] > x_of[d - 1] ? x_of[d] - x_of[d - 1] : x_of[d - 1] - x_of[d];
+        auto dy = y_of[d] > y_of[d - 1] ? y_of[d] - y_of[d - 1] : y_of[d - 1] - y_of[d];
+        CHECK(dx + dy == 1);
+    }
+}
+
+TEST_CASE("renumbering") {
+    // Bhatti's Example 1.6 (see z_test_solid2d.cpp)
+    auto coordinates = vector<double>{
+        0.0, 0.0,  // 0
+        0.0, 2.0,  // 1
+        2.0, 0.0,  // 2
+        2.0, 1.5,  // 3
+        4.0, 0.0,  // 4
+        4.0, 1.0}; // 5
+    auto connectivity = vector<size_t>{
+        0, 2, 3,  // 0
+        3, 1, 0,  // 1
+        2, 4, 5,  // 2
+        5, 3, 2}; // 3
+    auto param_young = vector<double>{10000.0, 10000.0, 10000.0, 10000.0};
+    auto param_poisson = vector<double>{0.2, 0.2, 0.2, 0.2};
+    auto param_cross_area = vector<double>{};
+    map<node_dof_pair_t, double> essential_bcs{
+        {{0, AlongX}, 0.0},
+        {{0, AlongY}, 0.0},
+        {{1, AlongX}, 0.0},
+        {{1, AlongY}, 0.0}};
+    map<node_dof_pair_t, double> natural_bcs{
+        {{1, AlongX}, -1.25},
+        {{1, AlongY}, -5.0},
+        {{3, AlongX}, -2.5},
+        {{3, AlongY}, -10.0},
+        {{5, AlongX}, -1.25},
+        {{5, AlongY}, -5.0}};
+    auto correct_uu = vector<double>{
+        0.000000000000000e+00, 0.000000000000000e+00,   // 0
+        0.000000000000000e+00, 0.000000000000000e+00,   // 1
+        -1.035527877607004e-02, -2.552969847657423e-02, // 2
+        4.727650463081949e-03, -2.473565538172127e-02,  // 3
+        -1.313941349422282e-02, -5.549310752960183e-02, // 4
+        8.389015766816341e-05, -5.556637423271112e-02}; // 5
+
+    SUBCASE("node graph") {
+        auto graph = NodeGraph::make_new(6, connectivity, 3);
+        CHECK(graph->number_of_nodes() == 6);
+        CHECK(vector<size_t>(graph->adjacency.begin() + graph->pointers[0],
+                             graph->adjacency.begin() + graph->pointers[1]) == vector<size_t>{1, 2, 3});
+        CHECK(vector<size_t>(graph->adjacency.begin() + graph->pointers[3],
+                             graph->adjacency.begin() + graph->pointers[4]) == vector<size_t>{0, 1, 2, 5});
+        CHECK(graph->degree(4) == 2);
+        CHECK(graph->bandwidth(vector<size_t>()) == 3);
+    }
+
+    SUBCASE("reverse Cuthill-McKee reduces the bandwidth") {
+        vector<double> grid_coordinates;
+        vector<size_t> grid_connectivity;
+        scrambled_grid(grid_coordinates, grid_connectivity, 30, 4);
+        auto renumbering = NodeRenumbering::make_new(RENUMBERING_RCM, grid_coordinates, grid_connectivity, 3);
+        check_permutation(*renumbering, 31 * 5);
+        CHECK(renumbering->bandwidth_before > 100);
+        CHECK(renumbering->bandwidth_after <= 6); // nodes are numbered across the short side
+    }
+
+    SUBCASE("nested dissection") {
+        vector<double> grid_coordinates;
+        vector<size_t> grid_connectivity;
+        scrambled_grid(grid_coordinates, grid_connectivity, 21, 10);
+        auto renumbering = NodeRenumbering::make_new(RENUMBERING_NESTED_DISSECTION,
+                                                     grid_coordinates, grid_connectivity, 3);
+        check_permutation(*renumbering, 22 * 11);
+
+        // the last nodes form the top-level separator (the column x = 10 between x ≤ 9 and x ≥ 11)
+        for (size_t k = 22 * 11 - 11; k < 22 * 11; k++) {
+            auto node = renumbering->new_to_old[k];
+            CHECK(grid_coordinates[node * 2] == 10.0);
+        }
+    }
+
+    SUBCASE("element ordering along space-filling curves") {
+        vector<double> grid_coordinates;
+        vector<size_t> grid_connectivity;
+        scrambled_grid(grid_coordinates, grid_connectivity, 16, 16);
+        auto ncell = grid_connectivity.size() / 3;
+        auto jump_before = mean_centroid_jump(grid_coordinates, grid_connectivity);
+        for (auto method : {ELEMENT_ORDERING_MORTON, ELEMENT_ORDERING_HILBERT}) {
+            auto ordering = ElementOrdering::make_new(method, grid_coordinates, grid_connectivity, 3);
+            auto sorted = ordering->new_to_old;
+            sort(sorted.begin(), sorted.end());
+            for (size_t e = 0; e < ncell; e++) {
+                CHECK(sorted[e] == e);
+            }
+            auto jump_after = mean_centroid_jump(grid_coordinates, ordering->to_new_connectivity(grid_connectivity));
+            CHECK(jump_after < 1.5);
+            CHECK(jump_after < jump_before); // the original order is also local (row by row) in this grid
+        }
+
+        auto ordering = ElementOrdering::make_new(ELEMENT_ORDERING_HILBERT, grid_coordinates, grid_connectivity, 3);
+        auto values = vector<double>(ncell);
+        for (size_t e = 0; e < ncell; e++) {
+            values[e] = static_cast<double>(e);
+        }
+        auto original = vector<double>{};
+        ordering->to_original_element_values(original, ordering->to_new_element_values(values));
+        CHECK(original == values);
+        CHECK(ordering->to_new_element_values(vector<double>{}).empty());
+    }
+
+    SUBCASE("results are mapped back to the original numbering") {
+        for (auto method : {RENUMBERING_NONE, RENUMBERING_RCM, RENUMBERING_NESTED_DISSECTION}) {
+            auto renumbering = NodeRenumbering::make_new(method, coordinates, connectivity, 3);
+            check_permutation(*renumbering, 6);
+            auto new_coordinates = renumbering->to_new_coordinates(coordinates);
+            auto new_connectivity = renumbering->to_new_connectivity(connectivity);
+            auto ordering = ElementOrdering::make_new(ELEMENT_ORDERING_HILBERT, new_coordinates, new_connectivity, 3);
+            auto fem = Fem2d::make_new(true, true, 0.25, true, false,
+                                       new_coordinates,
+                                       ordering->to_new_connectivity(new_connectivity),
+                                       ordering->to_new_element_values(param_young),
+                                       ordering->to_new_element_values(param_poisson),
+                                       param_cross_area,
+                                       renumbering->to_new_bcs(essential_bcs),
+                                       renumbering->to_new_bcs(natural_bcs));
+            fem->solve();
+            auto uu = vector<double>{};
+            renumbering->to_original_dofs(uu, fem->uu);
+            CHECK(equal_vectors_tol(uu, correct_uu, 1e-15));
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "constants.h"
+#include "sensitivity.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Returns the central finite-difference derivatives of a response with respect to each element parameter
+vector<double> finite_differences(Fem2d &fem,
+                                  vector<double> &params,
+                                  function<void(const vector<double> &)> set_params,
+                                  function<double()> response) {
+    vector<double> gradient(params.size());
+    for (size_t e = 0; e < params.size(); e++) {
+        double p = params[e];
+        double h = 1e-4 * p;
+        params[e] = p + h;
+        set_params(params);
+        fem.solve();
+        double r_plus = response();
+        params[e] = p - h;
+        set_params(params);
+        fem.solve();
+        double r_minus = response();
+        params[e] = p;
+        gradient[e] = (r_plus - r_minus) / (2.0 * h);
+    }
+    set_params(params);
+    fem.solve();
+    return gradient;
+}
+
+/// @brief Checks that two gradients agree relative to the largest entry
+void check_gradient(const vector<double> &gradient, const vector<double> &reference, double tolerance) {
+    double scale = 0.0;
+    for (auto value : reference) {
+        scale = fmax(scale, fabs(value));
+    }
+    REQUIRE(scale > 0.0);
+    REQUIRE(gradient.size() == reference.size());
+    for (size_t e = 0; e < gradient.size(); e++) {
+        CHECK(fabs(gradient[e] - reference[e]) < tolerance * scale);
+    }
+}
+
+TEST_CASE("sensitivity") {
+    SUBCASE("plane-strain (Smith's Example 5.2) with respect to Young's modulus") {
+        auto fem = Fem2d::make_new(true, false, 1.0, true, false,
+                                   vector<double>{0.0, 0.0, 0.5, 0.0, 1.0, 0.0, 0.0, -0.5, 0.5, -0.5,
+                                                  1.0, -0.5, 0.0, -1.0, 0.5, -1.0, 1.0, -1.0},
+                                   vector<size_t>{1, 0, 3, 3, 4, 1, 2, 1, 4, 4, 5, 2,
+                                                  4, 3, 6, 6, 7, 4, 5, 4, 7, 7, 8, 5},
+                                   vector<double>{1e6, 2e6, 3e6, 4e6, 5e6, 6e6, 7e6, 8e6},
+                                   vector<double>(8, 0.3),
+                                   vector<double>{},
+                                   map<node_dof_pair_t, double>{},
+                                   map<node_dof_pair_t, double>{});
+        auto left = vector<size_t>{0, 3, 6};
+        auto bottom = vector<size_t>{6, 7, 8};
+        fem->set_essential_bcs(left, AlongX, 0.0);
+        fem->set_essential_bcs(bottom, AlongY, 0.0);
+        fem->set_natural_bcs(vector<size_t>{0, 1, 2}, AlongY, -0.25);
+        fem->set_natural_bcs(vector<size_t>{2}, AlongX, 0.5);
+
+        // the gradients are not available before solving
+        vector<double> gradient;
+        CHECK_THROWS(calculate_compliance_sensitivity(*fem, SENSITIVITY_YOUNG, gradient));
+        fem->solve();
+        CHECK_THROWS(calculate_compliance_sensitivity(*fem, SENSITIVITY_CROSS_AREA, gradient));
+
+        auto young = fem->param_young;
+        auto set_young = [&](const vector<double> &values) { fem->set_param_young(values); };
+        auto compliance = [&]() {
+            double c = 0.0;
+            for (size_t i = 0; i < fem->total_ndof; i++) {
+                c += fem->natural_boundary_conditions[i] * fem->uu[i];
+            }
+            return c;
+        };
+        auto displacement = [&]() { return fem->uu[2 * 2]; }; // ux of node 2
+
+        // compliance (self-adjoint): no extra solve
+        size_t factorizations = fem->phase_counts.factorizations;
+        double c = calculate_compliance_sensitivity(*fem, SENSITIVITY_YOUNG, gradient);
+        CHECK(fem->phase_counts.factorizations == factorizations);
+        CHECK(fabs(c - compliance()) < 1e-20);
+        for (auto g : gradient) {
+            CHECK(g <= 0.0); // stiffer is better
+        }
+        check_gradient(gradient, finite_differences(*fem, young, set_young, compliance), 1e-7);
+
+        // displacement (one adjoint solve with the same factorization)
+        double ux = calculate_displacement_sensitivity(*fem, 2, AlongX, SENSITIVITY_YOUNG, gradient);
+        CHECK(ux == fem->uu[2 * 2]);
+        check_gradient(gradient, finite_differences(*fem, young, set_young, displacement), 1e-7);
+
+        // compliance with a settlement (not self-adjoint)
+        fem->update_essential_values(bottom, vector<LocalDOF>(3, AlongY), vector<double>(3, -1e-6));
+        fem->solve();
+        calculate_compliance_sensitivity(*fem, SENSITIVITY_YOUNG, gradient);
+        check_gradient(gradient, finite_differences(*fem, young, set_young, compliance), 1e-7);
+
+        // the displacement of a prescribed DOF does not change
+        calculate_displacement_sensitivity(*fem, 6, AlongY, SENSITIVITY_YOUNG, gradient);
+        for (auto g : gradient) {
+            CHECK(g == 0.0);
+        }
+    }
+
+    SUBCASE("truss (Felippa) with respect to the cross-sectional area") {
+        auto fem = Fem2d::make_new(false, false, 1.0, false, false,
+                                   vector<double>{0.0, 0.0, 10.0, 0.0, 10.0, 10.0},
+                                   vector<size_t>{0, 1, 1, 2, 2, 0},
+                                   vector<double>{100.0, 50.0, 200.0},
+                                   vector<double>{},
+                                   vector<double>{1.0, 1.0, SQRT_2},
+                                   map<node_dof_pair_t, double>{
+                                       {{0, AlongX}, 0.0},
+                                       {{0, AlongY}, 0.0},
+                                       {{1, AlongY}, 0.0}},
+                                   map<node_dof_pair_t, double>{{{2, AlongX}, 2.0}, {{2, AlongY}, 1.0}});
+        fem->solve();
+        auto area = fem->param_cross_area;
+        auto set_area = [&](const vector<double> &values) { fem->set_param_cross_area(values); };
+        auto uy = [&]() { return fem->uu[2 * 2 + 1]; };
+
+        vector<double> gradient;
+        calculate_displacement_sensitivity(*fem, 2, AlongY, SENSITIVITY_CROSS_AREA, gradient);
+        check_gradient(gradient, finite_differences(*fem, area, set_area, uy), 1e-7);
+
+        // compliance: dC/dAₑ = -Nₑ² Lₑ / (Eₑ Aₑ²), with the axial forces N = (0, -1, 2√2) (Felippa)
+        double c = calculate_compliance_sensitivity(*fem, SENSITIVITY_CROSS_AREA, gradient);
+        CHECK(fabs(c - (2.0 * 0.4 + 1.0 * -0.2)) < 1e-14);
+        CHECK(fabs(gradient[0]) < 1e-14);
+        CHECK(fabs(gradient[1] - (-1.0 * 10.0 / 50.0)) < 1e-14);
+        CHECK(fabs(gradient[2] - (-8.0 * 10.0 * SQRT_2 / (200.0 * 2.0))) < 1e-14);
+    }
+}
@@ -1,5 +1,6 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include <cmath>
 #include <map>
 #include <vector>
 
@@ -382,5 +383,140 @@ TEST_CASE("solid2d") {
             1.950000000000004e-07, 0.000000000000000e+00,  // 7
             3.900000000000004e-07, 0.000000000000000e+00}; // 8
         CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+
+        // uniform stress σyy = -1: the bottom supports carry the load; the left ones carry nothing
+        vector<double> reactions;
+        fem->calculate_reactions(reactions);
+        auto correct_reactions = vector<double>(18, 0.0);
+        correct_reactions[6 * 2 + 1] = 0.25;
+        correct_reactions[7 * 2 + 1] = 0.5;
+        correct_reactions[8 * 2 + 1] = 0.25;
+        CHECK(equal_vectors_tol(reactions, correct_reactions, 1e-12));
+        auto resultants = fem->check_equilibrium(reactions);
+        CHECK(resultants.relative_error < 1e-12);
+        CHECK(fabs(resultants.moment) < 1e-12);
+    }
+
+    SUBCASE("boundary conditions given as flat arrays") {
+        // same as Smith's Example 5.2 above
+        auto coordinates = vector<double>{
+            0.0, 0.0,   // 0
+            0.5, 0.0,   // 1
+            1.0, 0.0,   // 2
+            0.0, -0.5,  // 3
+            0.5, -0.5,  // 4
+            1.0, -0.5,  // 5
+            0.0, -1.0,  // 6
+            0.5, -1.0,  // 7
+            1.0, -1.0}; // 8
+        auto connectivity = vector<size_t>{
+            1, 0, 3,  // 0
+            3, 4, 1,  // 1
+            2, 1, 4,  // 2
+            4, 5, 2,  // 3
+            4, 3, 6,  // 4
+            6, 7, 4,  // 5
+            5, 4, 7,  // 6
+            7, 8, 5}; // 7
+        auto fem = Fem2d::make_new(true, false, 1.0, false, false,
+                                   coordinates,
+                                   connectivity,
+                                   vector<double>(8, 1e6),
+                                   vector<double>(8, 0.3),
+                                   vector<double>{},
+                                   map<node_dof_pair_t, double>{},
+                                   map<node_dof_pair_t, double>{});
+        auto left = vector<size_t>{0, 3, 6};
+        auto bottom = vector<size_t>{6, 7, 8};
+        fem->set_essential_bcs(left, AlongX, 0.0);
+        fem->set_essential_bcs(bottom, AlongY, 0.0);
+        fem->set_natural_bcs(vector<size_t>{0, 1, 2},
+                             vector<LocalDOF>{AlongY, AlongY, AlongY},
+                             vector<double>{-0.25, -0.5, -0.25});
+
+        // bit i of the mask is set if local DOF i of the element is prescribed
+        vector<uint8_t> masks;
+        fem->calculate_element_constraint_masks(masks);
+        CHECK(masks == vector<uint8_t>{20, 1, 0, 0, 52, 11, 32, 10});
+
+        fem->solve();
+        auto correct_uu = vector<double>{
+            0.000000000000000e+00, -9.100000000000005e-07, // 0
+            1.950000000000001e-07, -9.100000000000006e-07, // 1
+            3.900000000000002e-07, -9.100000000000000e-07, // 2
+            0.000000000000000e+00, -4.550000000000002e-07, // 3
+            1.950000000000002e-07, -4.550000000000004e-07, // 4
+            3.900000000000004e-07, -4.549999999999999e-07, // 5
+            0.000000000000000e+00, 0.000000000000000e+00,  // 6
+            1.950000000000004e-07, 0.000000000000000e+00,  // 7
+            3.900000000000004e-07, 0.000000000000000e+00}; // 8
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+
+        // rigid-body settlement of the bottom edge: the same deformation shifted down
+        fem->update_essential_values(bottom, vector<LocalDOF>(3, AlongY), vector<double>(3, -1e-6));
+        fem->solve();
+        for (size_t i = 0; i < 9; i++) {
+            correct_uu[i * 2 + 1] -= 1e-6;
+        }
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+
+        // only the right-hand side is recomputed after updating the values
+        CHECK(fem->phase_counts.solves == 2);
+        CHECK(fem->phase_counts.stiffness_updates == 1);
+        CHECK(fem->phase_counts.factorizations == 1);
+        CHECK(fem->phase_counts.rhs_updates == 2);
+        fem->solve(); // nothing dirty
+        CHECK(fem->phase_counts.rhs_updates == 2);
+        CHECK(fem->phase_counts.factorizations == 1);
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+
+        // doubling Young's modulus halves the deformation (but not the settlement)
+        fem->set_param_young(vector<double>(8, 2e6));
+        CHECK(fem->kk_csr.get() == NULL);
+        fem->solve();
+        CHECK(fem->phase_counts.stiffness_updates == 2);
+        CHECK(fem->phase_counts.factorizations == 2);
+        for (size_t i = 0; i < 9; i++) {
+            correct_uu[i * 2] /= 2.0;
+            correct_uu[i * 2 + 1] = (correct_uu[i * 2 + 1] + 1e-6) / 2.0 - 1e-6;
+        }
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-15));
+
+        // a new solver is factorized without assembling the stiffness again
+        fem->set_linear_solver(SOLVER_PCG, *LinearSolverOptions::make_new());
+        fem->solve();
+        CHECK(fem->phase_counts.stiffness_updates == 2);
+        CHECK(fem->phase_counts.factorizations == 3);
+        CHECK(equal_vectors_tol(fem->uu, correct_uu, 1e-12));
+
+        // stretching the mesh along x gives the same result as a new problem
+        auto stretched = coordinates;
+        for (size_t p = 0; p < 9; p++) {
+            stretched[p * 2] *= 2.0;
+        }
+        fem->enable_element_matrix_store(1 << 20);
+        fem->calculate_element_matrices();
+        fem->set_coordinates(stretched);
+        CHECK(fem->element_matrices->ready == false);
+        fem->solve();
+        auto reference = Fem2d::make_new(true, false, 1.0, false, false,
+                                         stretched,
+                                         connectivity,
+                                         vector<double>(8, 2e6),
+                                         vector<double>(8, 0.3),
+                                         vector<double>{},
+                                         map<node_dof_pair_t, double>{},
+                                         map<node_dof_pair_t, double>{});
+        reference->set_essential_bcs(left, AlongX, 0.0);
+        reference->set_essential_bcs(bottom, AlongY, -1e-6);
+        reference->set_natural_bcs(vector<size_t>{0, 1, 2}, AlongY, -0.25);
+        reference->set_natural_bcs(vector<size_t>{1}, AlongY, -0.5);
+        reference->solve();
+        CHECK(equal_vectors_tol(fem->uu, reference->uu, 1e-12));
+
+        // validation
+        CHECK_THROWS(fem->set_essential_bcs(vector<size_t>{9}, AlongX, 0.0));
+        CHECK_THROWS(fem->set_natural_bcs(vector<size_t>{0, 1}, vector<LocalDOF>{AlongX}, vector<double>{1.0, 2.0}));
+        CHECK_THROWS(fem->update_essential_values(vector<size_t>{1}, vector<LocalDOF>{AlongX}, vector<double>{1.0}));
     }
 }
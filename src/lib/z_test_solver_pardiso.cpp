@@ -0,0 +1,138 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "csr_upper.h"
+#include "fem2d.h"
+#include "laclib.h"
+#include "solver_mixed_precision.h"
+#include "solver_pardiso.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("solver_pardiso") {
+    // Bhatti's Example 1.6 (see z_test_solid2d.cpp)
+    auto coordinates = vector<double>{
+        0.0, 0.0,  // 0
+        0.0, 2.0,  // 1
+        2.0, 0.0,  // 2
+        2.0, 1.5,  // 3
+        4.0, 0.0,  // 4
+        4.0, 1.0}; // 5
+    auto connectivity = vector<size_t>{
+        0, 2, 3,  // 0
+        3, 1, 0,  // 1
+        2, 4, 5,  // 2
+        5, 3, 2}; // 3
+    auto param_young = vector<double>{10000.0, 10000.0, 10000.0, 10000.0};
+    auto param_poisson = vector<double>{0.2, 0.2, 0.2, 0.2};
+    auto param_cross_area = vector<double>{};
+    map<node_dof_pair_t, double> essential_bcs{
+        {{0, AlongX}, 0.0},
+        {{0, AlongY}, 0.0},
+        {{1, AlongX}, 0.0},
+        {{1, AlongY}, 0.0}};
+    map<node_dof_pair_t, double> natural_bcs{
+        {{1, AlongX}, -1.25},
+        {{1, AlongY}, -5.0},
+        {{3, AlongX}, -2.5},
+        {{3, AlongY}, -10.0},
+        {{5, AlongX}, -1.25},
+        {{5, AlongY}, -5.0}};
+    auto correct_uu = vector<double>{
+        0.000000000000000e+00, 0.000000000000000e+00,   // 0
+        0.000000000000000e+00, 0.000000000000000e+00,   // 1
+        -1.035527877607004e-02, -2.552969847657423e-02, // 2
+        4.727650463081949e-03, -2.473565538172127e-02,  // 3
+        -1.313941349422282e-02, -5.549310752960183e-02, // 4
+        8.389015766816341e-05, -5.556637423271112e-02}; // 5
+
+    auto fem = Fem2d::make_new(true, true, 0.25, true, false,
+                               coordinates,
+                               connectivity,
+                               param_young,
+                               param_poisson,
+                               param_cross_area,
+                               essential_bcs,
+                               natural_bcs);
+
+    SUBCASE("CsrUpper equals the assembled COO matrix") {
+        fem->calculate_rhs_and_global_stiffness();
+        auto kk = fem->kk_coo->as_matrix();
+        auto csr = CsrUpper::make_from_fem(*fem);
+        CHECK(csr->dim == 12);
+        auto dense = Matrix::make_new(12, 12);
+        for (size_t i = 0; i < 12; i++) {
+            for (MKL_INT p = csr->row_pointers[i]; p < csr->row_pointers[i + 1]; p++) {
+                CHECK(static_cast<size_t>(csr->column_indices[p]) >= i);
+                dense->set(i, csr->column_indices[p], csr->values[p]);
+            }
+        }
+        CHECK(equal_vectors_tol(dense->data, kk->data, 1e-12));
+        CHECK(csr->bandwidth() == 7); // e.g., DOF 4 (node 2) couples with DOF 11 (node 5)
+    }
+
+    SUBCASE("PARDISO in double precision") {
+        fem->calculate_rhs();
+        auto csr = CsrUpper::make_from_fem(*fem);
+        auto options = PardisoOptions::make_new();
+        auto solver = SolverPardiso::make_new(*options);
+        solver->factorize(*csr);
+        auto uu = vector<double>{};
+        solver->solve(uu, fem->rhs);
+        CHECK(equal_vectors_tol(uu, correct_uu, 1e-15));
+    }
+
+    SUBCASE("PARDISO out-of-core") {
+        fem->calculate_rhs();
+        auto csr = CsrUpper::make_from_fem(*fem);
+        auto options = PardisoOptions::make_new();
+        options->memory_mode = PARDISO_OUT_OF_CORE;
+        options->ooc_path = "/tmp/fem2d_pardiso_ooc";
+        options->ooc_max_core_size_mb = 64;
+        set_pardiso_out_of_core_environment(*options); // once per process (before the solvers)
+        auto solver = SolverPardiso::make_new(*options);
+        solver->factorize(*csr);
+        CHECK(string(getenv("MKL_PARDISO_OOC_PATH")) == "/tmp/fem2d_pardiso_ooc");
+        CHECK(string(getenv("MKL_PARDISO_OOC_MAX_CORE_SIZE")) == "64");
+        CHECK(solver->iparm[59] == 2);
+        CHECK(solver->used_out_of_core() == true);
+        auto uu = vector<double>{};
+        solver->solve(uu, fem->rhs);
+        CHECK(equal_vectors_tol(uu, correct_uu, 1e-15));
+        CHECK(solver->timing_factorize.wall_seconds >= 0.0);
+        CHECK(solver->timing_factorize.num_threads >= 1);
+        CHECK(solver->timing_solve.estimated_idle_seconds() >= 0.0);
+    }
+
+    SUBCASE("mixed precision with iterative refinement") {
+        fem->calculate_rhs();
+        auto csr = CsrUpper::make_from_fem(*fem);
+        auto options = PardisoOptions::make_new();
+        auto solver = SolverMixedPrecision::make_new(*options, 1e-14, 10);
+        solver->factorize(*csr);
+        auto uu = vector<double>{};
+        solver->solve(uu, fem->rhs);
+        CHECK(solver->used_fallback == false);
+        CHECK(solver->relative_residual <= 1e-14);
+        CHECK(equal_vectors_tol(uu, correct_uu, 1e-15));
+    }
+
+    SUBCASE("mixed precision falls back to double precision") {
+        fem->calculate_rhs();
+        auto csr = CsrUpper::make_from_fem(*fem);
+        auto options = PardisoOptions::make_new();
+        auto solver = SolverMixedPrecision::make_new(*options, 1e-300, 0); // impossible tolerance
+        solver->factorize(*csr);
+        auto uu = vector<double>{};
+        solver->solve(uu, fem->rhs);
+        CHECK(solver->used_fallback == true);
+        CHECK(equal_vectors_tol(uu, correct_uu, 1e-15));
+    }
+}
@@ -0,0 +1,113 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "spatial_index.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+/// @brief Returns the nodes satisfying the predicate by scanning all nodes
+template <typename Predicate>
+vector<size_t> brute_force(const vector<double> &coordinates, const Predicate &predicate) {
+    vector<size_t> result;
+    for (size_t n = 0; n < coordinates.size() / 2; n++) {
+        if (predicate(coordinates[n * 2], coordinates[n * 2 + 1])) {
+            result.push_back(n);
+        }
+    }
+    return result;
+}
+
+TEST_CASE("spatial_index") {
+    // quarter ring with a = 3 and b = 6 (nodes on 21 rings × 41 rays)
+    size_t nr = 21, nt = 41;
+    vector<double> coordinates;
+    for (size_t j = 0; j < nt; j++) {
+        for (size_t i = 0; i < nr; i++) {
+            double r = 3.0 + 3.0 * i / (nr - 1);
+            double t = (M_PI / 2.0) * j / (nt - 1);
+            coordinates.push_back(r * cos(t));
+            coordinates.push_back(r * sin(t));
+        }
+    }
+    auto index = SpatialIndex::make_new(coordinates);
+    CHECK(index->cell_nodes.size() == nr * nt);
+    CHECK(index->cell_pointers.back() == nr * nt);
+
+    SUBCASE("box") {
+        auto nodes = index->nodes_in_box(-1e-10, 0.0, 1e-10, 10.0); // left edge
+        CHECK(nodes.size() == nr);
+        CHECK(nodes == brute_force(coordinates, [](double x, double y) { return fabs(x) <= 1e-10; }));
+        auto inner = index->nodes_in_box(1.0, 1.0, 4.0, 4.0);
+        CHECK(inner == brute_force(coordinates, [](double x, double y) {
+                  return x >= 1.0 && x <= 4.0 && y >= 1.0 && y <= 4.0;
+              }));
+    }
+
+    SUBCASE("segment") {
+        auto bottom = index->nodes_on_segment(0.0, 0.0, 10.0, 0.0, 1e-10);
+        CHECK(bottom.size() == nr);
+        CHECK(bottom == brute_force(coordinates, [](double x, double y) { return fabs(y) <= 1e-10; }));
+
+        // the ray at 45°
+        auto diagonal = index->nodes_on_segment(0.0, 0.0, 10.0, 10.0, 1e-8);
+        CHECK(diagonal.size() == nr);
+        CHECK(diagonal == brute_force(coordinates, [](double x, double y) { return fabs(x - y) <= 1e-8; }));
+    }
+
+    SUBCASE("thin strip") {
+        // rod along x with round-off noise in y: the number of cells must not blow up
+        size_t npoint = 1001;
+        vector<double> strip(npoint * 2);
+        for (size_t n = 0; n < npoint; n++) {
+            strip[n * 2] = static_cast<double>(n);
+            strip[n * 2 + 1] = n % 2 == 0 ? 1e-12 : -1e-12;
+        }
+        auto thin = SpatialIndex::make_new(strip);
+        CHECK(thin->ncol * thin->nrow <= 3 * npoint);
+        auto nodes = thin->nodes_on_segment(0.0, 0.0, 1000.0, 0.0, 1e-10);
+        CHECK(nodes.size() == npoint);
+        CHECK(thin->nearest_node(500.2, 0.0) == 500);
+    }
+
+    SUBCASE("circle") {
+        auto inner = index->nodes_on_circle(0.0, 0.0, 3.0, 1e-10);
+        CHECK(inner.size() == nt);
+        CHECK(inner == brute_force(coordinates, [](double x, double y) { return fabs(hypot(x, y) - 3.0) <= 1e-10; }));
+        auto disk = index->nodes_in_circle(3.0, 3.0, 1.5);
+        CHECK(disk == brute_force(coordinates, [](double x, double y) { return hypot(x - 3.0, y - 3.0) <= 1.5; }));
+    }
+
+    SUBCASE("nearest nodes") {
+        auto points = vector<double>{0.0, 0.0, 6.0, 0.0, 0.0, 6.01, 2.5, 2.5, 100.0, -100.0, 4.2, 3.1};
+        auto nearest = index->nearest_nodes(points);
+        for (size_t i = 0; i < points.size() / 2; i++) {
+            size_t best = 0;
+            double best_distance = INFINITY;
+            for (size_t n = 0; n < nr * nt; n++) {
+                double d = hypot(coordinates[n * 2] - points[i * 2], coordinates[n * 2 + 1] - points[i * 2 + 1]);
+                if (d < best_distance) {
+                    best = n;
+                    best_distance = d;
+                }
+            }
+            CHECK(nearest[i] == best);
+        }
+        CHECK(nearest[1] == nr - 1);
+        CHECK(nearest[2] == nr * nt - 1);
+    }
+
+    SUBCASE("boundary conditions from node sets") {
+        map<node_dof_pair_t, double> essential_bcs;
+        insert_bcs(essential_bcs, index->nodes_in_box(-1e-10, 0.0, 1e-10, 10.0), AlongX, 0.0);
+        insert_bcs(essential_bcs, index->nodes_on_segment(0.0, 0.0, 10.0, 0.0, 1e-10), AlongY, 0.0);
+        CHECK(essential_bcs.size() == 2 * nr);
+        CHECK(essential_bcs.count({0, AlongY}) == 1);
+        CHECK(essential_bcs.count({0, AlongX}) == 0);
+    }
+}
@@ -0,0 +1,112 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../util/doctest.h"
+#include "generate_mesh.h"
+#include "spatial_index.h"
+#include "topology_optimization.h"
+
+using namespace std;
+
+#define _SUBCASE(name) if (false)
+
+TEST_CASE("topology_optimization") {
+    // cantilever [0, 2] × [0, 1] clamped at x = 0 and loaded at the middle of x = 2
+    auto mesh = generate_rectangle(0.0, 0.0, 2.0, 1.0, 24, 12);
+    size_t ncell = mesh->connectivity.size() / 3;
+    auto fem = Fem2d::make_new(true, true, 1.0, true, false,
+                               mesh->coordinates,
+                               mesh->connectivity,
+                               vector<double>(ncell, 1.0),
+                               vector<double>(ncell, 0.3),
+                               vector<double>{},
+                               map<node_dof_pair_t, double>{},
+                               map<node_dof_pair_t, double>{});
+    auto index = SpatialIndex::make_new(mesh->coordinates);
+    auto left = index->nodes_on_segment(0.0, 0.0, 0.0, 1.0, 1e-11);
+    fem->set_essential_bcs(left, AlongX, 0.0);
+    fem->set_essential_bcs(left, AlongY, 0.0);
+    fem->set_natural_bcs(vector<size_t>{index->nearest_node(2.0, 0.5)}, AlongY, -1.0);
+
+    SUBCASE("density filter") {
+        auto filter = DensityFilter::make_new(mesh->coordinates, mesh->connectivity, mesh->get_topology(), 0.25);
+        CHECK(filter->pointers[ncell] > 10 * ncell); // the neighborhoods go beyond the adjacent elements
+
+        // constant fields are preserved
+        vector<double> filtered;
+        filter->apply(filtered, vector<double>(ncell, 0.7));
+        for (auto value : filtered) {
+            CHECK(fabs(value - 0.7) < 1e-14);
+        }
+
+        // yᵀ ⋅ (W ⋅ x) = (Wᵀ ⋅ y)ᵀ ⋅ x
+        mt19937_64 generator(7);
+        uniform_real_distribution<double> distribution(0.0, 1.0);
+        vector<double> x(ncell), y(ncell), wty;
+        for (size_t e = 0; e < ncell; e++) {
+            x[e] = distribution(generator);
+            y[e] = distribution(generator);
+        }
+        filter->apply(filtered, x);
+        filter->apply_transpose(wty, y);
+        double left = 0.0, right = 0.0;
+        for (size_t e = 0; e < ncell; e++) {
+            left += y[e] * filtered[e];
+            right += wty[e] * x[e];
+        }
+        CHECK(fabs(left - right) < 1e-12 * fabs(left));
+
+        // no radius gives the identity
+        auto identity = DensityFilter::make_new(mesh->coordinates, mesh->connectivity, mesh->get_topology(), 0.0);
+        identity->apply(filtered, x);
+        CHECK(filtered == x);
+    }
+
+    SUBCASE("cantilever") {
+        auto options = TopologyOptions::make_new();
+        options->volume_fraction = 0.4;
+        options->filter_radius = 0.15;
+        options->max_iterations = 40;
+        auto optimization = TopologyOptimization::make_new(*fem, mesh->get_topology(), *options);
+        const auto &history = optimization->history;
+        REQUIRE(history.size() > 10);
+
+        // the grey initial design is much more compliant than the optimized one
+        CHECK(history.back().compliance < 0.5 * history.front().compliance);
+        for (const auto &iteration : history) {
+            CHECK(fabs(iteration.volume_fraction - 0.4) < 1e-6);
+        }
+        for (size_t e = 0; e < ncell; e++) {
+            CHECK(optimization->densities[e] >= 0.0);
+            CHECK(optimization->densities[e] <= 1.0);
+        }
+
+        // the problem holds the moduli of the final design
+        fem->solve();
+        double compliance = 0.0;
+        for (size_t i = 0; i < fem->total_ndof; i++) {
+            compliance += fem->natural_boundary_conditions[i] * fem->uu[i];
+        }
+        CHECK(compliance < 0.5 * history.front().compliance);
+        for (size_t e = 0; e < ncell; e++) {
+            CHECK(fem->param_young[e] >= 1e-9);
+            CHECK(fem->param_young[e] <= 1.0 + 1e-12);
+        }
+    }
+
+    SUBCASE("errors") {
+        auto options = TopologyOptions::make_new();
+        options->volume_fraction = 0.0;
+        CHECK_THROWS(TopologyOptimization::make_new(*fem, mesh->get_topology(), *options));
+        options->volume_fraction = 0.5;
+        options->penalty = 0.5;
+        CHECK_THROWS(TopologyOptimization::make_new(*fem, mesh->get_topology(), *options));
+        options->penalty = 3.0;
+        fem->update_essential_values(vector<size_t>{0}, vector<LocalDOF>{AlongX}, vector<double>{1e-3});
+        CHECK_THROWS(TopologyOptimization::make_new(*fem, mesh->get_topology(), *options));
+    }
+}
@@ -1,5 +1,6 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include <cmath>
 #include <map>
 #include <vector>
 
@@ -213,6 +214,17 @@ TEST_CASE("truss2d") {
             auto correct_rhs = vector<double>{0.0, -0.5, 0.0, 0.4, -3.0, -2.0}; // Felippa I-FEM page 3-13
             CHECK(equal_vectors_tol(truss->uu, correct_uu, 1e-15));
             CHECK(equal_vectors_tol(truss->rhs, correct_rhs, 1e-15));
+
+            // check reactions (correct_ff at the prescribed DOFs)
+            vector<double> reactions;
+            truss->calculate_reactions(reactions);
+            auto correct_reactions = vector<double>{-2.0, -2.0, 0.0, 1.0, 0.0, 0.0};
+            CHECK(equal_vectors_tol(reactions, correct_reactions, 1e-14));
+            auto resultants = truss->check_equilibrium(reactions);
+            CHECK(fabs(resultants.force_x) < 1e-14);
+            CHECK(fabs(resultants.force_y) < 1e-14);
+            CHECK(fabs(resultants.moment) < 1e-13);
+            CHECK(resultants.relative_error < 1e-15);
         }
     }
 
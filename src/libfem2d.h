@@ -1,3 +1,28 @@
+#include "lib/adaptive_refinement.h"
+#include "lib/batch_runner.h"
+#include "lib/boundary.h"
+#include "lib/conjugate_gradient.h"
 #include "lib/constants.h"
+#include "lib/csr_upper.h"
+#include "lib/element_matrix_store.h"
+#include "lib/element_results.h"
+#include "lib/element_stiffness.h"
+#include "lib/error_estimator.h"
 #include "lib/fem2d.h"
+#include "lib/generate_mesh.h"
+#include "lib/linear_solver.h"
+#include "lib/matrix_free.h"
+#include "lib/mesh_topology.h"
+#include "lib/monte_carlo.h"
+#include "lib/nodal_recovery.h"
+#include "lib/parametric_assembly.h"
+#include "lib/partitioning.h"
 #include "lib/read_mesh.h"
+#include "lib/reduced_order_model.h"
+#include "lib/refinement.h"
+#include "lib/renumbering.h"
+#include "lib/sensitivity.h"
+#include "lib/solver_mixed_precision.h"
+#include "lib/solver_pardiso.h"
+#include "lib/spatial_index.h"
+#include "lib/topology_optimization.h"